@@ -0,0 +1,511 @@
+/**
+ * Logger which writes the messages on a background thread.
+ *
+ * Test threads only copy the message into a ring buffer and return, the background
+ * thread collects the messages and writes them with a few large writes. It can be used
+ * by any number of threads at the same time without any lock. Failed assertions are 
+ * queued as they are and formatted by the background thread.
+ *
+ * Usage Example
+ *
+    int main(int argc, char* argv[])
+    {
+        AsyncLogger logger;
+        return TestManager::ExecuteAllSuites(&logger);
+    }
+ *
+ */
+#pragma once
+
+#include "suite.h"
+
+namespace esintiler
+{
+
+class AsyncLogger : public Logger
+{
+public:
+    /**
+     * What to do with a message when the ring buffer is full
+     */
+    enum OverflowPolicy
+    {
+        Block,  //wait until the background thread makes space, nothing is lost
+        Drop    //drop the message, number of dropped messages is logged later
+    };
+
+    /**
+     * @iFile: file descriptor to write to, stdout by default
+     * @iCapacity: size of the ring buffer in bytes, messages longer than half of it are
+     * truncated
+     */
+    AsyncLogger(int iFile = 1, size_t iCapacity = 1 << 20, OverflowPolicy iPolicy = Block)
+        : m_file(iFile)
+        , m_policy(iPolicy)
+        , m_writePos(0)
+        , m_readPos(0)
+        , m_sleeping(0)
+        , m_stop(0)
+        , m_crashed(0)
+        , m_dropped(0)
+        , m_process(platform::ProcessId())
+    {
+        size_t numCells = 64;
+        while(numCells * CellSize < iCapacity)
+            numCells *= 2;
+        m_mask = (long)numCells - 1;
+        m_cells = new Cell[numCells];
+        for(size_t i = 0; i < numCells; i++)
+            m_cells[i].sequence = (long)i;
+        m_batch.reserve(BatchSize);
+
+        Register(this);
+        m_thread.logger = this;
+        m_thread.Start();
+    }
+
+    /**
+     * Writes all the remaining messages
+     */
+    ~AsyncLogger()
+    {
+        Unregister(this);
+        platform::AtomicStore(&m_stop, 1);
+        m_wakeUp.Set();
+        m_thread.Join();
+        delete [] m_cells;
+    }
+
+    using Logger::log;
+
+    void log(const char *ipMsg)
+    {
+        Push(0, 0, ipMsg, strlen(ipMsg), false);
+    }
+
+    /**
+     * Queues the failure without formatting it. Statement and file are literals so only
+     * their addresses are queued, message is copied.
+     */
+    void failure(const FailureRecord &iFailure)
+    {
+        FailureHeader header = { iFailure.statement, iFailure.file, iFailure.line, 
+            iFailure.message != 0 };
+        size_t size = iFailure.message ? strlen(iFailure.message) : 0;
+        if(size > MaxMessage)
+            size = MaxMessage;
+        Push((const char*)&header, sizeof(header), iFailure.message, size, true);
+    }
+
+    /**
+     * Returns once all the messages logged before the call are written
+     */
+    void Flush()
+    {
+        long target = platform::AtomicLoad(&m_writePos);
+        while(platform::AtomicLoad(&m_readPos) - target < 0 && !platform::AtomicLoad(&m_crashed))
+        {
+            Wake();
+            platform::Sleep(0.0005);
+        }
+    }
+
+    /**
+     * Number of messages dropped since the last report
+     */
+    long Dropped() const
+    {
+        return platform::AtomicLoad(&m_dropped);
+    }
+
+private:
+    enum
+    {
+        CellSize = 64,
+        DataSize = CellSize - sizeof(long),
+        BatchSize = 64 * 1024,
+        MaxMessage = 1024   //longer messages of the failures are truncated
+    };
+
+    /**
+     * Size of a queued failure has this bit set
+     */
+    static const unsigned int FailureBit = 0x80000000u;
+
+    /**
+     * A message takes one or more consecutive cells. Its first cell starts with the
+     * size of the message. Sequence tells the state of the cell for position p: it is p
+     * when the cell is free, p + 1 when it is filled.
+     */
+    struct Cell
+    {
+        volatile long   sequence;
+        char            data[DataSize];
+    };
+
+    /**
+     * Start of a queued failure, it is followed by the message
+     */
+    struct FailureHeader
+    {
+        const char *statement;
+        const char *file;
+        int         line;
+        int         hasMessage;
+    };
+
+    static long NumCells(size_t iSize)
+    {
+        return (long)((sizeof(unsigned int) + iSize + DataSize - 1) / DataSize);
+    }
+
+    Cell& At(long iPos)
+    {
+        return m_cells[iPos & m_mask];
+    }
+
+    /**
+     * Claims the cells for the message, copies it and publishes them. A message is followed 
+     * by a new line, a failure is its header followed by its message.
+     */
+    void Push(const char *ipHeader, size_t iHeaderSize, const char *ipMsg, size_t iSize, 
+        bool iFailure)
+    {
+        //message and its new line should fit half of the buffer
+        size_t limit = (size_t)(m_mask + 1) / 2 * DataSize - sizeof(unsigned int) - 1;
+        if(iSize > limit)
+            iSize = limit;
+        size_t total = iHeaderSize + iSize + (iFailure ? 0 : 1);
+        long numCells = NumCells(total);
+
+        long pos = 0;
+        for(;;)
+        {
+            pos = platform::AtomicLoad(&m_writePos);
+            long last = pos + numCells - 1;
+            long diff = platform::AtomicLoad(&At(last).sequence) - last;
+            if(diff == 0)
+            {
+                if(platform::AtomicCompareExchange(&m_writePos, pos, pos + numCells))
+                    break;
+            }
+            else if(diff < 0)
+            {
+                //full, previous lap is not written yet
+                if(m_policy == Drop || platform::AtomicLoad(&m_crashed))
+                {
+                    platform::AtomicAdd(&m_dropped, 1);
+                    return;
+                }
+                Wake();
+                platform::Sleep(0.0001);
+            }
+        }
+
+        unsigned int size = (unsigned int)total | (iFailure ? FailureBit : 0);
+        char header[sizeof(unsigned int)];
+        memcpy(header, &size, sizeof(size));
+        const char *pParts[4] = { header, ipHeader, ipMsg, "\n" };
+        size_t sizes[4] = { sizeof(header), iHeaderSize, iSize, (size_t)(iFailure ? 0 : 1) };
+        long cell = 0;
+        size_t offset = 0;
+        for(int part = 0; part < 4; part++)
+        {
+            const char *pData = pParts[part];
+            size_t remaining = sizes[part];
+            while(remaining > 0)
+            {
+                size_t n = DataSize - offset < remaining ? DataSize - offset : remaining;
+                memcpy(At(pos + cell).data + offset, pData, n);
+                pData += n;
+                remaining -= n;
+                offset += n;
+                if(offset == DataSize)
+                {
+                    cell ++;
+                    offset = 0;
+                }
+            }
+        }
+        for(long i = 0; i < numCells; i++)
+            platform::AtomicStore(&At(pos + i).sequence, pos + i + 1);
+
+        if(platform::AtomicExchange(&m_sleeping, 0))
+            m_wakeUp.Set();
+    }
+
+    void Wake()
+    {
+        platform::AtomicExchange(&m_sleeping, 0);
+        m_wakeUp.Set();
+    }
+
+    /**
+     * Size and the number of cells of the complete message at the given position, false 
+     * if it is not filled yet
+     */
+    bool Complete(long iPos, unsigned int &oSize, long &oNumCells)
+    {
+        if(platform::AtomicLoad(&At(iPos).sequence) != iPos + 1)
+            return false;
+        memcpy(&oSize, At(iPos).data, sizeof(oSize));
+        oNumCells = NumCells(oSize & ~FailureBit);
+        return platform::AtomicLoad(&At(iPos + oNumCells - 1).sequence) == iPos + oNumCells;
+    }
+
+    /**
+     * Copies iSize bytes of the message at the given position
+     */
+    void Read(long iPos, size_t iSize, char *opData)
+    {
+        size_t offset = sizeof(unsigned int);
+        for(long i = 0; iSize > 0; i++)
+        {
+            size_t n = DataSize - offset < iSize ? DataSize - offset : iSize;
+            memcpy(opData, At(iPos + i).data + offset, n);
+            opData += n;
+            iSize -= n;
+            offset = 0;
+        }
+    }
+
+    /**
+     * Writes the "#" lines of the failure at the given position, same as Logger::failure
+     */
+    int FormatFailure(long iPos, unsigned int iSize, char (&oBuf)[4096])
+    {
+        char pData[sizeof(FailureHeader) + MaxMessage];
+        Read(iPos, iSize, pData);
+        FailureHeader header;
+        memcpy(&header, pData, sizeof(header));
+        int messageSize = (int)(iSize - sizeof(header));
+        const char *pMessage = pData + sizeof(header);
+
+        int n = 0;
+        if(header.statement)
+            n = sprintf_s(oBuf, "#statement: %s\n#file     : %s\n#line     : %i\n", 
+                header.statement, header.file, header.line);
+        else if(header.hasMessage)
+            n = sprintf_s(oBuf, "#file    : %s\n#line    : %i\n#msg     : %.*s\n", 
+                header.file, header.line, messageSize, pMessage);
+        else
+            n = sprintf_s(oBuf, "#file    : %s\n#line    : %i\n", header.file, header.line);
+        return n < 0 ? 0 : (n < (int)sizeof(oBuf) ? n : (int)sizeof(oBuf) - 1);
+    }
+
+    /**
+     * Copies the complete messages starting from the given position to the batch,
+     * returns the position after the last collected message. Cells are not released.
+     */
+    long Collect(long iPos, std::string &oBatch)
+    {
+        long pos = iPos;
+        while(oBatch.size() < BatchSize)
+        {
+            unsigned int size = 0;
+            long numCells = 0;
+            if(!Complete(pos, size, numCells))
+                break;  //still being written
+
+            if(size & FailureBit)
+            {
+                char pBuf[4096];
+                oBatch.append(pBuf, FormatFailure(pos, size & ~FailureBit, pBuf));
+                pos += numCells;
+                continue;
+            }
+            size_t offset = sizeof(unsigned int);
+            for(long i = 0; i < numCells; i++)
+            {
+                size_t n = DataSize - offset < size ? DataSize - offset : size;
+                oBatch.append(At(pos + i).data + offset, n);
+                size -= (unsigned int)n;
+                offset = 0;
+            }
+            pos += numCells;
+        }
+        return pos;
+    }
+
+    /**
+     * Releases the cells of the written messages for the next lap
+     */
+    void Release(long iFrom, long iTo)
+    {
+        for(long pos = iFrom; pos != iTo; pos++)
+            platform::AtomicStore(&At(pos).sequence, pos + m_mask + 1);
+        platform::AtomicStore(&m_readPos, iTo);
+    }
+
+    /**
+     * Writes what is available, returns false if there was nothing to write
+     */
+    bool WriteBatch()
+    {
+        long dropped = platform::AtomicExchange(&m_dropped, 0);
+        if(dropped > 0)
+        {
+            char pBuf[128];
+            sprintf_s(pBuf, "...%li log messages are dropped\n", dropped);
+            platform::WriteAll(m_file, pBuf, strlen(pBuf));
+        }
+
+        long from = platform::AtomicLoad(&m_readPos);
+        m_batch.clear();
+        long to = Collect(from, m_batch);
+        if(to == from)
+            return false;
+        platform::WriteAll(m_file, m_batch.data(), m_batch.size());
+        Release(from, to);
+        return true;
+    }
+
+    /**
+     * Body of the background thread
+     */
+    void Run()
+    {
+        for(;;)
+        {
+            if(platform::AtomicLoad(&m_crashed))
+                return;
+            if(WriteBatch())
+                continue;
+            if(platform::AtomicLoad(&m_stop))
+            {
+                //producers may still be copying, stop once everything claimed is written
+                if(platform::AtomicLoad(&m_readPos) == platform::AtomicLoad(&m_writePos))
+                    return;
+                platform::Sleep(0.0001);
+                continue;
+            }
+            platform::AtomicExchange(&m_sleeping, 1);
+            if(platform::AtomicLoad(&At(platform::AtomicLoad(&m_readPos)).sequence) == platform::AtomicLoad(&m_readPos) + 1)
+                continue;
+            m_wakeUp.Wait(0.05);
+        }
+    }
+
+    /**
+     * Writes the remaining complete messages from the crashing thread. Messages which
+     * are being written by the background thread may be written twice, but none of
+     * them is lost.
+     */
+    void CrashFlush()
+    {
+        if(m_process != platform::ProcessId())
+            return; //copy of the logger in a forked child, parent writes them
+        platform::AtomicStore(&m_crashed, 1);
+        char pBuf[4096];
+        long pos = platform::AtomicLoad(&m_readPos);
+        for(;;)
+        {
+            unsigned int size = 0;
+            long numCells = 0;
+            if(!Complete(pos, size, numCells))
+                break;
+            if(size & FailureBit)
+            {
+                platform::WriteAll(m_file, pBuf, FormatFailure(pos, size & ~FailureBit, pBuf));
+                pos += numCells;
+                continue;
+            }
+            size_t offset = sizeof(unsigned int);
+            for(long i = 0; i < numCells; i++)
+            {
+                size_t n = DataSize - offset < size ? DataSize - offset : size;
+                memcpy(pBuf, At(pos + i).data + offset, n);
+                platform::WriteAll(m_file, pBuf, n);
+                size -= (unsigned int)n;
+                offset = 0;
+            }
+            pos += numCells;
+        }
+    }
+
+    class Writer : public platform::Thread
+    {
+    public:
+        void Run() { logger->Run(); }
+        AsyncLogger *logger;
+    };
+
+    /**
+     * Live loggers, they are flushed at exit and on crash. A fixed table is used so the
+     * crash handler does not need any lock. A slot is 0 if free, 1 while it is being 
+     * filled and 2 if it holds a logger.
+     */
+    enum { MaxLoggers = 16 };
+
+    static volatile long* Slots()
+    {
+        static volatile long slots[MaxLoggers] = {0};
+        return slots;
+    }
+
+    static AsyncLogger** Loggers()
+    {
+        static AsyncLogger* loggers[MaxLoggers] = {0};
+        return loggers;
+    }
+
+    static void Register(AsyncLogger *ipLogger)
+    {
+        static volatile long installed = 0;
+        if(platform::AtomicCompareExchange(&installed, 0, 1))
+        {
+            atexit(&FlushAll);
+            platform::OnCrash(&CrashFlushAll);
+        }
+        for(int i = 0; i < MaxLoggers; i++)
+        {
+            if(platform::AtomicCompareExchange(&Slots()[i], 0, 1))
+            {
+                Loggers()[i] = ipLogger;
+                platform::AtomicStore(&Slots()[i], 2);
+                return;
+            }
+        }
+    }
+
+    static void Unregister(AsyncLogger *ipLogger)
+    {
+        for(int i = 0; i < MaxLoggers; i++)
+            if(platform::AtomicLoad(&Slots()[i]) == 2 && Loggers()[i] == ipLogger)
+                platform::AtomicStore(&Slots()[i], 0);
+    }
+
+    static void FlushAll()
+    {
+        for(int i = 0; i < MaxLoggers; i++)
+            if(platform::AtomicLoad(&Slots()[i]) == 2)
+                Loggers()[i]->Flush();
+    }
+
+    static void CrashFlushAll()
+    {
+        for(int i = 0; i < MaxLoggers; i++)
+            if(platform::AtomicLoad(&Slots()[i]) == 2)
+                Loggers()[i]->CrashFlush();
+    }
+
+    int                 m_file;
+    OverflowPolicy      m_policy;
+    Cell               *m_cells;
+    long                m_mask;
+    volatile long       m_writePos;     //next position to be claimed by the producers
+    volatile long       m_readPos;      //next position to be written
+    volatile long       m_sleeping;     //1 if the writer waits for m_wakeUp
+    volatile long       m_stop;
+    volatile long       m_crashed;
+    volatile long       m_dropped;
+    int                 m_process;
+    std::string         m_batch;
+    platform::Event     m_wakeUp;
+    Writer              m_thread;
+
+    AsyncLogger(const AsyncLogger&);
+    AsyncLogger& operator=(const AsyncLogger&);
+};
+
+}; //namespace esintiler
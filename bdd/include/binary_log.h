@@ -0,0 +1,459 @@
+/**
+ * Compact binary log of a run.
+ *
+ * BinaryLogger writes every event of the run as a fixed size record to a memory mapped
+ * file. Strings which repeat (suite, test and file names, statements) are written once,
+ * records refer to them by id, so the same names are not repeated for each event. Texts
+ * which are mostly unique (messages, reasons) are written after their record and are not
+ * kept by the logger. Mapped data is kept by the operating system, records written before
+ * a crash are not lost.
+ *
+ * The log is converted to text, JUnit XML or JSON Lines later by replaying it to one of
+ * the loggers (see BinaryLogger::Replay and the bdd_log_convert tool).
+ *
+ * Usage Example
+ *
+    int main(int argc, char* argv[])
+    {
+        BinaryLogger logger("results.bin");
+        return TestManager::ExecuteAllSuites(&logger);
+    }
+ *
+ * and later "bdd_log_convert results.bin junit results.xml".
+ */
+#pragma once
+
+#include "suite.h"
+
+namespace esintiler
+{
+
+class BinaryLogger : public Reporter
+{
+public:
+    /**
+     * @ipFile: binary log to be created
+     * @ipNext: logger to pass all the events to, NULL if there is none
+     */
+    BinaryLogger(const char *ipFile, Logger *ipNext = 0)
+        : Reporter(0, ipNext)
+        , m_size(0)
+        , m_slots(1024, 0)
+    {
+        m_open = m_mapped.Open(ipFile, 64 * 1024);
+        FileHeader header = { {'E', 'S', 'B', 'L'}, Version };
+        Append(&header, sizeof(header));
+    }
+
+    ~BinaryLogger()
+    {
+        m_mapped.Close(m_size);
+    }
+
+    bool IsOpen() const
+    {
+        return m_open;
+    }
+
+    using Reporter::log;
+
+    void log(const char *ipMsg)
+    {
+        Reporter::log(ipMsg);
+        size_t length = strlen(ipMsg);
+        Record record = NewRecord('L');
+        record.values[0] = (unsigned int)length;
+        Append(&record, sizeof(record));
+        AppendText(ipMsg, length);
+    }
+
+    void timing(const char *ipSuite, const char *ipTest, TimingPhase iPhase, double iSeconds)
+    {
+        Reporter::timing(ipSuite, ipTest, iPhase, iSeconds);
+        Record record = NewRecord('P');
+        record.values[0] = Intern(ipSuite);
+        record.values[1] = Intern(ipTest);
+        record.phase = (unsigned short)iPhase;
+        record.seconds = iSeconds;
+        Append(&record, sizeof(record));
+    }
+
+    void benchmark(const BenchmarkResult &iResult)
+    {
+        Reporter::benchmark(iResult);
+        Record record = NewRecord('B');
+        record.values[0] = Intern(iResult.suite.c_str());
+        record.values[1] = Intern(iResult.test.c_str());
+        record.values[2] = (unsigned int)iResult.iterations;
+        record.values[3] = (unsigned int)iResult.samples.size();
+        Append(&record, sizeof(record));
+        if(!iResult.samples.empty())
+            Append(&iResult.samples[0], iResult.samples.size() * sizeof(double));
+    }
+
+    void failure(const FailureRecord &iFailure)
+    {
+        Reporter::failure(iFailure);
+        Record record = NewRecord('F');
+        record.values[0] = Intern(iFailure.suite);
+        record.values[1] = Intern(iFailure.test);
+        record.values[2] = Intern(iFailure.file);
+        record.values[3] = (unsigned int)iFailure.line;
+        if(iFailure.statement)
+        {
+            record.flags |= HasStatement;
+            record.values[4] = Intern(iFailure.statement);
+        }
+        size_t length = iFailure.message ? strlen(iFailure.message) : 0;
+        if(iFailure.message)
+        {
+            record.flags |= HasMessage;
+            record.values[5] = (unsigned int)length;
+        }
+        Append(&record, sizeof(record));
+        AppendText(iFailure.message, length);
+    }
+
+    void result(const TestRecord &iRecord)
+    {
+        Reporter::result(iRecord);
+        Record record = NewRecord('D');
+        record.values[0] = Intern(iRecord.suite);
+        record.values[1] = Intern(iRecord.test);
+        record.values[2] = (unsigned int)iRecord.retVal;
+        record.values[3] = (unsigned int)iRecord.numAssertions;
+        record.values[4] = (unsigned int)iRecord.numFailedAssertions;
+        size_t length = iRecord.reason ? strlen(iRecord.reason) : 0;
+        if(iRecord.reason)
+        {
+            record.flags |= HasReason;
+            record.values[5] = (unsigned int)length;
+        }
+        record.seconds = iRecord.seconds;
+        Append(&record, sizeof(record));
+        AppendText(iRecord.reason, length);
+    }
+
+    void summary(const RunSummary &iSummary)
+    {
+        Reporter::summary(iSummary);
+        for(unsigned int i = 0; i < iSummary.slowestTests.size(); i++)
+            AppendSlowest(iSummary.slowestTests[i], 0);
+        for(unsigned int i = 0; i < iSummary.slowestSuites.size(); i++)
+            AppendSlowest(iSummary.slowestSuites[i], SuiteEntry);
+        Record record = NewRecord('U');
+        record.values[0] = (unsigned int)iSummary.retVal;
+        record.values[1] = (unsigned int)iSummary.numTests;
+        record.values[2] = (unsigned int)iSummary.numAssertions;
+        record.values[3] = (unsigned int)iSummary.numFailedAssertions;
+        record.seconds = iSummary.seconds;
+        Append(&record, sizeof(record));
+    }
+
+    /**
+     * Reads a binary log and passes its events to the given logger in the order they
+     * were logged. Log of a crashed run is read until its last complete record.
+     *
+     * @return: false if the file can not be read or it is not a binary log
+     */
+    static bool Replay(const char *ipFile, Logger *logger)
+    {
+        std::string data;
+        FILE *pFile = platform::OpenFile(ipFile, "rb");
+        if(!pFile)
+            return false;
+        char pBuf[64 * 1024];
+        size_t numRead = 0;
+        while((numRead = fread(pBuf, 1, sizeof(pBuf), pFile)) > 0)
+            data.append(pBuf, numRead);
+        fclose(pFile);
+
+        FileHeader header;
+        if(data.size() < sizeof(header))
+            return false;
+        memcpy(&header, data.data(), sizeof(header));
+        if(memcmp(header.magic, "ESBL", 4) != 0 || header.version != Version)
+            return false;
+
+        std::vector<std::string> strings;
+        std::string text;
+        RunSummary summary;
+        size_t pos = sizeof(header);
+        Record record;
+        while(data.size() - pos >= sizeof(record))
+        {
+            memcpy(&record, data.data() + pos, sizeof(record));
+            pos += sizeof(record);
+            const unsigned int *v = record.values;
+            switch(record.kind)
+            {
+            case 'S':
+                if(!ReadText(data, pos, v[1], text))
+                    return true;
+                strings.push_back(text);
+                break;
+            case 'L':
+                if(!ReadText(data, pos, v[0], text))
+                    return true;
+                logger->log(text.c_str());
+                break;
+            case 'P':
+                logger->timing(Text(strings, v[0]), Text(strings, v[1]), (TimingPhase)record.phase,
+                    record.seconds);
+                break;
+            case 'B':
+                {
+                    if((data.size() - pos) / sizeof(double) < v[3])
+                        return true;
+                    BenchmarkResult result;
+                    result.suite = Text(strings, v[0]);
+                    result.test = Text(strings, v[1]);
+                    result.iterations = (long)v[2];
+                    result.samples.resize(v[3]);
+                    if(v[3] > 0)
+                        memcpy(&result.samples[0], data.data() + pos, v[3] * sizeof(double));
+                    pos += v[3] * sizeof(double);
+                    result.Compute();
+                    logger->benchmark(result);
+                }
+                break;
+            case 'F':
+                {
+                    if(!ReadText(data, pos, record.flags & HasMessage ? v[5] : 0, text))
+                        return true;
+                    FailureRecord failure = {
+                        record.flags & HasStatement ? PersistentString(Text(strings, v[4])) : 0,
+                        record.flags & HasMessage ? text.c_str() : 0,
+                        PersistentString(Text(strings, v[2])), (int)v[3], Text(strings, v[0]), 
+                        Text(strings, v[1]) };
+                    logger->failure(failure);
+                }
+                break;
+            case 'D':
+                {
+                    if(!ReadText(data, pos, record.flags & HasReason ? v[5] : 0, text))
+                        return true;
+                    TestRecord result = { Text(strings, v[0]), Text(strings, v[1]), (int)v[2],
+                        (int)v[3], (int)v[4], record.seconds,
+                        record.flags & HasReason ? text.c_str() : 0 };
+                    logger->result(result);
+                }
+                break;
+            case 'W':
+                {
+                    TimingEntry entry(Text(strings, v[0]), Text(strings, v[1]), record.seconds);
+                    if(record.flags & SuiteEntry)
+                        summary.slowestSuites.push_back(entry);
+                    else
+                        summary.slowestTests.push_back(entry);
+                }
+                break;
+            case 'U':
+                summary.retVal = (int)v[0];
+                summary.numTests = (int)v[1];
+                summary.numAssertions = (int)v[2];
+                summary.numFailedAssertions = (int)v[3];
+                summary.seconds = record.seconds;
+                logger->summary(summary);
+                summary = RunSummary();
+                break;
+            default:
+                //unused part of the mapping of a crashed run
+                return true;
+            }
+        }
+        return true;
+    }
+
+private:
+    enum
+    {
+        Version = 2,
+        HasStatement = 1,
+        HasMessage = 2,
+        HasReason = 1,
+        SuiteEntry = 1
+    };
+
+    struct FileHeader
+    {
+        char            magic[4];
+        unsigned int    version;
+    };
+
+    /**
+     * An event, meaning of the values depends on the kind:
+     *
+     *  'S' string: id, length. Followed by the text
+     *  'L' message: length. Followed by the text
+     *  'P' timing: suite, test, phase and seconds
+     *  'B' benchmark: suite, test, iterations, number of samples. Followed by the samples
+     *  'F' failure: suite, test, file, line, statement, length of the message. Followed
+     *      by the message
+     *  'D' result of a test: suite, test, retVal, assertions, failed assertions, length 
+     *      of the reason. Followed by the reason
+     *  'W' one of the slowest tests/suites of the summary: suite, test and seconds
+     *  'U' summary: retVal, tests, assertions, failed assertions and seconds
+     *
+     * Strings are given by their ids, texts following a record are padded to 8 bytes. 
+     * Numbers are in the byte order of the machine.
+     */
+    struct Record
+    {
+        unsigned char   kind;
+        unsigned char   flags;
+        unsigned short  phase;
+        unsigned int    values[6];
+        unsigned int    reserved;
+        double          seconds;
+    };
+
+    struct StringEntry
+    {
+        unsigned int    hash;
+        size_t          offset;     //in the pool
+        size_t          length;
+    };
+
+    static Record NewRecord(unsigned char iKind)
+    {
+        Record record;
+        memset(&record, 0, sizeof(record));
+        record.kind = iKind;
+        return record;
+    }
+
+    static size_t Padded(size_t iSize)
+    {
+        return (iSize + 7) & ~(size_t)7;
+    }
+
+    static const char* Text(const std::vector<std::string> &iStrings, unsigned int iId)
+    {
+        return iId < iStrings.size() ? iStrings[iId].c_str() : "";
+    }
+
+    /**
+     * Reads the text following a record, false if the log ends before it
+     */
+    static bool ReadText(const std::string &iData, size_t &ioPos, size_t iLength, std::string &oText)
+    {
+        if(iData.size() - ioPos < iLength)
+            return false;
+        oText.assign(iData, ioPos, iLength);
+        ioPos += Padded(iLength);
+        if(ioPos > iData.size())
+            ioPos = iData.size();
+        return true;
+    }
+
+    /**
+     * FNV-1a
+     */
+    static unsigned int Hash(const char *ipText, size_t iLength)
+    {
+        unsigned int hash = 2166136261u;
+        for(size_t i = 0; i < iLength; i++)
+            hash = (hash ^ (unsigned char)ipText[i]) * 16777619u;
+        return hash;
+    }
+
+    /**
+     * Returns the id of the text, writing it to the file the first time it is seen.
+     * Strings are kept in an open addressing table so looking up a known one does not
+     * allocate.
+     */
+    unsigned int Intern(const char *ipText)
+    {
+        size_t length = strlen(ipText);
+        unsigned int hash = Hash(ipText, length);
+        size_t mask = m_slots.size() - 1;
+        size_t slot = hash & mask;
+        for(; m_slots[slot] != 0; slot = (slot + 1) & mask)
+        {
+            const StringEntry &entry = m_strings[m_slots[slot] - 1];
+            if(entry.hash == hash && entry.length == length &&
+                memcmp(m_pool.data() + entry.offset, ipText, length) == 0)
+                return m_slots[slot] - 1;
+        }
+
+        unsigned int id = (unsigned int)m_strings.size();
+        StringEntry entry = { hash, m_pool.size(), length };
+        m_strings.push_back(entry);
+        m_pool.append(ipText, length);
+        m_slots[slot] = id + 1;
+        if(m_strings.size() * 2 > m_slots.size())
+            Rehash();
+
+        Record record = NewRecord('S');
+        record.values[0] = id;
+        record.values[1] = (unsigned int)length;
+        Append(&record, sizeof(record));
+        AppendText(ipText, length);
+        return id;
+    }
+
+    /**
+     * Writes the text following a record, padded to 8 bytes
+     */
+    void AppendText(const char *ipText, size_t iLength)
+    {
+        static const char padding[8] = {0};
+        Append(ipText, iLength);
+        Append(padding, Padded(iLength) - iLength);
+    }
+
+    void Rehash()
+    {
+        std::vector<unsigned int> slots(m_slots.size() * 2, 0);
+        size_t mask = slots.size() - 1;
+        for(unsigned int id = 0; id < m_strings.size(); id++)
+        {
+            size_t slot = m_strings[id].hash & mask;
+            while(slots[slot] != 0)
+                slot = (slot + 1) & mask;
+            slots[slot] = id + 1;
+        }
+        m_slots.swap(slots);
+    }
+
+    void AppendSlowest(const TimingEntry &iEntry, unsigned char iFlags)
+    {
+        Record record = NewRecord('W');
+        record.flags = iFlags;
+        record.values[0] = Intern(iEntry.suite.c_str());
+        record.values[1] = Intern(iEntry.test.c_str());
+        record.seconds = iEntry.seconds;
+        Append(&record, sizeof(record));
+    }
+
+    /**
+     * Copies the data to the mapping, doubling the mapping when it is full. Nothing is
+     * written once the file can not be grown.
+     */
+    void Append(const void *ipData, size_t iSize)
+    {
+        if(!m_open || iSize == 0)
+            return;
+        if(m_size + iSize > m_mapped.Capacity())
+        {
+            size_t capacity = m_mapped.Capacity();
+            while(m_size + iSize > capacity)
+                capacity *= 2;
+            m_open = m_mapped.Grow(capacity);
+            if(!m_open)
+                return;
+        }
+        memcpy(m_mapped.Data() + m_size, ipData, iSize);
+        m_size += iSize;
+    }
+
+    platform::MappedFile        m_mapped;
+    bool                        m_open;
+    size_t                      m_size;         //used part of the mapping
+    std::vector<unsigned int>   m_slots;        //id + 1 of the strings, 0 if empty
+    std::vector<StringEntry>    m_strings;
+    std::string                 m_pool;         //texts of the strings
+};
+
+}; //namespace esintiler
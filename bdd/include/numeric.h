@@ -6,7 +6,11 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "value.h"
+#include "numeric_kernels.h"
 
 namespace esintiler
 {
@@ -26,17 +30,11 @@ struct _BaseNumericTester: public TesterBase<_NumericTester<VT>>
 
     inline ValueType& value()
     {
-        Base *pRoot = root();
-        NumericValue<ValueType>* pNV = (NumericValue<ValueType>*)pRoot;
-        ValueType& val = (ValueType&) (*pNV) ;
-        return val;
+        return *(ValueType*)this->pValue;
     }
     inline ValueType* valuePtr()
     {
-        Base *pRoot = root();
-        NumericValue<ValueType>* pNV = (NumericValue<ValueType>*)pRoot;
-        ValueType *pVal = (ValueType*) (*pNV) ;
-        return pVal;
+        return (ValueType*)this->pValue;
     } 
 
 };
@@ -44,6 +42,11 @@ struct _BaseNumericTester: public TesterBase<_NumericTester<VT>>
 template<class VT>
 struct NumericTester: _BaseNumericTester<VT>
 {
+    typedef typename _BaseNumericTester<VT>::ResultType ResultType;
+    typedef typename _BaseNumericTester<VT>::ValueType  ValueType;
+    using _BaseNumericTester<VT>::value;
+    using _BaseNumericTester<VT>::result;
+
     NumericTester()
         : _BaseNumericTester<VT>()
     {
@@ -64,11 +67,38 @@ struct NumericTester: _BaseNumericTester<VT>
         return result(value() > iVal);
     }  
 
-    //TODO: 
-    //ResultType be_in(const ValueType* iVal, int iNum)
+    /**
+     * |value - expected| <= abs + rel * |expected|, NaN is only close to NaN, see Tolerance
+     */
+    TESTER_METHOD(be_close_to, (const ValueType &iExpected, double iAbs, double iRel = 0))
+    {
+        return result(Tolerance<VT>::Close(value(), iExpected, iAbs, iRel));
+    }
 
+    /**
+     * Distance in units in the last place, see Tolerance
+     */
+    TESTER_METHOD(be_within_ulps, (const ValueType &iExpected, unsigned long long iUlps))
+    {
+        return result(Tolerance<VT>::Ulps(value(), iExpected) <= iUlps);
+    }
 
+    /**
+     * Membership in the candidates. A single check scans them, repeated checks against 
+     * the same candidates should keep a NumericSet which is sorted once.
+     */
+    TESTER_METHOD(be_in, (const ValueType *ipCandidates, int iNum))
+    {
+        bool found = false;
+        for(int i = 0; i < iNum && !found; i++)
+            found = ipCandidates[i] == value();
+        return result(found);
+    }
 
+    TESTER_METHOD(be_in, (const NumericSet<VT> &iSet))
+    {
+        return result(iSet.Contains(value()));
+    }
 };
 
 template <class VT>
@@ -81,9 +111,386 @@ public:
     }
 };
 
+/**
+ * Bulk checks of arrays. value(pointer, size) or value(vector) tests all elements at once:
+ *
+    CHECK_THAT(value(pOutput, size).should.all.be_less_than(1.0f));
+    CHECK_THAT(value(output).should.none.equal_to(0.0f).and.any.be_greater_than(0.5f));
+
+ * "all" is used when no quantifier is given, "not" negates the quantified check. 
+ * be_close_to and be_within_ulps compare each element with the element of an array of 
+ * expected values:
+ *
+    CHECK.True(value(output).should.be_close_to(reference, 1e-6, 1e-5));
+    CHECK.True(value(pOutput, size).should.be_within_ulps(pReference, 4));
+
+ * be_in checks the membership of each element in candidate values, see NumericSet.
+ * Elements are compared by the CompareKernel and Tolerance, so float and double arrays are
+ * checked with vector instructions. A failed check reports the number of mismatching elements and the first
+ * of them, CHECK.True and ASSERT.True add the report to the failure (see FailureMessage).
+ */
+enum Quantifier
+{
+    QuantifierAll,
+    QuantifierAny,
+    QuantifierNone
+};
+
+/**
+ * Elements under test and the report of the checks which failed on them
+ */
+template<class VT>
+struct NumericSpan
+{
+    NumericSpan(const VT *ipData, size_t iSize)
+        : data(ipData), size(iSize)
+    {
+    }
+
+    /**
+     * Describes a failed comparison with a value
+     */
+    template<class Op>
+    ESINTILER_COLD void Report(Quantifier iQuantifier, bool iNegate, const VT &iExpected, size_t iMatches)
+    {
+        char pBuf[256];
+        sprintf_s(pBuf, "%s %g", Op::Name(), (double)iExpected);
+        bool compares = false;
+        if(!Describe(iQuantifier, iNegate, iMatches, pBuf, compares))
+            return;
+        report += ", first at";
+        int numIndices = 0;
+        for(size_t i = 0; i < size && numIndices < MaxIndices; i++)
+        {
+            if(Op::Scalar(data[i], iExpected) == compares)
+                continue;
+            sprintf_s(pBuf, " %lu (%g)", (unsigned long)i, (double)data[i]);
+            report += pBuf;
+            numIndices++;
+        }
+    }
+
+    /**
+     * Describes a failed comparison with the expected values within a tolerance, see 
+     * CloseTo and WithinUlps. The largest error relative to the allowed one and a 
+     * histogram of the errors are also reported.
+     */
+    template<class Measure>
+    ESINTILER_COLD void Report(Quantifier iQuantifier, bool iNegate, const VT *ipExpected, 
+        const Measure &iMeasure, size_t iMatches)
+    {
+        bool compares = false;
+        if(!Describe(iQuantifier, iNegate, iMatches, iMeasure.Describe().c_str(), compares))
+            return;
+
+        //bins of the error: <= 0.5, 1, 2, 10 times the allowed error, larger and NaN
+        static const double limits[] = { 0.5, 1, 2, 10 };
+        size_t histogram[6] = { 0, 0, 0, 0, 0, 0 };
+        size_t worst = 0;
+        double worstRatio = -1;
+        for(size_t i = 0; i < size; i++)
+        {
+            double error = iMeasure.Error(data[i], ipExpected[i]);
+            double allowed = iMeasure.Allowed(ipExpected[i]);
+            if(error != error)
+            {
+                histogram[5]++;
+                continue;
+            }
+            int bin = 0;
+            while(bin < 4 && error > limits[bin] * allowed)
+                bin++;
+            histogram[bin]++;
+            double ratio = error == 0 ? 0 : error / allowed;
+            if(ratio > worstRatio)
+            {
+                worstRatio = ratio;
+                worst = i;
+            }
+        }
+
+        char pBuf[256];
+        if(worstRatio >= 0)
+        {
+            sprintf_s(pBuf, ", max error %g (allowed %g) at %lu (%g, expected %g)", 
+                iMeasure.Error(data[worst], ipExpected[worst]), iMeasure.Allowed(ipExpected[worst]), 
+                (unsigned long)worst, (double)data[worst], (double)ipExpected[worst]);
+            report += pBuf;
+        }
+        sprintf_s(pBuf, ", errors <=0.5: %lu, <=1: %lu, <=2: %lu, <=10: %lu, >10: %lu, NaN: %lu", 
+            (unsigned long)histogram[0], (unsigned long)histogram[1], (unsigned long)histogram[2], 
+            (unsigned long)histogram[3], (unsigned long)histogram[4], (unsigned long)histogram[5]);
+        report += pBuf;
+
+        report += ", first at";
+        int numIndices = 0;
+        for(size_t i = 0; i < size && numIndices < MaxIndices; i++)
+        {
+            if(iMeasure.Holds(data[i], ipExpected[i]) == compares)
+                continue;
+            sprintf_s(pBuf, " %lu (%g, expected %g)", (unsigned long)i, (double)data[i], (double)ipExpected[i]);
+            report += pBuf;
+            numIndices++;
+        }
+    }
+
+    /**
+     * Describes a failed membership check
+     */
+    ESINTILER_COLD void Report(Quantifier iQuantifier, bool iNegate, const NumericSet<VT> &iSet, size_t iMatches)
+    {
+        char pBuf[64];
+        sprintf_s(pBuf, "in the set of %lu values", (unsigned long)iSet.Size());
+        bool compares = false;
+        if(!Describe(iQuantifier, iNegate, iMatches, pBuf, compares))
+            return;
+        report += ", first at";
+        int numIndices = 0;
+        for(size_t i = 0; i < size && numIndices < MaxIndices; i++)
+        {
+            if(iSet.Contains(data[i]) == compares)
+                continue;
+            sprintf_s(pBuf, " %lu (%g)", (unsigned long)i, (double)data[i]);
+            report += pBuf;
+            numIndices++;
+        }
+    }
+
+    /**
+     * Describes a failed check with the expected values of another array, they should be
+     * as many as the elements
+     */
+    ESINTILER_COLD void ReportSize(size_t iExpected)
+    {
+        char pBuf[128];
+        sprintf_s(pBuf, "%lu expected values for %lu elements", (unsigned long)iExpected, (unsigned long)size);
+        if(!report.empty())
+            report += "; ";
+        report += pBuf;
+    }
+
+    enum { MaxIndices = 8 };
+
+    const VT    *data;
+    size_t      size;
+    std::string report;
+
+private:
+    /**
+     * Starts the report of a failed check. Every quantified check is either "each element
+     * should (not) compare" or "some element should (not) compare", it returns true for 
+     * the first kind so the mismatching elements are listed.
+     */
+    bool Describe(Quantifier iQuantifier, bool iNegate, size_t iMatches, const char *ipCheck, bool &oCompares)
+    {
+        bool each = (iQuantifier == QuantifierAny) == iNegate;
+        oCompares = (iQuantifier == QuantifierNone) == iNegate;
+        char pBuf[256];
+        if(!report.empty())
+            report += "; ";
+        if(!each)
+            sprintf_s(pBuf, "%s %lu elements %s %s", oCompares ? "none of" : "all", 
+                (unsigned long)size, oCompares ? "is" : "are", ipCheck);
+        else
+            sprintf_s(pBuf, "%lu of %lu elements are %s%s", 
+                (unsigned long)(oCompares ? size - iMatches : iMatches), (unsigned long)size, 
+                oCompares ? "not " : "", ipCheck);
+        report += pBuf;
+        return each;
+    }
+};
+
+template<class VT> struct NumericSpanTester;
+
+/**
+ * Should with the quantifiers of the bulk checks
+ */
+template <class TT>
+class Quantified : public Should<TT>
+{
+public:
+    void Bind(void *ipValue, Operators iOp, bool iPrevious)
+    {
+        Should<TT>::Bind(ipValue, iOp, iPrevious);
+        all.Bind(ipValue, iOp, iPrevious, false);
+        any.Bind(ipValue, iOp, iPrevious, false);
+        any.quantifier = QuantifierAny;
+        none.Bind(ipValue, iOp, iPrevious, false);
+        none.quantifier = QuantifierNone;
+    }
+
+    TT all;
+    TT any;
+    TT none;
+};
+
+template<class VT>
+class _NumericSpanTester : public Quantified<NumericSpanTester<VT>>
+{
+};
+
+template<class VT>
+struct NumericSpanTester: TesterBase<_NumericSpanTester<VT>>
+{
+    typedef Result<_NumericSpanTester<VT>> ResultType;
+    typedef VT ValueType;
+
+    NumericSpanTester()
+        : quantifier(QuantifierAll)
+    {
+    }
+
+    TESTER_METHOD(equal_to, (const ValueType &iVal))
+    {
+        return Check<CompareEqual>(iVal);
+    }
+    
+    TESTER_METHOD(be_less_than, (const ValueType &iVal))
+    {
+        return Check<CompareLess>(iVal);
+    }
+    
+    TESTER_METHOD(be_greater_than, (const ValueType &iVal))
+    {
+        return Check<CompareGreater>(iVal);
+    }
+
+    /**
+     * Each element is compared with the element of the expected values at the same index,
+     * see Tolerance
+     */
+    TESTER_METHOD(be_close_to, (const ValueType *ipExpected, double iAbs, double iRel = 0))
+    {
+        return CheckEach(ipExpected, CloseTo(iAbs, iRel));
+    }
+
+    TESTER_METHOD(be_close_to, (const std::vector<ValueType> &iExpected, double iAbs, double iRel = 0))
+    {
+        if(!SameSize(iExpected))
+            return this->result(this->negate);
+        return CheckEach(iExpected.empty() ? 0 : &iExpected[0], CloseTo(iAbs, iRel));
+    }
+
+    TESTER_METHOD(be_within_ulps, (const ValueType *ipExpected, unsigned long long iUlps))
+    {
+        return CheckEach(ipExpected, WithinUlps(iUlps));
+    }
+
+    TESTER_METHOD(be_within_ulps, (const std::vector<ValueType> &iExpected, unsigned long long iUlps))
+    {
+        if(!SameSize(iExpected))
+            return this->result(this->negate);
+        return CheckEach(iExpected.empty() ? 0 : &iExpected[0], WithinUlps(iUlps));
+    }
+
+    /**
+     * Membership of each element, the candidates are sorted into a NumericSet for this
+     * check. Checks repeated against the same candidates should keep the NumericSet.
+     */
+    TESTER_METHOD(be_in, (const ValueType *ipCandidates, int iNum))
+    {
+        return CheckIn(NumericSet<VT>(ipCandidates, iNum));
+    }
+
+    TESTER_METHOD(be_in, (const NumericSet<VT> &iSet))
+    {
+        return CheckIn(iSet);
+    }
+
+    Quantifier quantifier;
+
+private:
+    template<class Op>
+    ResultType Check(const ValueType &iVal)
+    {
+        NumericSpan<VT> &span = *(NumericSpan<VT>*)this->pValue;
+        size_t matches = CompareKernel<VT>::template Count<Op>(span.data, span.size, iVal);
+        bool passed = Passed(matches, span.size);
+        if(ESINTILER_UNLIKELY(passed == this->negate))
+            span.template Report<Op>(quantifier, this->negate, iVal, matches);
+        return this->result(passed);
+    }
+
+    template<class Measure>
+    ResultType CheckEach(const ValueType *ipExpected, const Measure &iMeasure)
+    {
+        NumericSpan<VT> &span = *(NumericSpan<VT>*)this->pValue;
+        size_t matches = iMeasure.Count(span.data, ipExpected, span.size);
+        bool passed = Passed(matches, span.size);
+        if(ESINTILER_UNLIKELY(passed == this->negate))
+            span.Report(quantifier, this->negate, ipExpected, iMeasure, matches);
+        return this->result(passed);
+    }
+
+    ResultType CheckIn(const NumericSet<VT> &iSet)
+    {
+        NumericSpan<VT> &span = *(NumericSpan<VT>*)this->pValue;
+        size_t matches = iSet.Count(span.data, span.size);
+        bool passed = Passed(matches, span.size);
+        if(ESINTILER_UNLIKELY(passed == this->negate))
+            span.Report(quantifier, this->negate, iSet, matches);
+        return this->result(passed);
+    }
+
+    bool Passed(size_t iMatches, size_t iSize) const
+    {
+        return quantifier == QuantifierAll ? iMatches == iSize : 
+            quantifier == QuantifierAny ? iMatches > 0 : iMatches == 0;
+    }
+
+    /**
+     * False and reported if the expected values are not as many as the elements, such a
+     * check fails even with "not"
+     */
+    bool SameSize(const std::vector<ValueType> &iExpected)
+    {
+        NumericSpan<VT> &span = *(NumericSpan<VT>*)this->pValue;
+        if(ESINTILER_LIKELY(iExpected.size() == span.size))
+            return true;
+        span.ReportSize(iExpected.size());
+        return false;
+    }
+};
+
+/**
+ * Value of the bulk checks, it keeps the NumericSpan its testers refer to
+ */
+template <class VT>
+class NumericSpanValue : public Value<NumericSpan<VT>, _NumericSpanTester<VT>>
+{
+public:
+    NumericSpanValue(const VT *ipData, size_t iSize)
+        : Value<NumericSpan<VT>, _NumericSpanTester<VT>>(&m_span)
+        , m_span(ipData, iSize)
+    {
+    }
+
+    NumericSpanValue(const NumericSpanValue &iOther)
+        : Value<NumericSpan<VT>, _NumericSpanTester<VT>>(&m_span)
+        , m_span(iOther.m_span)
+    {
+    }
+
+private:
+    NumericSpan<VT> m_span;
+};
+
+/**
+ * Report of the failed bulk checks, CHECK.True and ASSERT.True use it as the message
+ */
+template<class VT>
+inline const char* FailureMessage(const Result<_NumericSpanTester<VT>> &iResult)
+{
+    const NumericSpan<VT> *pSpan = (const NumericSpan<VT>*)iResult.and.pValue;
+    return pSpan->report.empty() ? 0 : pSpan->report.c_str();
+}
+
 #define NUMERIC_TESTER(VT) \
     typedef NumericValue<VT> Value##VT;    \
-    Value##VT value(VT& iVal) { return Value##VT(iVal); }
+    inline Value##VT value(VT& iVal) { return Value##VT(iVal); } \
+    inline NumericSpanValue<VT> value(const VT *ipData, size_t iSize) { return NumericSpanValue<VT>(ipData, iSize); } \
+    inline NumericSpanValue<VT> value(const std::vector<VT> &iData) \
+        { return NumericSpanValue<VT>(iData.empty() ? 0 : &iData[0], iData.size()); }
 
 NUMERIC_TESTER(char);
 NUMERIC_TESTER(short);
@@ -0,0 +1,713 @@
+/**
+ * Loops of the bulk numeric checks, see NumericSpanTester. float and double arrays are
+ * processed with AVX2 or SSE2 when the compiler targets them (see platform.h), all other
+ * types and the remaining elements use the scalar loop.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "platform.h"
+
+#ifdef ESINTILER_SSE2
+    #include <emmintrin.h>
+#endif
+#ifdef ESINTILER_AVX2
+    #include <immintrin.h>
+#endif
+
+namespace esintiler
+{
+
+/**
+ * Sums of the lane counters. Vector comparisons set all bits of the lanes where they
+ * hold, so subtracting their results from the counters counts the matches per lane.
+ */
+struct VectorLanes
+{
+#ifdef ESINTILER_SSE2
+    static size_t SumInt32(__m128i iLanes)
+    {
+        int counts[4];
+        _mm_storeu_si128((__m128i*)counts, iLanes);
+        return (size_t)counts[0] + counts[1] + counts[2] + counts[3];
+    }
+
+    static size_t SumInt64(__m128i iLanes)
+    {
+        long long counts[2];
+        _mm_storeu_si128((__m128i*)counts, iLanes);
+        return (size_t)(counts[0] + counts[1]);
+    }
+#endif
+#ifdef ESINTILER_AVX2
+    static size_t SumInt32(__m256i iLanes)
+    {
+        int counts[8];
+        _mm256_storeu_si256((__m256i*)counts, iLanes);
+        size_t sum = 0;
+        for(int i = 0; i < 8; i++)
+            sum += counts[i];
+        return sum;
+    }
+
+    static size_t SumInt64(__m256i iLanes)
+    {
+        long long counts[4];
+        _mm256_storeu_si256((__m256i*)counts, iLanes);
+        return (size_t)(counts[0] + counts[1] + counts[2] + counts[3]);
+    }
+#endif
+
+    /**
+     * Elements counted in 32 bit lanes before the counters are added up, so they can not
+     * overflow
+     */
+    enum { BlockSize = 1 << 28 };
+};
+
+/**
+ * Comparisons of the bulk checks in scalar and vector forms. Vector forms are ordered
+ * comparisons, like the scalar ones they never hold for NaN.
+ */
+struct CompareEqual
+{
+    static const char* Name() { return "equal to"; }
+
+    template<class T>
+    static bool Scalar(const T &iValue, const T &iExpected) { return iValue == iExpected; }
+#ifdef ESINTILER_SSE2
+    static __m128  Sse(__m128 iValue, __m128 iExpected)   { return _mm_cmpeq_ps(iValue, iExpected); }
+    static __m128d Sse(__m128d iValue, __m128d iExpected) { return _mm_cmpeq_pd(iValue, iExpected); }
+#endif
+#ifdef ESINTILER_AVX2
+    static __m256  Avx(__m256 iValue, __m256 iExpected)   { return _mm256_cmp_ps(iValue, iExpected, _CMP_EQ_OQ); }
+    static __m256d Avx(__m256d iValue, __m256d iExpected) { return _mm256_cmp_pd(iValue, iExpected, _CMP_EQ_OQ); }
+#endif
+};
+
+struct CompareLess
+{
+    static const char* Name() { return "less than"; }
+
+    template<class T>
+    static bool Scalar(const T &iValue, const T &iExpected) { return iValue < iExpected; }
+#ifdef ESINTILER_SSE2
+    static __m128  Sse(__m128 iValue, __m128 iExpected)   { return _mm_cmplt_ps(iValue, iExpected); }
+    static __m128d Sse(__m128d iValue, __m128d iExpected) { return _mm_cmplt_pd(iValue, iExpected); }
+#endif
+#ifdef ESINTILER_AVX2
+    static __m256  Avx(__m256 iValue, __m256 iExpected)   { return _mm256_cmp_ps(iValue, iExpected, _CMP_LT_OQ); }
+    static __m256d Avx(__m256d iValue, __m256d iExpected) { return _mm256_cmp_pd(iValue, iExpected, _CMP_LT_OQ); }
+#endif
+};
+
+struct CompareGreater
+{
+    static const char* Name() { return "greater than"; }
+
+    template<class T>
+    static bool Scalar(const T &iValue, const T &iExpected) { return iValue > iExpected; }
+#ifdef ESINTILER_SSE2
+    static __m128  Sse(__m128 iValue, __m128 iExpected)   { return _mm_cmpgt_ps(iValue, iExpected); }
+    static __m128d Sse(__m128d iValue, __m128d iExpected) { return _mm_cmpgt_pd(iValue, iExpected); }
+#endif
+#ifdef ESINTILER_AVX2
+    static __m256  Avx(__m256 iValue, __m256 iExpected)   { return _mm256_cmp_ps(iValue, iExpected, _CMP_GT_OQ); }
+    static __m256d Avx(__m256d iValue, __m256d iExpected) { return _mm256_cmp_pd(iValue, iExpected, _CMP_GT_OQ); }
+#endif
+};
+
+/**
+ * Counts the elements of an array for which the comparison Op with a value holds
+ */
+template<class VT>
+struct CompareKernel
+{
+    template<class Op>
+    static size_t Count(const VT *ipData, size_t iSize, const VT &iExpected)
+    {
+        size_t count = 0;
+        for(size_t i = 0; i < iSize; i++)
+            count += Op::Scalar(ipData[i], iExpected);
+        return count;
+    }
+};
+
+template<>
+struct CompareKernel<float>
+{
+    template<class Op>
+    static size_t Count(const float *ipData, size_t iSize, const float &iExpected)
+    {
+        size_t count = 0;
+        size_t i = 0;
+#if defined(ESINTILER_AVX2)
+        __m256 expected = _mm256_set1_ps(iExpected);
+        while(i + 8 <= iSize)
+        {
+            size_t end = std::min(iSize - (iSize - i) % 8, i + (size_t)VectorLanes::BlockSize);
+            __m256i lanes = _mm256_setzero_si256();
+            for(; i < end; i += 8)
+                lanes = _mm256_sub_epi32(lanes, _mm256_castps_si256(Op::Avx(_mm256_loadu_ps(ipData + i), expected)));
+            count += VectorLanes::SumInt32(lanes);
+        }
+#elif defined(ESINTILER_SSE2)
+        __m128 expected = _mm_set1_ps(iExpected);
+        while(i + 4 <= iSize)
+        {
+            size_t end = std::min(iSize - (iSize - i) % 4, i + (size_t)VectorLanes::BlockSize);
+            __m128i lanes = _mm_setzero_si128();
+            for(; i < end; i += 4)
+                lanes = _mm_sub_epi32(lanes, _mm_castps_si128(Op::Sse(_mm_loadu_ps(ipData + i), expected)));
+            count += VectorLanes::SumInt32(lanes);
+        }
+#endif
+        for(; i < iSize; i++)
+            count += Op::Scalar(ipData[i], iExpected);
+        return count;
+    }
+};
+
+template<>
+struct CompareKernel<double>
+{
+    template<class Op>
+    static size_t Count(const double *ipData, size_t iSize, const double &iExpected)
+    {
+        size_t count = 0;
+        size_t i = 0;
+#if defined(ESINTILER_AVX2)
+        __m256d expected = _mm256_set1_pd(iExpected);
+        __m256i lanes = _mm256_setzero_si256();
+        for(; i + 4 <= iSize; i += 4)
+            lanes = _mm256_sub_epi64(lanes, _mm256_castpd_si256(Op::Avx(_mm256_loadu_pd(ipData + i), expected)));
+        count = VectorLanes::SumInt64(lanes);
+#elif defined(ESINTILER_SSE2)
+        __m128d expected = _mm_set1_pd(iExpected);
+        __m128i lanes = _mm_setzero_si128();
+        for(; i + 2 <= iSize; i += 2)
+            lanes = _mm_sub_epi64(lanes, _mm_castpd_si128(Op::Sse(_mm_loadu_pd(ipData + i), expected)));
+        count = VectorLanes::SumInt64(lanes);
+#endif
+        for(; i < iSize; i++)
+            count += Op::Scalar(ipData[i], iExpected);
+        return count;
+    }
+};
+
+/**
+ * Type the tolerances are computed in and the order of the values as integers. Adjacent
+ * floating point values have adjacent Ordered values, so their difference is the distance
+ * in units in the last place (ulps). +0 and -0 are the same.
+ */
+template<class VT>
+struct Precision
+{
+    typedef double Type;
+
+    static long long Ordered(const VT &iValue)
+    {
+        return (long long)iValue;
+    }
+};
+
+template<>
+struct Precision<float>
+{
+    typedef float Type;
+
+    static long long Ordered(const float &iValue)
+    {
+        int bits;
+        memcpy(&bits, &iValue, sizeof(bits));
+        return bits >= 0 ? bits : -(long long)(bits & 0x7fffffff);
+    }
+};
+
+template<>
+struct Precision<double>
+{
+    typedef double Type;
+
+    static long long Ordered(const double &iValue)
+    {
+        long long bits;
+        memcpy(&bits, &iValue, sizeof(bits));
+        return bits >= 0 ? bits : -(bits & 0x7fffffffffffffffLL);
+    }
+};
+
+/**
+ * Comparisons with a tolerance. They are NaN aware: NaN is close to NaN and to nothing 
+ * else, equal values (also infinities) are always close. An infinity is not close to any
+ * other value, whatever the tolerance.
+ *
+ * Close:  |value - expected| <= abs + rel * |expected|
+ * Ulps:   distance of the values in units in the last place
+ *
+ * The Count methods count the close elements of two arrays, float and double have vector
+ * versions of them.
+ */
+template<class VT>
+struct Tolerance
+{
+    static bool IsNaN(const VT &iValue)
+    {
+        return iValue != iValue;
+    }
+
+    static bool Close(const VT &iValue, const VT &iExpected, double iAbs, double iRel)
+    {
+        typedef typename Precision<VT>::Type T;
+        if(iValue == iExpected || (IsNaN(iValue) && IsNaN(iExpected)))
+            return true;
+        T value = (T)iValue;
+        T expected = (T)iExpected;
+        if(value - value != 0 || expected - expected != 0)
+            return false;   //infinite or NaN
+        T diff = value - expected;
+        return (diff < 0 ? -diff : diff) <= (T)iAbs + (T)iRel * (expected < 0 ? -expected : expected);
+    }
+
+    /**
+     * Distance in ulps, 0 if both are NaN and the largest value if only one of them is
+     */
+    static unsigned long long Ulps(const VT &iValue, const VT &iExpected)
+    {
+        if(IsNaN(iValue) || IsNaN(iExpected))
+            return IsNaN(iValue) && IsNaN(iExpected) ? 0 : ~0ULL;
+        long long value = Precision<VT>::Ordered(iValue);
+        long long expected = Precision<VT>::Ordered(iExpected);
+        return value >= expected ? (unsigned long long)value - expected : (unsigned long long)expected - value;
+    }
+
+    static size_t CountClose(const VT *ipData, const VT *ipExpected, size_t iSize, double iAbs, double iRel)
+    {
+        size_t count = 0;
+        for(size_t i = 0; i < iSize; i++)
+            count += Close(ipData[i], ipExpected[i], iAbs, iRel);
+        return count;
+    }
+
+    static size_t CountWithinUlps(const VT *ipData, const VT *ipExpected, size_t iSize, unsigned long long iUlps)
+    {
+        size_t count = 0;
+        for(size_t i = 0; i < iSize; i++)
+            count += Ulps(ipData[i], ipExpected[i]) <= iUlps;
+        return count;
+    }
+};
+
+/**
+ * Vector versions compare the Ordered values with 32 (float) or 64 (double) bit integer 
+ * arithmetic. The difference of two values which are not NaN can wrap around, but then 
+ * it is at least 2^24 (float) or 2^53 (double) ulps, so larger tolerances use the scalar
+ * loop. SSE2 has no 64 bit comparison, ulps of doubles need AVX2.
+ */
+template<>
+inline size_t Tolerance<float>::CountClose(const float *ipData, const float *ipExpected, size_t iSize, double iAbs, double iRel)
+{
+    size_t count = 0;
+    size_t i = 0;
+#if defined(ESINTILER_AVX2)
+    __m256 magnitude = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 infinity = _mm256_castsi256_ps(_mm256_set1_epi32(0x7f800000));
+    __m256 absTolerance = _mm256_set1_ps((float)iAbs);
+    __m256 relTolerance = _mm256_set1_ps((float)iRel);
+    while(i + 8 <= iSize)
+    {
+        size_t end = std::min(iSize - (iSize - i) % 8, i + (size_t)VectorLanes::BlockSize);
+        __m256i lanes = _mm256_setzero_si256();
+        for(; i < end; i += 8)
+        {
+            __m256 value = _mm256_loadu_ps(ipData + i);
+            __m256 expected = _mm256_loadu_ps(ipExpected + i);
+            __m256 diff = _mm256_and_ps(_mm256_sub_ps(value, expected), magnitude);
+            __m256 allowed = _mm256_add_ps(absTolerance, _mm256_mul_ps(relTolerance, _mm256_and_ps(expected, magnitude)));
+            __m256 finite = _mm256_and_ps(_mm256_cmp_ps(_mm256_and_ps(value, magnitude), infinity, _CMP_LT_OQ), 
+                _mm256_cmp_ps(_mm256_and_ps(expected, magnitude), infinity, _CMP_LT_OQ));
+            __m256 close = _mm256_or_ps(_mm256_and_ps(_mm256_cmp_ps(diff, allowed, _CMP_LE_OQ), finite), 
+                _mm256_cmp_ps(value, expected, _CMP_EQ_OQ));
+            close = _mm256_or_ps(close, _mm256_and_ps(_mm256_cmp_ps(value, value, _CMP_UNORD_Q), 
+                _mm256_cmp_ps(expected, expected, _CMP_UNORD_Q)));
+            lanes = _mm256_sub_epi32(lanes, _mm256_castps_si256(close));
+        }
+        count += VectorLanes::SumInt32(lanes);
+    }
+#elif defined(ESINTILER_SSE2)
+    __m128 magnitude = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 infinity = _mm_castsi128_ps(_mm_set1_epi32(0x7f800000));
+    __m128 absTolerance = _mm_set1_ps((float)iAbs);
+    __m128 relTolerance = _mm_set1_ps((float)iRel);
+    while(i + 4 <= iSize)
+    {
+        size_t end = std::min(iSize - (iSize - i) % 4, i + (size_t)VectorLanes::BlockSize);
+        __m128i lanes = _mm_setzero_si128();
+        for(; i < end; i += 4)
+        {
+            __m128 value = _mm_loadu_ps(ipData + i);
+            __m128 expected = _mm_loadu_ps(ipExpected + i);
+            __m128 diff = _mm_and_ps(_mm_sub_ps(value, expected), magnitude);
+            __m128 allowed = _mm_add_ps(absTolerance, _mm_mul_ps(relTolerance, _mm_and_ps(expected, magnitude)));
+            __m128 finite = _mm_and_ps(_mm_cmplt_ps(_mm_and_ps(value, magnitude), infinity), 
+                _mm_cmplt_ps(_mm_and_ps(expected, magnitude), infinity));
+            __m128 close = _mm_or_ps(_mm_and_ps(_mm_cmple_ps(diff, allowed), finite), _mm_cmpeq_ps(value, expected));
+            close = _mm_or_ps(close, _mm_and_ps(_mm_cmpunord_ps(value, value), _mm_cmpunord_ps(expected, expected)));
+            lanes = _mm_sub_epi32(lanes, _mm_castps_si128(close));
+        }
+        count += VectorLanes::SumInt32(lanes);
+    }
+#endif
+    for(; i < iSize; i++)
+        count += Close(ipData[i], ipExpected[i], iAbs, iRel);
+    return count;
+}
+
+template<>
+inline size_t Tolerance<float>::CountWithinUlps(const float *ipData, const float *ipExpected, size_t iSize, unsigned long long iUlps)
+{
+    size_t count = 0;
+    size_t i = 0;
+#if defined(ESINTILER_AVX2)
+    __m256i magnitude = _mm256_set1_epi32(0x7fffffff);
+    __m256i flip = _mm256_set1_epi32((int)0x80000000);
+    __m256i limit = _mm256_set1_epi32((int)(iUlps ^ 0x80000000));
+    __m256i ones = _mm256_set1_epi32(-1);
+    while(iUlps < (1 << 24) && i + 8 <= iSize)
+    {
+        size_t end = std::min(iSize - (iSize - i) % 8, i + (size_t)VectorLanes::BlockSize);
+        __m256i lanes = _mm256_setzero_si256();
+        for(; i < end; i += 8)
+        {
+            __m256 value = _mm256_loadu_ps(ipData + i);
+            __m256 expected = _mm256_loadu_ps(ipExpected + i);
+            __m256i bits = _mm256_castps_si256(value);
+            __m256i sign = _mm256_srai_epi32(bits, 31);
+            __m256i orderedValue = _mm256_sub_epi32(_mm256_xor_si256(_mm256_and_si256(bits, magnitude), sign), sign);
+            bits = _mm256_castps_si256(expected);
+            sign = _mm256_srai_epi32(bits, 31);
+            __m256i orderedExpected = _mm256_sub_epi32(_mm256_xor_si256(_mm256_and_si256(bits, magnitude), sign), sign);
+            __m256i diff = _mm256_sub_epi32(orderedValue, orderedExpected);
+            sign = _mm256_srai_epi32(diff, 31);
+            diff = _mm256_sub_epi32(_mm256_xor_si256(diff, sign), sign);
+            //unsigned comparison of the distance
+            __m256i far = _mm256_cmpgt_epi32(_mm256_xor_si256(diff, flip), limit);
+            __m256i nanValue = _mm256_castps_si256(_mm256_cmp_ps(value, value, _CMP_UNORD_Q));
+            __m256i nanExpected = _mm256_castps_si256(_mm256_cmp_ps(expected, expected, _CMP_UNORD_Q));
+            __m256i within = _mm256_andnot_si256(_mm256_or_si256(far, _mm256_or_si256(nanValue, nanExpected)), ones);
+            within = _mm256_or_si256(within, _mm256_and_si256(nanValue, nanExpected));
+            lanes = _mm256_sub_epi32(lanes, within);
+        }
+        count += VectorLanes::SumInt32(lanes);
+    }
+#elif defined(ESINTILER_SSE2)
+    __m128i magnitude = _mm_set1_epi32(0x7fffffff);
+    __m128i flip = _mm_set1_epi32((int)0x80000000);
+    __m128i limit = _mm_set1_epi32((int)(iUlps ^ 0x80000000));
+    __m128i ones = _mm_set1_epi32(-1);
+    while(iUlps < (1 << 24) && i + 4 <= iSize)
+    {
+        size_t end = std::min(iSize - (iSize - i) % 4, i + (size_t)VectorLanes::BlockSize);
+        __m128i lanes = _mm_setzero_si128();
+        for(; i < end; i += 4)
+        {
+            __m128 value = _mm_loadu_ps(ipData + i);
+            __m128 expected = _mm_loadu_ps(ipExpected + i);
+            __m128i bits = _mm_castps_si128(value);
+            __m128i sign = _mm_srai_epi32(bits, 31);
+            __m128i orderedValue = _mm_sub_epi32(_mm_xor_si128(_mm_and_si128(bits, magnitude), sign), sign);
+            bits = _mm_castps_si128(expected);
+            sign = _mm_srai_epi32(bits, 31);
+            __m128i orderedExpected = _mm_sub_epi32(_mm_xor_si128(_mm_and_si128(bits, magnitude), sign), sign);
+            __m128i diff = _mm_sub_epi32(orderedValue, orderedExpected);
+            sign = _mm_srai_epi32(diff, 31);
+            diff = _mm_sub_epi32(_mm_xor_si128(diff, sign), sign);
+            //unsigned comparison of the distance
+            __m128i far = _mm_cmpgt_epi32(_mm_xor_si128(diff, flip), limit);
+            __m128i nanValue = _mm_castps_si128(_mm_cmpunord_ps(value, value));
+            __m128i nanExpected = _mm_castps_si128(_mm_cmpunord_ps(expected, expected));
+            __m128i within = _mm_andnot_si128(_mm_or_si128(far, _mm_or_si128(nanValue, nanExpected)), ones);
+            within = _mm_or_si128(within, _mm_and_si128(nanValue, nanExpected));
+            lanes = _mm_sub_epi32(lanes, within);
+        }
+        count += VectorLanes::SumInt32(lanes);
+    }
+#endif
+    for(; i < iSize; i++)
+        count += Ulps(ipData[i], ipExpected[i]) <= iUlps;
+    return count;
+}
+
+template<>
+inline size_t Tolerance<double>::CountClose(const double *ipData, const double *ipExpected, size_t iSize, double iAbs, double iRel)
+{
+    size_t count = 0;
+    size_t i = 0;
+#if defined(ESINTILER_AVX2)
+    __m256d magnitude = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d infinity = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7ff0000000000000LL));
+    __m256d absTolerance = _mm256_set1_pd(iAbs);
+    __m256d relTolerance = _mm256_set1_pd(iRel);
+    __m256i lanes = _mm256_setzero_si256();
+    for(; i + 4 <= iSize; i += 4)
+    {
+        __m256d value = _mm256_loadu_pd(ipData + i);
+        __m256d expected = _mm256_loadu_pd(ipExpected + i);
+        __m256d diff = _mm256_and_pd(_mm256_sub_pd(value, expected), magnitude);
+        __m256d allowed = _mm256_add_pd(absTolerance, _mm256_mul_pd(relTolerance, _mm256_and_pd(expected, magnitude)));
+        __m256d finite = _mm256_and_pd(_mm256_cmp_pd(_mm256_and_pd(value, magnitude), infinity, _CMP_LT_OQ), 
+            _mm256_cmp_pd(_mm256_and_pd(expected, magnitude), infinity, _CMP_LT_OQ));
+        __m256d close = _mm256_or_pd(_mm256_and_pd(_mm256_cmp_pd(diff, allowed, _CMP_LE_OQ), finite), 
+            _mm256_cmp_pd(value, expected, _CMP_EQ_OQ));
+        close = _mm256_or_pd(close, _mm256_and_pd(_mm256_cmp_pd(value, value, _CMP_UNORD_Q), 
+            _mm256_cmp_pd(expected, expected, _CMP_UNORD_Q)));
+        lanes = _mm256_sub_epi64(lanes, _mm256_castpd_si256(close));
+    }
+    count = VectorLanes::SumInt64(lanes);
+#elif defined(ESINTILER_SSE2)
+    __m128d magnitude = _mm_castsi128_pd(_mm_set_epi32(0x7fffffff, -1, 0x7fffffff, -1));
+    __m128d infinity = _mm_castsi128_pd(_mm_set_epi32(0x7ff00000, 0, 0x7ff00000, 0));
+    __m128d absTolerance = _mm_set1_pd(iAbs);
+    __m128d relTolerance = _mm_set1_pd(iRel);
+    __m128i lanes = _mm_setzero_si128();
+    for(; i + 2 <= iSize; i += 2)
+    {
+        __m128d value = _mm_loadu_pd(ipData + i);
+        __m128d expected = _mm_loadu_pd(ipExpected + i);
+        __m128d diff = _mm_and_pd(_mm_sub_pd(value, expected), magnitude);
+        __m128d allowed = _mm_add_pd(absTolerance, _mm_mul_pd(relTolerance, _mm_and_pd(expected, magnitude)));
+        __m128d finite = _mm_and_pd(_mm_cmplt_pd(_mm_and_pd(value, magnitude), infinity), 
+            _mm_cmplt_pd(_mm_and_pd(expected, magnitude), infinity));
+        __m128d close = _mm_or_pd(_mm_and_pd(_mm_cmple_pd(diff, allowed), finite), _mm_cmpeq_pd(value, expected));
+        close = _mm_or_pd(close, _mm_and_pd(_mm_cmpunord_pd(value, value), _mm_cmpunord_pd(expected, expected)));
+        lanes = _mm_sub_epi64(lanes, _mm_castpd_si128(close));
+    }
+    count = VectorLanes::SumInt64(lanes);
+#endif
+    for(; i < iSize; i++)
+        count += Close(ipData[i], ipExpected[i], iAbs, iRel);
+    return count;
+}
+
+template<>
+inline size_t Tolerance<double>::CountWithinUlps(const double *ipData, const double *ipExpected, size_t iSize, unsigned long long iUlps)
+{
+    size_t count = 0;
+    size_t i = 0;
+#if defined(ESINTILER_AVX2)
+    if(iUlps < (1ULL << 53))
+    {
+        __m256i magnitude = _mm256_set1_epi64x(0x7fffffffffffffffLL);
+        __m256i flip = _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+        __m256i limit = _mm256_set1_epi64x((long long)(iUlps ^ 0x8000000000000000ULL));
+        __m256i zero = _mm256_setzero_si256();
+        __m256i ones = _mm256_set1_epi64x(-1);
+        __m256i lanes = _mm256_setzero_si256();
+        for(; i + 4 <= iSize; i += 4)
+        {
+            __m256d value = _mm256_loadu_pd(ipData + i);
+            __m256d expected = _mm256_loadu_pd(ipExpected + i);
+            __m256i bits = _mm256_castpd_si256(value);
+            __m256i sign = _mm256_cmpgt_epi64(zero, bits);
+            __m256i orderedValue = _mm256_sub_epi64(_mm256_xor_si256(_mm256_and_si256(bits, magnitude), sign), sign);
+            bits = _mm256_castpd_si256(expected);
+            sign = _mm256_cmpgt_epi64(zero, bits);
+            __m256i orderedExpected = _mm256_sub_epi64(_mm256_xor_si256(_mm256_and_si256(bits, magnitude), sign), sign);
+            __m256i diff = _mm256_sub_epi64(orderedValue, orderedExpected);
+            sign = _mm256_cmpgt_epi64(zero, diff);
+            diff = _mm256_sub_epi64(_mm256_xor_si256(diff, sign), sign);
+            //unsigned comparison of the distance
+            __m256i far = _mm256_cmpgt_epi64(_mm256_xor_si256(diff, flip), limit);
+            __m256i nanValue = _mm256_castpd_si256(_mm256_cmp_pd(value, value, _CMP_UNORD_Q));
+            __m256i nanExpected = _mm256_castpd_si256(_mm256_cmp_pd(expected, expected, _CMP_UNORD_Q));
+            __m256i within = _mm256_andnot_si256(_mm256_or_si256(far, _mm256_or_si256(nanValue, nanExpected)), ones);
+            within = _mm256_or_si256(within, _mm256_and_si256(nanValue, nanExpected));
+            lanes = _mm256_sub_epi64(lanes, within);
+        }
+        count = VectorLanes::SumInt64(lanes);
+    }
+#endif
+    for(; i < iSize; i++)
+        count += Ulps(ipData[i], ipExpected[i]) <= iUlps;
+    return count;
+}
+
+/**
+ * Measures of the tolerance checks of arrays, they describe the check and the error of 
+ * each element for the failure report of NumericSpan
+ */
+struct CloseTo
+{
+    CloseTo(double iAbs, double iRel) : abs(iAbs), rel(iRel) {}
+
+    std::string Describe() const
+    {
+        char pBuf[128];
+        sprintf_s(pBuf, "close to the expected values (abs %g, rel %g)", abs, rel);
+        return pBuf;
+    }
+
+    template<class VT>
+    bool Holds(const VT &iValue, const VT &iExpected) const
+    {
+        return Tolerance<VT>::Close(iValue, iExpected, abs, rel);
+    }
+
+    template<class VT>
+    size_t Count(const VT *ipData, const VT *ipExpected, size_t iSize) const
+    {
+        return Tolerance<VT>::CountClose(ipData, ipExpected, iSize, abs, rel);
+    }
+
+    /**
+     * Absolute error, NaN if only one of the values is NaN
+     */
+    template<class VT>
+    double Error(const VT &iValue, const VT &iExpected) const
+    {
+        if(Tolerance<VT>::IsNaN(iValue) || Tolerance<VT>::IsNaN(iExpected))
+            return Tolerance<VT>::IsNaN(iValue) && Tolerance<VT>::IsNaN(iExpected) ? 0 : std::numeric_limits<double>::quiet_NaN();
+        return iValue == iExpected ? 0 : fabs((double)iValue - (double)iExpected);
+    }
+
+    template<class VT>
+    double Allowed(const VT &iExpected) const
+    {
+        return abs + rel * fabs((double)iExpected);
+    }
+
+    double abs;
+    double rel;
+};
+
+struct WithinUlps
+{
+    WithinUlps(unsigned long long iUlps) : ulps(iUlps) {}
+
+    std::string Describe() const
+    {
+        char pBuf[128];
+        sprintf_s(pBuf, "within %.0f ulps of the expected values", (double)ulps);
+        return pBuf;
+    }
+
+    template<class VT>
+    bool Holds(const VT &iValue, const VT &iExpected) const
+    {
+        return Tolerance<VT>::Ulps(iValue, iExpected) <= ulps;
+    }
+
+    template<class VT>
+    size_t Count(const VT *ipData, const VT *ipExpected, size_t iSize) const
+    {
+        return Tolerance<VT>::CountWithinUlps(ipData, ipExpected, iSize, ulps);
+    }
+
+    /**
+     * Distance in ulps, NaN if only one of the values is NaN
+     */
+    template<class VT>
+    double Error(const VT &iValue, const VT &iExpected) const
+    {
+        unsigned long long distance = Tolerance<VT>::Ulps(iValue, iExpected);
+        return distance == ~0ULL ? std::numeric_limits<double>::quiet_NaN() : (double)distance;
+    }
+
+    template<class VT>
+    double Allowed(const VT &iExpected) const
+    {
+        return (double)ulps;
+    }
+
+    unsigned long long ulps;
+};
+
+/**
+ * Sorted index of candidate values for the membership checks (be_in). It is built once,
+ * the values are copied so the candidates may change afterwards, and answers each lookup
+ * with a branchless binary search. NaN is never a member, like with equal_to.
+ *
+    NumericSet<int> primes(pPrimes, numPrimes);   //e.g. a member of the suite
+    CHECK_THAT(value(x).should.be_in(primes));
+    CHECK_THAT(value(output).should.all.be_in(primes));
+ */
+template<class VT>
+class NumericSet
+{
+public:
+    NumericSet(const VT *ipValues, size_t iNum)
+        : m_values(ipValues, ipValues + iNum)
+    {
+        Build();
+    }
+
+    explicit NumericSet(const std::vector<VT> &iValues)
+        : m_values(iValues)
+    {
+        Build();
+    }
+
+    size_t Size() const
+    {
+        return m_values.size();
+    }
+
+    bool Contains(const VT &iValue) const
+    {
+        if(m_values.empty())
+            return false;
+        const VT *pBase = &m_values[0];
+        for(size_t num = m_values.size(); num > 1; num -= num / 2)
+            pBase = pBase[num / 2] <= iValue ? pBase + num / 2 : pBase;
+        return *pBase == iValue;
+    }
+
+    /**
+     * Counts the elements of an array which are members. Four searches are interleaved
+     * so the loads of large sets, which mostly miss the cache, overlap.
+     */
+    size_t Count(const VT *ipData, size_t iSize) const
+    {
+        if(m_values.empty())
+            return 0;
+        size_t count = 0;
+        size_t blocked = iSize - iSize % 4;
+        size_t i = 0;
+        for(; i < blocked; i += 4)
+        {
+            const VT *pBase[4] = { &m_values[0], &m_values[0], &m_values[0], &m_values[0] };
+            for(size_t num = m_values.size(); num > 1; num -= num / 2)
+                for(int j = 0; j < 4; j++)
+                    pBase[j] = pBase[j][num / 2] <= ipData[i + j] ? pBase[j] + num / 2 : pBase[j];
+            for(int j = 0; j < 4; j++)
+                count += *pBase[j] == ipData[i + j];
+        }
+        for(; i < iSize; i++)
+            count += Contains(ipData[i]);
+        return count;
+    }
+
+private:
+    void Build()
+    {
+        m_values.erase(std::remove_if(m_values.begin(), m_values.end(), IsNaN), m_values.end());
+        std::sort(m_values.begin(), m_values.end());
+        m_values.erase(std::unique(m_values.begin(), m_values.end()), m_values.end());
+    }
+
+    static bool IsNaN(const VT &iValue)
+    {
+        return iValue != iValue;
+    }
+
+    std::vector<VT> m_values;
+};
+
+}; //namespace
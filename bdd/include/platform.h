@@ -0,0 +1,948 @@
+/**
+ * Thin platform layer used by the test manager. It wraps the few operating system
+ * services the runner needs (threads, locks, child processes) so suite.h can stay free of
+ * #ifdef blocks. Win32 is the primary target, the POSIX branch is provided so the
+ * framework can also be used with gcc/clang.
+ *
+ * Everything is defined inline in this header, there is nothing to link.
+ */
+#pragma once
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+    #include <process.h>
+    #include <io.h>
+#else
+    #include <pthread.h>
+    #include <unistd.h>
+    #include <poll.h>
+    #include <sys/types.h>
+    #include <sys/wait.h>
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <errno.h>
+    #include <time.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <vector>
+
+/**
+ * Storage class for the variables which needs a separate instance per thread. It can be
+ * used for namespace scope and static member variables of POD types
+ */
+#ifdef _MSC_VER
+    #define ESINTILER_THREAD_LOCAL __declspec(thread)
+#else
+    #define ESINTILER_THREAD_LOCAL __thread
+#endif
+
+/**
+ * Function attribute for the rarely executed paths, e.g. handling of a failed assertion.
+ * Keeping them out of line leaves the passing path of a check small enough to be inlined
+ * into tight loops. ESINTILER_LIKELY/UNLIKELY tell the compiler which way a branch usually goes.
+ */
+#ifdef _MSC_VER
+    #define ESINTILER_COLD __declspec(noinline)
+    #define ESINTILER_UNLIKELY(condition) (condition)
+    #define ESINTILER_LIKELY(condition) (condition)
+#else
+    #define ESINTILER_COLD __attribute__((noinline, cold))
+    #define ESINTILER_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+    #define ESINTILER_LIKELY(condition) __builtin_expect(!!(condition), 1)
+#endif
+
+/**
+ * Vector instruction sets the compiler may use. SSE2 is always there on x64 and with 
+ * /arch:SSE2, AVX2 only when the compiler is told to target it (/arch:AVX2, -mavx2).
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define ESINTILER_SSE2
+#endif
+#if defined(__AVX2__)
+    #define ESINTILER_AVX2
+#endif
+
+/**
+ * sprintf_s is only provided by the Microsoft runtime, we map the array form of it for
+ * other compilers so the same code can be compiled everywhere.
+ */
+#ifndef _MSC_VER
+    #define sprintf_s(buffer, ...) snprintf(buffer, sizeof(buffer), __VA_ARGS__)
+#endif
+
+namespace esintiler
+{
+
+namespace platform
+{
+
+/**
+ * Number of processors available to the application. It is used as the default number
+ * of workers when parallel execution is requested without an explicit count.
+ */
+inline int CpuCount()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long num = sysconf(_SC_NPROCESSORS_ONLN);
+    return num > 0 ? (int)num : 1;
+#endif
+}
+
+/**
+ * Monotonic clock in seconds, only the difference of two calls is meaningful
+ */
+inline double Now()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency = {0};
+    if(frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+#endif
+}
+
+/**
+ * CPU time used by the process since it was started (user and system) in seconds. Read at
+ * the start of main it is the cost of loading the application and its static objects.
+ */
+inline double ProcessCpuTime()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if(!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return 0;
+    ULARGE_INTEGER kernelTime, userTime;
+    kernelTime.LowPart = kernel.dwLowDateTime;
+    kernelTime.HighPart = kernel.dwHighDateTime;
+    userTime.LowPart = user.dwLowDateTime;
+    userTime.HighPart = user.dwHighDateTime;
+    return (double)(kernelTime.QuadPart + userTime.QuadPart) * 1e-7;
+#else
+    timespec used;
+    if(clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &used) != 0)
+        return 0;
+    return (double)used.tv_sec + (double)used.tv_nsec * 1e-9;
+#endif
+}
+
+/**
+ * fopen without the deprecation warnings of the Microsoft runtime, returns NULL on error
+ */
+inline FILE* OpenFile(const char *ipPath, const char *ipMode)
+{
+#ifdef _MSC_VER
+    FILE *pFile = 0;
+    if(fopen_s(&pFile, ipPath, ipMode) != 0)
+        return 0;
+    return pFile;
+#else
+    return fopen(ipPath, ipMode);
+#endif
+}
+
+/**
+ * Suspends the calling thread for the given time
+ */
+inline void Sleep(double iSeconds)
+{
+#ifdef _WIN32
+    ::Sleep((DWORD)(iSeconds * 1000));
+#else
+    timespec duration;
+    duration.tv_sec = (time_t)iSeconds;
+    duration.tv_nsec = (long)((iSeconds - (double)duration.tv_sec) * 1e9);
+    while(nanosleep(&duration, &duration) < 0 && errno == EINTR) {}
+#endif
+}
+
+inline int ProcessId()
+{
+#ifdef _WIN32
+    return (int)GetCurrentProcessId();
+#else
+    return (int)getpid();
+#endif
+}
+
+/**
+ * Atomic operations on a long, all of them are full barriers except the load (acquire)
+ * and the store (release)
+ */
+inline long AtomicAdd(volatile long *ioValue, long iDelta)
+{
+#ifdef _WIN32
+    return InterlockedExchangeAdd(ioValue, iDelta) + iDelta;
+#else
+    return __sync_add_and_fetch(ioValue, iDelta);
+#endif
+}
+
+/**
+ * Sets the value to iNew if it is iExpected, returns true if it is set
+ */
+inline bool AtomicCompareExchange(volatile long *ioValue, long iExpected, long iNew)
+{
+#ifdef _WIN32
+    return InterlockedCompareExchange(ioValue, iNew, iExpected) == iExpected;
+#else
+    return __sync_bool_compare_and_swap(ioValue, iExpected, iNew);
+#endif
+}
+
+inline long AtomicExchange(volatile long *ioValue, long iNew)
+{
+#ifdef _WIN32
+    return InterlockedExchange(ioValue, iNew);
+#else
+    return __sync_lock_test_and_set(ioValue, iNew);
+#endif
+}
+
+inline long AtomicLoad(const volatile long *ipValue)
+{
+#if defined(_WIN32)
+    return *ipValue;    //volatile reads have acquire semantics in Visual C++
+#elif defined(__ATOMIC_ACQUIRE)
+    return __atomic_load_n(ipValue, __ATOMIC_ACQUIRE);
+#else
+    long value = *ipValue;
+    __sync_synchronize();
+    return value;
+#endif
+}
+
+inline void AtomicStore(volatile long *ioValue, long iValue)
+{
+#if defined(_WIN32)
+    *ioValue = iValue;  //volatile writes have release semantics in Visual C++
+#elif defined(__ATOMIC_RELEASE)
+    __atomic_store_n(ioValue, iValue, __ATOMIC_RELEASE);
+#else
+    __sync_synchronize();
+    *ioValue = iValue;
+#endif
+}
+
+/**
+ * A simple non recursive mutex
+ */
+class Mutex
+{
+public:
+#ifdef _WIN32
+    Mutex()         { InitializeCriticalSection(&m_cs); }
+    ~Mutex()        { DeleteCriticalSection(&m_cs); }
+    void Lock()     { EnterCriticalSection(&m_cs); }
+    void Unlock()   { LeaveCriticalSection(&m_cs); }
+private:
+    CRITICAL_SECTION m_cs;
+#else
+    Mutex()         { pthread_mutex_init(&m_mutex, 0); }
+    ~Mutex()        { pthread_mutex_destroy(&m_mutex); }
+    void Lock()     { pthread_mutex_lock(&m_mutex); }
+    void Unlock()   { pthread_mutex_unlock(&m_mutex); }
+private:
+    pthread_mutex_t m_mutex;
+#endif
+    Mutex(const Mutex&);
+    Mutex& operator=(const Mutex&);
+};
+
+/**
+ * Locks the given mutex for the life time of the object
+ */
+class ScopedLock
+{
+public:
+    ScopedLock(Mutex &iMutex) : m_mutex(iMutex) { m_mutex.Lock(); }
+    ~ScopedLock() { m_mutex.Unlock(); }
+private:
+    Mutex &m_mutex;
+    ScopedLock(const ScopedLock&);
+    ScopedLock& operator=(const ScopedLock&);
+};
+
+/**
+ * Manual reset event. One thread waits until the other one sets the signal, once set
+ * it stays set so late waiters return immediately.
+ */
+class Signal
+{
+public:
+#ifdef _WIN32
+    Signal()    { m_event = CreateEvent(0, TRUE, FALSE, 0); }
+    ~Signal()   { CloseHandle(m_event); }
+    void Set()  { SetEvent(m_event); }
+    void Wait() { WaitForSingleObject(m_event, INFINITE); }
+    bool Wait(double iSeconds) 
+    { 
+        return WaitForSingleObject(m_event, (DWORD)(iSeconds * 1000)) == WAIT_OBJECT_0; 
+    }
+private:
+    HANDLE m_event;
+#else
+    Signal() : m_set(false)
+    {
+        pthread_mutex_init(&m_mutex, 0);
+        pthread_cond_init(&m_cond, 0);
+    }
+    ~Signal()
+    {
+        pthread_cond_destroy(&m_cond);
+        pthread_mutex_destroy(&m_mutex);
+    }
+    void Set()
+    {
+        pthread_mutex_lock(&m_mutex);
+        m_set = true;
+        pthread_cond_broadcast(&m_cond);
+        pthread_mutex_unlock(&m_mutex);
+    }
+    void Wait()
+    {
+        pthread_mutex_lock(&m_mutex);
+        while(!m_set)
+            pthread_cond_wait(&m_cond, &m_mutex);
+        pthread_mutex_unlock(&m_mutex);
+    }
+    /**
+     * Waits at most the given time, returns true if the signal is set
+     */
+    bool Wait(double iSeconds)
+    {
+        timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        long nsec = until.tv_nsec + (long)((iSeconds - (long)iSeconds) * 1e9);
+        until.tv_sec += (time_t)iSeconds + nsec / 1000000000L;
+        until.tv_nsec = nsec % 1000000000L;
+
+        pthread_mutex_lock(&m_mutex);
+        int error = 0;
+        while(!m_set && error != ETIMEDOUT)
+            error = pthread_cond_timedwait(&m_cond, &m_mutex, &until);
+        bool set = m_set;
+        pthread_mutex_unlock(&m_mutex);
+        return set;
+    }
+private:
+    pthread_mutex_t m_mutex;
+    pthread_cond_t  m_cond;
+    bool            m_set;
+#endif
+    Signal(const Signal&);
+    Signal& operator=(const Signal&);
+};
+
+/**
+ * Releases the waiting threads all together once the given number of them arrived. 
+ * Waiters spin so they are released as close to each other as possible, they start 
+ * yielding the processor if it takes long. It can be used again for the next round.
+ */
+class Barrier
+{
+public:
+    Barrier(long iCount) : m_count(iCount), m_waiting(0), m_round(0) {}
+
+    void Wait()
+    {
+        long round = AtomicLoad(&m_round);
+        if(Arrive())
+            return;
+        for(long spins = 0; AtomicLoad(&m_round) == round; spins++)
+            if(spins > 10000)
+                Sleep(0);
+    }
+
+    /**
+     * Counts the caller without waiting, returns true if it released the others
+     */
+    bool Arrive()
+    {
+        if(AtomicAdd(&m_waiting, 1) != m_count)
+            return false;
+        AtomicStore(&m_waiting, 0);
+        AtomicAdd(&m_round, 1);
+        return true;
+    }
+
+private:
+    long            m_count;
+    volatile long   m_waiting;
+    volatile long   m_round;
+};
+
+/**
+ * Auto reset event. Set() wakes up a single waiter, or the next one if nobody is waiting.
+ */
+class Event
+{
+public:
+#ifdef _WIN32
+    Event()     { m_event = CreateEvent(0, FALSE, FALSE, 0); }
+    ~Event()    { CloseHandle(m_event); }
+    void Set()  { SetEvent(m_event); }
+    bool Wait(double iSeconds) 
+    { 
+        return WaitForSingleObject(m_event, (DWORD)(iSeconds * 1000)) == WAIT_OBJECT_0; 
+    }
+private:
+    HANDLE m_event;
+#else
+    Event() : m_set(false)
+    {
+        pthread_mutex_init(&m_mutex, 0);
+        pthread_cond_init(&m_cond, 0);
+    }
+    ~Event()
+    {
+        pthread_cond_destroy(&m_cond);
+        pthread_mutex_destroy(&m_mutex);
+    }
+    void Set()
+    {
+        pthread_mutex_lock(&m_mutex);
+        m_set = true;
+        pthread_cond_signal(&m_cond);
+        pthread_mutex_unlock(&m_mutex);
+    }
+    /**
+     * Waits at most the given time, returns true if the event is set
+     */
+    bool Wait(double iSeconds)
+    {
+        timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        long nsec = until.tv_nsec + (long)((iSeconds - (long)iSeconds) * 1e9);
+        until.tv_sec += (time_t)iSeconds + nsec / 1000000000L;
+        until.tv_nsec = nsec % 1000000000L;
+
+        pthread_mutex_lock(&m_mutex);
+        int error = 0;
+        while(!m_set && error != ETIMEDOUT)
+            error = pthread_cond_timedwait(&m_cond, &m_mutex, &until);
+        bool set = m_set;
+        m_set = false;
+        pthread_mutex_unlock(&m_mutex);
+        return set;
+    }
+private:
+    pthread_mutex_t m_mutex;
+    pthread_cond_t  m_cond;
+    bool            m_set;
+#endif
+    Event(const Event&);
+    Event& operator=(const Event&);
+};
+
+/**
+ * Minimal thread object. Derived classes implement Run() which is executed on a new
+ * thread after Start() is called. Join() must be called before the object is destroyed.
+ */
+class Thread
+{
+public:
+    Thread() : m_started(false) {}
+    virtual ~Thread() {}
+
+    virtual void Run() = 0;
+
+    bool Start()
+    {
+#ifdef _WIN32
+        m_handle = (HANDLE)_beginthreadex(0, 0, &Thread::Entry, this, 0, 0);
+        m_started = m_handle != 0;
+#else
+        m_started = pthread_create(&m_thread, 0, &Thread::Entry, this) == 0;
+#endif
+        return m_started;
+    }
+
+    void Join()
+    {
+        if(!m_started)
+            return;
+#ifdef _WIN32
+        WaitForSingleObject(m_handle, INFINITE);
+        CloseHandle(m_handle);
+#else
+        pthread_join(m_thread, 0);
+#endif
+        m_started = false;
+    }
+
+private:
+#ifdef _WIN32
+    static unsigned __stdcall Entry(void *ipThread)
+    {
+        ((Thread*)ipThread)->Run();
+        return 0;
+    }
+    HANDLE m_handle;
+#else
+    static void* Entry(void *ipThread)
+    {
+        ((Thread*)ipThread)->Run();
+        return 0;
+    }
+    pthread_t m_thread;
+#endif
+    bool m_started;
+
+    Thread(const Thread&);
+    Thread& operator=(const Thread&);
+};
+
+/**
+ * Child process created by forking the current one, connected to the parent with two 
+ * pipes. Fork is not available on Win32 so Start() always fails there, callers are 
+ * expected to fall back to in process execution (see HasFork).
+ */
+#ifdef _WIN32
+const bool HasFork = false;
+#else
+const bool HasFork = true;
+#endif
+
+class ChildProcess
+{
+public:
+    /**
+     * Entry point of the child, it receives the pipe ends to read the commands of the parent
+     * and to write its output. Its return value is used as the exit code of the child
+     */
+    typedef int (*MainFunction)(int iInput, int iOutput, void *ipData);
+
+    ChildProcess() : m_pid(-1), m_input(-1), m_output(-1) {}
+
+    /**
+     * Forks the process, ipMain is executed in the child and the child exits when it 
+     * returns. It returns true in the parent if the child is created.
+     */
+    bool Start(MainFunction ipMain, void *ipData)
+    {
+#ifdef _WIN32
+        return false;
+#else
+        int toChild[2];
+        int fromChild[2];
+        if(pipe(toChild) != 0)
+            return false;
+        if(pipe(fromChild) != 0)
+        {
+            close(toChild[0]);
+            close(toChild[1]);
+            return false;
+        }
+        //Pending output would be written by both processes otherwise
+        fflush(0);
+        pid_t pid = fork();
+        if(pid < 0)
+        {
+            close(toChild[0]); close(toChild[1]);
+            close(fromChild[0]); close(fromChild[1]);
+            return false;
+        }
+        if(pid == 0)
+        {
+            close(toChild[1]);
+            close(fromChild[0]);
+            int retVal = ipMain(toChild[0], fromChild[1], ipData);
+            fflush(0);
+            _exit(retVal);
+        }
+        close(toChild[0]);
+        close(fromChild[1]);
+        m_pid = pid;
+        m_input = fromChild[0];
+        m_output = toChild[1];
+        return true;
+#endif
+    }
+
+    /**
+     * Pipe end to read the output of the child
+     */
+    int Input() const { return m_input; }
+
+    /**
+     * Pipe end to send commands to the child
+     */
+    int Output() const { return m_output; }
+
+    bool Running() const { return m_pid > 0; }
+
+    /**
+     * Closes the pipes and waits for the child to exit
+     *
+     * @oStatus: Filled with a short description of how the child exited
+     * @return: true if child exited normally with 0 exit code
+     */
+    bool Wait(char *oStatus = 0, size_t iSize = 0)
+    {
+        Close();
+        if(m_pid <= 0)
+            return true;
+#ifdef _WIN32
+        return true;
+#else
+        int status = 0;
+        while(waitpid(m_pid, &status, 0) < 0 && errno == EINTR) {}
+        m_pid = -1;
+        if(oStatus && iSize)
+        {
+            if(WIFSIGNALED(status))
+                snprintf(oStatus, iSize, "signal %i", WTERMSIG(status));
+            else
+                snprintf(oStatus, iSize, "exit code %i", WEXITSTATUS(status));
+        }
+        return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#endif
+    }
+
+    /**
+     * Terminates the child, Wait() still needs to be called
+     */
+    void Kill()
+    {
+#ifndef _WIN32
+        if(m_pid > 0)
+            kill(m_pid, SIGKILL);
+#endif
+    }
+
+    /**
+     * Closes the pipes to the child, a child waiting for commands will see the end of 
+     * input and exit
+     */
+    void Close()
+    {
+#ifndef _WIN32
+        if(m_input >= 0)
+            close(m_input);
+        if(m_output >= 0)
+            close(m_output);
+#endif
+        m_input = -1;
+        m_output = -1;
+    }
+
+private:
+    int m_pid;
+    int m_input;
+    int m_output;
+};
+
+/**
+ * Writes all the data to the given file descriptor, returns false on error
+ */
+inline bool WriteAll(int iFile, const char *ipData, size_t iSize)
+{
+#ifdef _WIN32
+    while(iSize > 0)
+    {
+        int written = _write(iFile, ipData, (unsigned int)iSize);
+        if(written < 0)
+            return false;
+        ipData += written;
+        iSize -= written;
+    }
+    return true;
+#else
+    while(iSize > 0)
+    {
+        ssize_t written = write(iFile, ipData, iSize);
+        if(written < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            return false;
+        }
+        ipData += written;
+        iSize -= written;
+    }
+    return true;
+#endif
+}
+
+/**
+ * Reads exactly iSize bytes, returns false if the file is closed or on error
+ */
+inline bool ReadAll(int iFile, char *opData, size_t iSize)
+{
+#ifdef _WIN32
+    return false;
+#else
+    while(iSize > 0)
+    {
+        ssize_t numRead = read(iFile, opData, iSize);
+        if(numRead < 0 && errno == EINTR)
+            continue;
+        if(numRead <= 0)
+            return false;
+        opData += numRead;
+        iSize -= numRead;
+    }
+    return true;
+#endif
+}
+
+/**
+ * Reads whatever is available up to iSize bytes, blocks if nothing is available. 
+ * Returns the number of bytes read, 0 on end of file and negative on error
+ */
+inline int ReadSome(int iFile, char *opData, size_t iSize)
+{
+#ifdef _WIN32
+    return -1;
+#else
+    for(;;)
+    {
+        ssize_t numRead = read(iFile, opData, iSize);
+        if(numRead < 0 && errno == EINTR)
+            continue;
+        return (int)numRead;
+    }
+#endif
+}
+
+/**
+ * Waits until at least one of the given files is readable or closed by the other end
+ *
+ * @iTimeout: in milliseconds, negative to wait forever
+ * @oReady: indices (in iFiles) of the files which can be read without blocking
+ */
+inline void WaitReadable(const std::vector<int> &iFiles, int iTimeout, std::vector<int> &oReady)
+{
+    oReady.clear();
+#ifndef _WIN32
+    std::vector<pollfd> fds(iFiles.size());
+    for(unsigned int i = 0; i < iFiles.size(); i++)
+    {
+        fds[i].fd = iFiles[i];
+        fds[i].events = POLLIN;
+        fds[i].revents = 0;
+    }
+    if(fds.empty() || poll(&fds[0], fds.size(), iTimeout) <= 0)
+        return;
+    for(unsigned int i = 0; i < fds.size(); i++)
+        if(fds[i].revents != 0)
+            oReady.push_back(i);
+#endif
+}
+
+/**
+ * Ignores SIGPIPE for the life time of the object so writing to a crashed child returns 
+ * an error instead of terminating the parent
+ */
+class IgnoreBrokenPipe
+{
+public:
+#ifdef _WIN32
+    IgnoreBrokenPipe() {}
+#else
+    IgnoreBrokenPipe() { m_previous = signal(SIGPIPE, SIG_IGN); }
+    ~IgnoreBrokenPipe() { signal(SIGPIPE, m_previous); }
+private:
+    void (*m_previous)(int);
+#endif
+};
+
+/**
+ * File written through a shared memory mapping. What is written to the mapping is kept 
+ * by the operating system even if the process crashes. Mapping can be grown, the file 
+ * is cut to the used size when it is closed.
+ */
+class MappedFile
+{
+public:
+#ifdef _WIN32
+    MappedFile() : m_file(INVALID_HANDLE_VALUE), m_mapping(0), m_data(0), m_capacity(0) {}
+#else
+    MappedFile() : m_file(-1), m_data(0), m_capacity(0) {}
+#endif
+
+    /**
+     * Keeps the whole mapped capacity if Close is not called
+     */
+    ~MappedFile()
+    {
+        Close(m_capacity);
+    }
+
+    /**
+     * Creates (or truncates) the file and maps the given number of bytes of it
+     */
+    bool Open(const char *ipPath, size_t iCapacity)
+    {
+#ifdef _WIN32
+        m_file = CreateFileA(ipPath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, 0, 
+            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+        if(m_file == INVALID_HANDLE_VALUE)
+            return false;
+#else
+        m_file = open(ipPath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if(m_file < 0)
+            return false;
+#endif
+        return Map(iCapacity);
+    }
+
+    /**
+     * Maps a larger part of the file, content is kept but Data() may change
+     */
+    bool Grow(size_t iCapacity)
+    {
+        Unmap();
+        return Map(iCapacity);
+    }
+
+    /**
+     * Unmaps and closes the file, keeping only the first iSize bytes of it
+     */
+    void Close(size_t iSize)
+    {
+        Unmap();
+#ifdef _WIN32
+        if(m_file == INVALID_HANDLE_VALUE)
+            return;
+        SetFilePointer(m_file, (LONG)iSize, 0, FILE_BEGIN);
+        SetEndOfFile(m_file);
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if(m_file < 0)
+            return;
+        //if it fails the file keeps the mapped size, readers stop at the first empty record
+        int error = ftruncate(m_file, (off_t)iSize);
+        (void)error;
+        close(m_file);
+        m_file = -1;
+#endif
+    }
+
+    char* Data()
+    {
+        return m_data;
+    }
+
+    size_t Capacity() const
+    {
+        return m_capacity;
+    }
+
+private:
+    bool Map(size_t iCapacity)
+    {
+#ifdef _WIN32
+        m_mapping = CreateFileMappingA(m_file, 0, PAGE_READWRITE, 
+            (DWORD)((unsigned __int64)iCapacity >> 32), (DWORD)iCapacity, 0);
+        if(!m_mapping)
+            return false;
+        m_data = (char*)MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, iCapacity);
+#else
+        if(ftruncate(m_file, (off_t)iCapacity) != 0)
+            return false;
+        void *pData = mmap(0, iCapacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+        m_data = pData == MAP_FAILED ? 0 : (char*)pData;
+#endif
+        m_capacity = m_data ? iCapacity : 0;
+        return m_data != 0;
+    }
+
+    void Unmap()
+    {
+#ifdef _WIN32
+        if(m_data)
+            UnmapViewOfFile(m_data);
+        if(m_mapping)
+            CloseHandle(m_mapping);
+        m_mapping = 0;
+#else
+        if(m_data)
+            munmap(m_data, m_capacity);
+#endif
+        m_data = 0;
+    }
+
+#ifdef _WIN32
+    HANDLE  m_file;
+    HANDLE  m_mapping;
+#else
+    int     m_file;
+#endif
+    char   *m_data;
+    size_t  m_capacity;
+
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
+
+/**
+ * Function called when the process crashes, before it is terminated
+ */
+typedef void (*CrashHandler)();
+
+inline CrashHandler& CurrentCrashHandler()
+{
+    static CrashHandler handler = 0;
+    return handler;
+}
+
+inline void CrashSignal(int iSignal)
+{
+    if(CurrentCrashHandler())
+        CurrentCrashHandler()();
+    //Terminate with the same signal so the parent sees the actual reason
+    signal(iSignal, SIG_DFL);
+    raise(iSignal);
+}
+
+#ifdef _WIN32
+inline LONG WINAPI CrashFilter(EXCEPTION_POINTERS *ipException)
+{
+    if(CurrentCrashHandler())
+        CurrentCrashHandler()();
+    return EXCEPTION_CONTINUE_SEARCH;
+}
+#endif
+
+/**
+ * Installs the handler for the fatal signals (and unhandled exceptions on Win32). Only 
+ * one handler is supported, a new one replaces the previous. The handler should only 
+ * use functions which are safe to call from a signal handler.
+ */
+inline void OnCrash(CrashHandler ipHandler)
+{
+    CurrentCrashHandler() = ipHandler;
+    signal(SIGABRT, &CrashSignal);
+    signal(SIGSEGV, &CrashSignal);
+    signal(SIGFPE, &CrashSignal);
+    signal(SIGILL, &CrashSignal);
+#ifdef _WIN32
+    SetUnhandledExceptionFilter(&CrashFilter);
+#else
+    signal(SIGBUS, &CrashSignal);
+#endif
+}
+
+}; //namespace platform
+
+}; //namespace
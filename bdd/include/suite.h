@@ -30,6 +30,12 @@
             CHECK_THAT(true);
             CHECK_THAT(false);
         }
+
+        //Benchmark Methods, body is repeated and timed by the runner
+        BENCHMARK(ShouldBeFast)
+        {
+            DoSomething();
+        }
     };
 
 
@@ -45,13 +51,182 @@
  */
 #pragma once
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
 #include <vector>
+#include <deque>
 #include <map>
+#include <set>
 #include <string>
 
+#include "platform.h"
+
 namespace esintiler 
 {
 
+/**
+ * Phases of the execution which are timed and passed to Logger::timing
+ */
+enum TimingPhase
+{
+    PhaseConstruct,     //Construct of a suite instance
+    PhaseSetUp,
+    PhaseExecute,       //the test method itself
+    PhaseTearDown,
+    PhaseDestruct,      //Destruct of a suite instance
+    PhaseTest,          //SetUp, Execute and TearDown of a test
+    PhaseSuite          //the whole suite with all its instances
+};
+
+/**
+ * A suite (test is empty) or a test with its duration in seconds
+ */
+struct TimingEntry
+{
+    TimingEntry(const std::string &iSuite = "", const std::string &iTest = "", double iSeconds = 0)
+        : suite(iSuite), test(iTest), seconds(iSeconds) {}
+
+    //Slowest first, ties are ordered by name so the report is stable
+    bool operator<(const TimingEntry &iOther) const
+    {
+        if(seconds != iOther.seconds)
+            return seconds > iOther.seconds;
+        if(suite != iOther.suite)
+            return suite < iOther.suite;
+        return test < iOther.test;
+    }
+
+    std::string suite;
+    std::string test;
+    double      seconds;
+};
+
+/**
+ * Totals of a run which are passed to Logger::summary at the end of the run
+ */
+struct RunSummary
+{
+    RunSummary() : retVal(0), numTests(0), numAssertions(0), numFailedAssertions(0), seconds(0) {}
+
+    int                         retVal;
+    int                         numTests;
+    int                         numAssertions;
+    int                         numFailedAssertions;
+    double                      seconds;        //wall time of the run
+    std::vector<TimingEntry>    slowestTests;   //slowest first
+    std::vector<TimingEntry>    slowestSuites;
+};
+
+/**
+ * Samples of a benchmark and their statistics, all durations are in seconds per iteration
+ */
+struct BenchmarkResult
+{
+    BenchmarkResult() : iterations(0), min(0), median(0), p99(0), mean(0), stddev(0) {}
+
+    /**
+     * Calculates the statistics from the samples
+     */
+    void Compute()
+    {
+        min = median = p99 = mean = stddev = 0;
+        size_t n = samples.size();
+        if(n == 0)
+            return;
+
+        std::vector<double> sorted(samples);
+        std::sort(sorted.begin(), sorted.end());
+        min = sorted[0];
+        median = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+        //nearest rank
+        size_t rank = (size_t)ceil(0.99 * n);
+        p99 = sorted[rank > 0 ? rank - 1 : 0];
+
+        for(size_t i = 0; i < n; i++)
+            mean += sorted[i];
+        mean /= n;
+        if(n > 1)
+        {
+            double sum = 0;
+            for(size_t i = 0; i < n; i++)
+                sum += (sorted[i] - mean) * (sorted[i] - mean);
+            stddev = sqrt(sum / (n - 1));
+        }
+    }
+
+    /**
+     * Duration with a unit which keeps it readable, from nanoseconds to seconds
+     */
+    static std::string Format(double iSeconds)
+    {
+        char pBuf[64];
+        if(iSeconds < 1e-6)
+            sprintf_s(pBuf, "%.2f ns", iSeconds * 1e9);
+        else if(iSeconds < 1e-3)
+            sprintf_s(pBuf, "%.2f us", iSeconds * 1e6);
+        else if(iSeconds < 1)
+            sprintf_s(pBuf, "%.2f ms", iSeconds * 1e3);
+        else
+            sprintf_s(pBuf, "%.2f s", iSeconds);
+        return pBuf;
+    }
+
+    std::string         suite;
+    std::string         test;
+    long                iterations;     //number of iterations in each sample
+    std::vector<double> samples;
+    double              min;
+    double              median;
+    double              p99;
+    double              mean;
+    double              stddev;
+};
+
+/**
+ * A failed assertion. Strings are not copied: statement and file are literals, message,
+ * suite and test live at least until the logger returns. Loggers which keep the record
+ * for later should copy them.
+ */
+struct FailureRecord
+{
+    const char *statement;  //source text of CHECK_THAT/ASSERT_THAT, 0 for CHECK/ASSERT
+    const char *message;    //optional message of CHECK/ASSERT, 0 if there is none
+    const char *file;
+    int         line;
+    const char *suite;
+    const char *test;
+};
+
+/**
+ * Copy of a statement or a file name which lives until the end of the program. Failures 
+ * received from another process or read from a file use it to keep the literals of the 
+ * FailureRecord, there are only a few distinct ones so they are never released.
+ */
+inline const char* PersistentString(const char *ipText)
+{
+    static platform::Mutex mutex;
+    static std::set<std::string> texts;
+    platform::ScopedLock lock(mutex);
+    return texts.insert(ipText).first->c_str();
+}
+
+/**
+ * Result of a test, strings live until the logger returns
+ */
+struct TestRecord
+{
+    const char *suite;
+    const char *test;
+    int         retVal;                 //0 if the test passed
+    int         numAssertions;
+    int         numFailedAssertions;
+    double      seconds;                //from SetUp to the end of TearDown
+    const char *reason;                 //why it failed other than assertions, 0 if none
+};
+
 /**
  * A simple logger which can be passed to the test manager to log the 
  * activities. 
@@ -59,6 +234,8 @@ namespace esintiler
 class Logger
 {
 public:
+    virtual ~Logger() {}
+
     virtual void log(const char *ipMsg) 
     {
         printf("%s\n", ipMsg);
@@ -68,348 +245,4743 @@ public:
     { 
         log(iMsg.c_str()); 
     }
-};
 
-/**
- * Forward decleration for TestSuiteBase, it is requred for abstract method in TestBase
- */
-struct TestSuiteBase;
+    /**
+     * Duration of a phase in seconds, measured with the monotonic clock. Test is empty 
+     * for the phases of a suite. It is called in the same order as the messages, after 
+     * the messages of the timed phase. Default implementation ignores it.
+     */
+    virtual void timing(const char *ipSuite, const char *ipTest, TimingPhase iPhase, double iSeconds)
+    {
+    }
 
+    /**
+     * Result of a benchmark, it is called after the benchmark is completed and before 
+     * its "...OK" message. Default implementation logs the statistics.
+     */
+    virtual void benchmark(const BenchmarkResult &iResult)
+    {
+        char pBuf[1024];
+        sprintf_s(pBuf, "...Benchmark (%i x %li iterations): min %s, median %s, p99 %s, stddev %s", 
+            (int)iResult.samples.size(), iResult.iterations, 
+            BenchmarkResult::Format(iResult.min).c_str(), BenchmarkResult::Format(iResult.median).c_str(),
+            BenchmarkResult::Format(iResult.p99).c_str(), BenchmarkResult::Format(iResult.stddev).c_str());
+        log(pBuf);
+    }
 
-/**
- * TestBase class is used as the base class for each test method object. Test method objects 
- * are defined as data member of Test Suite so their constructer is called whenever a Test Suite
- * is instantiated. This way each method can register itself to the test suite. 
- *
- * Registration is done in constructor, so we define a derived TestBase class for each test method. 
- */
-struct TestBase
-{
-    TestBase(const char *iName): name(iName){}
-    /** 
-     * Abastruct method to be called by test manager to trigger the each Test execution. 
-     * Actual implementation of this method is given in derived classes which is defined by 
-     * macro (TEST) for each test method instance.
-     *
-     * @ipSuite: Parent suite object passed to the method so it can trigger the actual method
-     * on it.
+    /**
+     * A failed assertion, called from the test at the point of the failure so nothing 
+     * is formatted before it. Default implementation logs the "#" lines of the failure.
      */
-    virtual void Execute(TestSuiteBase* ipSuite) = 0;
-    const std::string name;
+    virtual void failure(const FailureRecord &iFailure)
+    {
+        char pBuf[2048];
+        if(iFailure.statement)
+        {
+            sprintf_s(pBuf, "#statement: %s", iFailure.statement); log(pBuf);
+            sprintf_s(pBuf, "#file     : %s", iFailure.file); log(pBuf);
+            sprintf_s(pBuf, "#line     : %i", iFailure.line); log(pBuf);
+            return;
+        }
+        sprintf_s(pBuf, "#file    : %s", iFailure.file); log(pBuf);
+        sprintf_s(pBuf, "#line    : %i", iFailure.line); log(pBuf);
+        if(iFailure.message)
+        {
+            sprintf_s(pBuf, "#msg     : %s", iFailure.message); 
+            log(pBuf);
+        }
+    }
+
+    /**
+     * Result of a test, called once per executed test after its messages and timings, 
+     * including the tests failed by a crash or a timeout. Default implementation ignores
+     * it.
+     */
+    virtual void result(const TestRecord &iRecord)
+    {
+    }
 
+    /**
+     * Called once at the end of the run, default implementation logs the totals and the
+     * slowest tests and suites
+     */
+    virtual void summary(const RunSummary &iSummary)
+    {
+        char pBuf[1024];
+        log("");
+        log("********************************");
+        log("*");
+        sprintf_s(pBuf, "* TEST RESULT IS    : %i", iSummary.retVal);
+        log(pBuf);
+        sprintf_s(pBuf, "* #Total Tests      : %i", iSummary.numTests);
+        log(pBuf);
+        sprintf_s(pBuf, "* #Total Assertions : %i", iSummary.numAssertions);
+        log(pBuf);
+        sprintf_s(pBuf, "* #Failed Assertions: %i", iSummary.numFailedAssertions);
+        log(pBuf);
+        sprintf_s(pBuf, "* Total Time        : %.3f s", iSummary.seconds);
+        log(pBuf);
+        log("*");
+        if(!iSummary.slowestTests.empty())
+        {
+            log("* Slowest Tests:");
+            for(unsigned int i = 0; i < iSummary.slowestTests.size(); i++)
+            {
+                const TimingEntry &entry = iSummary.slowestTests[i];
+                sprintf_s(pBuf, "*   %9.3f s  %s.%s", entry.seconds, entry.suite.c_str(), entry.test.c_str());
+                log(pBuf);
+            }
+        }
+        if(!iSummary.slowestSuites.empty())
+        {
+            log("* Slowest Suites:");
+            for(unsigned int i = 0; i < iSummary.slowestSuites.size(); i++)
+            {
+                const TimingEntry &entry = iSummary.slowestSuites[i];
+                sprintf_s(pBuf, "*   %9.3f s  %s", entry.seconds, entry.suite.c_str());
+                log(pBuf);
+            }
+            log("*");
+        }
+        log("********************************");
+    }
 };
 
 /**
- * Base class to define the collection of tests. User extends this class by 
- * defining test methods as well as overriding the SetUp and TearDown methods
- *
+ * Logger which keeps the messages, the timings and the benchmark results in memory until 
+ * they are flushed to another logger. Used by parallel execution so each suite can log without any locking 
+ * and the final output is still in the same order as a serial run.
  */
-struct TestSuiteBase
+class BufferedLogger : public Logger
 {
-    /** 
-     * This method will be called just after a TestSuite object is constructed but
-     * before calling any test method on it. It replaces the constructor and used here 
-     * to avoid name dependency in TestSuite class. 
-     *
-     * @return: 0 to indicate success. Any non-zero will make the suite as failed and no 
-     * test will be executed
-     */
-    virtual int Construct() {return 0;}
+public:
+    using Logger::log;
 
-    /**
-     * This method will be called just before destroying the TestSuite object. It replaces
-     * the destructor and used to avoid name dependency to the test suite class
-     */
-    virtual void Destruct() {};
+    void log(const char *ipMsg)
+    {
+        m_events.push_back(Event(EventLog, ipMsg));
+    }
+
+    void timing(const char *ipSuite, const char *ipTest, TimingPhase iPhase, double iSeconds)
+    {
+        Event event(EventTiming, ipSuite, iPhase, iSeconds);
+        event.test = ipTest;
+        m_events.push_back(event);
+    }
+
+    void benchmark(const BenchmarkResult &iResult)
+    {
+        Event event(EventBenchmark, "");
+        event.index = m_benchmarks.size();
+        m_benchmarks.push_back(iResult);
+        m_events.push_back(event);
+    }
+
+    void failure(const FailureRecord &iFailure)
+    {
+        Event event(EventFailure, "");
+        event.index = m_failures.size();
+        m_failures.push_back(Failure(iFailure));
+        m_events.push_back(event);
+    }
+
+    void result(const TestRecord &iRecord)
+    {
+        Event event(EventResult, iRecord.suite, PhaseTest, iRecord.seconds);
+        event.test = iRecord.test;
+        event.index = m_results.size();
+        m_results.push_back(Result(iRecord));
+        m_events.push_back(event);
+    }
 
     /**
-     * This method will be called before each test method execution. If you need to 
-     * provide one time set up for all tests you should use the constructor for your class
-     * A single test suite object will be initialized to be used by all test methods provided 
-     * in that suite.
-     *
-     * @return: 0 to indicate success. Any non-zero value will mark the suite as failed and 
-     * following test method and TearDown calls will not be invoked
+     * Passes all the buffered events to the given logger and clears the buffer
      */
-    virtual int SetUp(const std::string &iName) {return 0; }
-    
+    void Flush(Logger *ipTarget)
+    {
+        std::vector<Event>::iterator it = m_events.begin();
+        for(; it != m_events.end(); it++)
+        {
+            switch(it->kind)
+            {
+            case EventLog:
+                ipTarget->log(it->text.c_str());
+                break;
+            case EventTiming:
+                ipTarget->timing(it->text.c_str(), it->test.c_str(), it->phase, it->seconds);
+                break;
+            case EventBenchmark:
+                ipTarget->benchmark(m_benchmarks[it->index]);
+                break;
+            case EventFailure:
+                ipTarget->failure(m_failures[it->index].Record());
+                break;
+            case EventResult:
+                {
+                    const Result &result = m_results[it->index];
+                    TestRecord record = { it->text.c_str(), it->test.c_str(), result.retVal, 
+                        result.numAssertions, result.numFailedAssertions, it->seconds, 
+                        result.hasReason ? result.reason.c_str() : 0 };
+                    ipTarget->result(record);
+                }
+                break;
+            }
+        }
+        m_events.clear();
+        m_benchmarks.clear();
+        m_failures.clear();
+        m_results.clear();
+    }
+
+private:
+    enum EventKind { EventLog, EventTiming, EventBenchmark, EventFailure, EventResult };
+
     /**
-     * This method will be called after each test method execution. If you need to 
-     * provide one time cleaning use destructor of your test suite.
+     * Parts of a TestRecord which are not kept by the Event
      */
-    virtual void TearDown(const std::string &iName) {}
+    struct Result
+    {
+        Result(const TestRecord &iRecord)
+            : retVal(iRecord.retVal)
+            , numAssertions(iRecord.numAssertions)
+            , numFailedAssertions(iRecord.numFailedAssertions)
+            , hasReason(iRecord.reason != 0)
+            , reason(hasReason ? iRecord.reason : "")
+        {
+        }
+
+        int         retVal;
+        int         numAssertions;
+        int         numFailedAssertions;
+        bool        hasReason;
+        std::string reason;
+    };
 
     /**
-     * Constructor will set the current object as the current suite. 
+     * Copy of a FailureRecord, statement and file are literals so they are not copied
      */
-    TestSuiteBase()
-        : numAssertions(0)
-        , numFailedAssertions(0)
-        , logger(0)
+    struct Failure
     {
-    }
+        Failure(const FailureRecord &iRecord)
+            : statement(iRecord.statement)
+            , hasMessage(iRecord.message != 0)
+            , message(hasMessage ? iRecord.message : "")
+            , file(iRecord.file)
+            , line(iRecord.line)
+            , suite(iRecord.suite)
+            , test(iRecord.test)
+        {
+        }
 
-    /*
-    * Abstract method to indicate if the test suite is active or not. Inactive test suites are 
-    * ignored by the test execution.
-    */
-    virtual bool Active() = 0;
+        FailureRecord Record() const
+        {
+            FailureRecord record = { statement, hasMessage ? message.c_str() : 0, file, line, 
+                suite.c_str(), test.c_str() };
+            return record;
+        }
 
-    Logger *logger;
-    
-    //
-    //
-    //
-    typedef std::vector<TestBase*> TestList;
-    TestList Tests;
+        const char *statement;
+        bool        hasMessage;
+        std::string message;
+        const char *file;
+        int         line;
+        std::string suite;
+        std::string test;
+    };
 
-    int numAssertions;
-    int numFailedAssertions;
+    struct Event
+    {
+        Event(EventKind iKind, const char *ipText, TimingPhase iPhase = PhaseSuite, double iSeconds = 0)
+            : kind(iKind), text(ipText), phase(iPhase), seconds(iSeconds), index(0) {}
+
+        EventKind   kind;
+        std::string text;   //message, or suite of the timing
+        std::string test;
+        TimingPhase phase;
+        double      seconds;
+        size_t      index;  //of the benchmark result
+    };
+    std::vector<Event>              m_events;
+    std::vector<BenchmarkResult>    m_benchmarks;
+    std::vector<Failure>            m_failures;
+    std::vector<Result>             m_results;
 };
 
 /**
- * Factory object to instantiate TestSuite objects when requested. Test runners are created 
- * as soon as application is loaded since they all have static/global instances. However a 
- * test suite will be instantiated only when needed and it will be destroyed as soon as all 
- * tests are executed
- * 
- * This is an internal class and users do not need to interact with it.
+ * Base of the loggers which write the results of the tests to a file in a machine 
+ * readable format. A record is written and flushed as soon as each test finishes, only 
+ * the failures of the running test are kept in memory so long runs do not grow the 
+ * memory. Every event is also passed to the next logger, if given, so the usual output 
+ * is not lost.
  */
-struct TestRunnerBase
+class Reporter : public Logger
 {
-    virtual TestSuiteBase *CreateSuite() = 0;
-};
+public:
+    using Logger::log;
 
+    /**
+     * @ipFile: file to write, NULL for reporters which write their file themselves
+     * @ipNext: logger to pass all the events to, NULL if there is none
+     */
+    Reporter(const char *ipFile, Logger *ipNext)
+        : m_file(ipFile ? platform::OpenFile(ipFile, "w") : 0)
+        , m_next(ipNext)
+    {
+    }
 
-class Evaluator 
-{
-public:
-    class Exception : public std::exception
+    virtual ~Reporter()
     {
-      virtual const char* what() const throw()
-      {
-        return "Evaluator Exception";
-      }
-    };
+        if(m_file)
+            fclose(m_file);
+    }
+
+    /**
+     * False if the file could not be created, nothing is written then
+     */
+    virtual bool IsOpen() const
+    {
+        return m_file != 0;
+    }
+
+    void log(const char *ipMsg)
+    {
+        if(m_next)
+            m_next->log(ipMsg);
+    }
+
+    void timing(const char *ipSuite, const char *ipTest, TimingPhase iPhase, double iSeconds)
+    {
+        if(m_next)
+            m_next->timing(ipSuite, ipTest, iPhase, iSeconds);
+    }
+
+    void benchmark(const BenchmarkResult &iResult)
+    {
+        if(m_next)
+            m_next->benchmark(iResult);
+    }
+
+    void failure(const FailureRecord &iFailure)
+    {
+        if(m_next)
+            m_next->failure(iFailure);
+    }
+
+    void result(const TestRecord &iRecord)
+    {
+        if(m_next)
+            m_next->result(iRecord);
+    }
+
+    void summary(const RunSummary &iSummary)
+    {
+        if(m_next)
+            m_next->summary(iSummary);
+    }
+
+protected:
+    /**
+     * Writes and flushes the given text, so the completed tests are in the file even if 
+     * the run is killed
+     */
+    void Write(const std::string &iText)
+    {
+        if(!m_file)
+            return;
+        fwrite(iText.data(), 1, iText.size(), m_file);
+        fflush(m_file);
+    }
+
+    static void AppendXml(std::string &ioOut, const char *ipText)
+    {
+        for(; *ipText; ipText++)
+        {
+            switch(*ipText)
+            {
+            case '<':  ioOut += "&lt;"; break;
+            case '>':  ioOut += "&gt;"; break;
+            case '&':  ioOut += "&amp;"; break;
+            case '"':  ioOut += "&quot;"; break;
+            case '\'': ioOut += "&apos;"; break;
+            default:
+                //control characters are not allowed in XML 1.0
+                if((unsigned char)*ipText < 0x20 && *ipText != '\n' && *ipText != '\t' && *ipText != '\r')
+                    ioOut += '?';
+                else
+                    ioOut += *ipText;
+            }
+        }
+    }
+
+    static void AppendJson(std::string &ioOut, const char *ipText)
+    {
+        ioOut += '"';
+        for(; *ipText; ipText++)
+        {
+            switch(*ipText)
+            {
+            case '"':  ioOut += "\\\""; break;
+            case '\\': ioOut += "\\\\"; break;
+            case '\n': ioOut += "\\n"; break;
+            case '\r': ioOut += "\\r"; break;
+            case '\t': ioOut += "\\t"; break;
+            default:
+                if((unsigned char)*ipText < 0x20)
+                {
+                    char pBuf[8];
+                    sprintf_s(pBuf, "\\u%04x", (unsigned char)*ipText);
+                    ioOut += pBuf;
+                }
+                else
+                    ioOut += *ipText;
+            }
+        }
+        ioOut += '"';
+    }
+
+    FILE   *m_file;
+    Logger *m_next;
+};
+
+/**
+ * Writes the results as JUnit XML. Each suite is a <testsuite> and each test is a 
+ * <testcase> with a <failure> listing the failed assertions, the document is closed 
+ * when the reporter is destroyed. Since the results are streamed, the totals are not 
+ * written as attributes, consumers count the test cases instead.
+ */
+class JUnitReporter : public Reporter
+{
+public:
+    JUnitReporter(const char *ipFile, Logger *ipNext = 0)
+        : Reporter(ipFile, ipNext)
+        , m_inSuite(false)
+    {
+        Write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n");
+    }
+
+    ~JUnitReporter()
+    {
+        CloseSuite();
+        Write("</testsuites>\n");
+    }
+
+    void timing(const char *ipSuite, const char *ipTest, TimingPhase iPhase, double iSeconds)
+    {
+        Reporter::timing(ipSuite, ipTest, iPhase, iSeconds);
+        if(iPhase == PhaseSuite && m_suite == ipSuite)
+            CloseSuite();
+    }
+
+    void failure(const FailureRecord &iFailure)
+    {
+        Reporter::failure(iFailure);
+        char pBuf[64];
+        AppendXml(m_failures, iFailure.file);
+        sprintf_s(pBuf, ":%i: ", iFailure.line);
+        m_failures += pBuf;
+        AppendXml(m_failures, iFailure.statement ? iFailure.statement : 
+            (iFailure.message ? iFailure.message : "assertion failed"));
+        m_failures += '\n';
+    }
+
+    void result(const TestRecord &iRecord)
+    {
+        Reporter::result(iRecord);
+        m_text.clear();
+        if(!m_inSuite || m_suite != iRecord.suite)
+        {
+            CloseSuite();
+            m_suite = iRecord.suite;
+            m_inSuite = true;
+            m_text += "  <testsuite name=\"";
+            AppendXml(m_text, iRecord.suite);
+            m_text += "\">\n";
+        }
+
+        char pBuf[256];
+        m_text += "    <testcase classname=\"";
+        AppendXml(m_text, iRecord.suite);
+        m_text += "\" name=\"";
+        AppendXml(m_text, iRecord.test);
+        sprintf_s(pBuf, "\" time=\"%.6f\" assertions=\"%i\"", iRecord.seconds, iRecord.numAssertions);
+        m_text += pBuf;
+        if(iRecord.retVal == 0)
+        {
+            m_text += "/>\n";
+        }
+        else
+        {
+            m_text += ">\n      <failure message=\"";
+            if(iRecord.reason)
+                AppendXml(m_text, iRecord.reason);
+            else
+            {
+                sprintf_s(pBuf, "%i of %i assertions failed", iRecord.numFailedAssertions, iRecord.numAssertions);
+                m_text += pBuf;
+            }
+            m_text += "\" type=\"failure\">";
+            m_text += m_failures;
+            m_text += "</failure>\n    </testcase>\n";
+        }
+        m_failures.clear();
+        Write(m_text);
+    }
+
+private:
+    void CloseSuite()
+    {
+        if(!m_inSuite)
+            return;
+        Write("  </testsuite>\n");
+        m_inSuite = false;
+    }
+
+    bool        m_inSuite;
+    std::string m_suite;
+    std::string m_failures;     //of the running test
+    std::string m_text;
+};
+
+/**
+ * Writes the results as JSON Lines, one object per line:
+ *
+ *     {"type":"test","shard":0,"suite":"S","test":"t","retVal":1,"numAssertions":3,
+ *      "numFailedAssertions":1,"seconds":0.001,"failures":[{"file":"f.cpp","line":12,
+ *      "statement":"a == b"}]}
+ *
+ * followed by a "suite" line (suite and seconds) once a suite is completed, "benchmark"
+ * lines for the benchmarks and a "summary" line with the totals of the run. Each line 
+ * stands on its own and carries the shard index, so files of the shards can simply be 
+ * concatenated.
+ */
+class JsonLinesReporter : public Reporter
+{
+public:
+    JsonLinesReporter(const char *ipFile, Logger *ipNext = 0, int iShard = 0)
+        : Reporter(ipFile, ipNext)
+        , m_shard(iShard)
+    {
+    }
+
+    void timing(const char *ipSuite, const char *ipTest, TimingPhase iPhase, double iSeconds)
+    {
+        Reporter::timing(ipSuite, ipTest, iPhase, iSeconds);
+        if(iPhase != PhaseSuite)
+            return;
+        char pBuf[64];
+        Start("suite");
+        m_text += ",\"suite\":";
+        AppendJson(m_text, ipSuite);
+        sprintf_s(pBuf, ",\"seconds\":%.6f}\n", iSeconds);
+        m_text += pBuf;
+        Write(m_text);
+    }
+
+    void benchmark(const BenchmarkResult &iResult)
+    {
+        Reporter::benchmark(iResult);
+        char pBuf[256];
+        Start("benchmark");
+        m_text += ",\"suite\":";
+        AppendJson(m_text, iResult.suite.c_str());
+        m_text += ",\"test\":";
+        AppendJson(m_text, iResult.test.c_str());
+        sprintf_s(pBuf, ",\"iterations\":%li,\"samples\":%i,\"min\":%.9g,\"median\":%.9g,\"p99\":%.9g,\"stddev\":%.9g}\n", 
+            iResult.iterations, (int)iResult.samples.size(), iResult.min, iResult.median, 
+            iResult.p99, iResult.stddev);
+        m_text += pBuf;
+        Write(m_text);
+    }
+
+    void failure(const FailureRecord &iFailure)
+    {
+        Reporter::failure(iFailure);
+        char pBuf[64];
+        m_failures += m_failures.empty() ? "{\"file\":" : ",{\"file\":";
+        AppendJson(m_failures, iFailure.file);
+        sprintf_s(pBuf, ",\"line\":%i", iFailure.line);
+        m_failures += pBuf;
+        if(iFailure.statement)
+        {
+            m_failures += ",\"statement\":";
+            AppendJson(m_failures, iFailure.statement);
+        }
+        if(iFailure.message)
+        {
+            m_failures += ",\"message\":";
+            AppendJson(m_failures, iFailure.message);
+        }
+        m_failures += '}';
+    }
+
+    void result(const TestRecord &iRecord)
+    {
+        Reporter::result(iRecord);
+        char pBuf[256];
+        Start("test");
+        m_text += ",\"suite\":";
+        AppendJson(m_text, iRecord.suite);
+        m_text += ",\"test\":";
+        AppendJson(m_text, iRecord.test);
+        sprintf_s(pBuf, ",\"retVal\":%i,\"numAssertions\":%i,\"numFailedAssertions\":%i,\"seconds\":%.6f", 
+            iRecord.retVal, iRecord.numAssertions, iRecord.numFailedAssertions, iRecord.seconds);
+        m_text += pBuf;
+        if(iRecord.reason)
+        {
+            m_text += ",\"reason\":";
+            AppendJson(m_text, iRecord.reason);
+        }
+        m_text += ",\"failures\":[";
+        m_text += m_failures;
+        m_text += "]}\n";
+        m_failures.clear();
+        Write(m_text);
+    }
+
+    void summary(const RunSummary &iSummary)
+    {
+        Reporter::summary(iSummary);
+        char pBuf[256];
+        Start("summary");
+        sprintf_s(pBuf, ",\"retVal\":%i,\"numTests\":%i,\"numAssertions\":%i,\"numFailedAssertions\":%i,\"seconds\":%.6f}\n", 
+            iSummary.retVal, iSummary.numTests, iSummary.numAssertions, iSummary.numFailedAssertions, 
+            iSummary.seconds);
+        m_text += pBuf;
+        Write(m_text);
+    }
+
+private:
+    void Start(const char *ipType)
+    {
+        char pBuf[64];
+        sprintf_s(pBuf, "{\"type\":\"%s\",\"shard\":%i", ipType, m_shard);
+        m_text = pBuf;
+    }
+
+    int         m_shard;
+    std::string m_failures;     //of the running test
+    std::string m_text;
+};
+
+/**
+ * Forward decleration for TestSuiteBase, it is requred for abstract method in TestBase
+ */
+struct TestSuiteBase;
+
+
+/**
+ * TestBase class is used as the base class for each test method object. Each test method
+ * has its own derived class and a single static object of it (see TestRegistration), which
+ * is linked to the TestCatalog of its suite while the application is loaded. Suites do not
+ * own their tests, every instance of a suite shares the same test objects.
+ */
+struct TestBase
+{
+    TestBase(const char *iName, double iTimeout = -1, bool iBenchmark = false)
+        : name(iName), timeout(iTimeout), benchmark(iBenchmark), order(0), next(0){}
+    /** 
+     * Abastruct method to be called by test manager to trigger the each Test execution. 
+     * Actual implementation of this method is given in derived classes which is defined by 
+     * macro (TEST) for each test method instance.
+     *
+     * @ipSuite: Parent suite object passed to the method so it can trigger the actual method
+     * on it.
+     */
+    virtual void Execute(TestSuiteBase* ipSuite) = 0;
+
+    /**
+     * Executes the test the given number of times, used to time the benchmarks. BENCHMARK
+     * macro overrides it so the loop does not have the cost of a virtual call
+     */
+    virtual void Repeat(TestSuiteBase* ipSuite, long iIterations)
+    {
+        for(long i = 0; i < iIterations; i++)
+            Execute(ipSuite);
+    }
+
+    const char *const name;
+
+    /**
+     * Time budget of the test in seconds (see TEST_TIMEOUT), negative to use the budget 
+     * of the suite
+     */
+    const double timeout;
+
+    /**
+     * True for the methods defined with BENCHMARK
+     */
+    const bool benchmark;
+
+    /**
+     * Position of the definition in its file and the next test of the suite, they are
+     * set by TestCatalog
+     */
+    int         order;
+    TestBase   *next;
+};
+
+/**
+ * Limits the failures logged for each assertion of a test, so an assertion failing in a 
+ * long loop does not flood the log. Only the first failures of an assertion (same file 
+ * and line) are passed to the logger, the rest are counted and summarized by Flush at the
+ * end of the test. Failed assertions are still counted one by one by the caller.
+ */
+class FailureLimiter
+{
+public:
+    FailureLimiter() : m_limit(0), m_firstAssertion(0), m_last(0) {}
+
+    /**
+     * Starts a new test. iLimit is the number of failures to log for each assertion, 0 to 
+     * log all of them. iNumAssertions is the assertion count before the test.
+     */
+    void Reset(int iLimit, int iNumAssertions)
+    {
+        m_limit = iLimit;
+        m_firstAssertion = iNumAssertions;
+        m_sites.clear();
+        m_last = 0;
+    }
+
+    /**
+     * Records a failure, iNumAssertions is the assertion count including the failed one.
+     *
+     * @return: true if the failure should be logged
+     */
+    bool Count(const FailureRecord &iFailure, int iNumAssertions)
+    {
+        if(m_limit <= 0)
+            return true;
+        Site *pSite = Find(iFailure.file, iFailure.line);
+        if(++pSite->count <= m_limit)
+            return true;
+        int assertion = iNumAssertions - m_firstAssertion;
+        if(pSite->count == m_limit + 1)
+        {
+            pSite->statement = iFailure.statement;
+            pSite->firstAssertion = assertion;
+            pSite->firstMessage = iFailure.message ? iFailure.message : "";
+        }
+        pSite->lastAssertion = assertion;
+        pSite->lastMessage = iFailure.message ? iFailure.message : "";
+        return false;
+    }
+
+    /**
+     * Records iCount failures of an assertion which were already suppressed by another 
+     * thread of the test, iFailure is the first of them. The thread logged the first 
+     * failures of the assertion itself, so they are all counted as suppressed. Their 
+     * place in the test is not known, they are all placed at iNumAssertions.
+     */
+    void Suppress(const FailureRecord &iFailure, const char *ipLastMessage, int iCount, 
+        int iNumAssertions)
+    {
+        Site *pSite = Find(iFailure.file, iFailure.line);
+        int assertion = iNumAssertions - m_firstAssertion;
+        if(pSite->count <= m_limit)
+        {
+            pSite->statement = iFailure.statement;
+            pSite->firstAssertion = assertion;
+            pSite->firstMessage = iFailure.message ? iFailure.message : "";
+        }
+        pSite->count += iCount;
+        pSite->lastAssertion = assertion;
+        pSite->lastMessage = ipLastMessage ? ipLastMessage : "";
+    }
+
+    /**
+     * Number of failures logged for each assertion, 0 if all of them are logged
+     */
+    int Limit() const
+    {
+        return m_limit;
+    }
+
+    /**
+     * Logs the number of suppressed failures of each assertion with the first and the last 
+     * of them (index of the assertion in the test and the message, if any)
+     */
+    void Flush(Logger *logger)
+    {
+        for(unsigned int i = 0; i < m_sites.size(); i++)
+        {
+            const Site &site = m_sites[i];
+            if(site.count <= m_limit)
+                continue;
+            char pBuf[2048];
+            sprintf_s(pBuf, "#suppressed: %i further failures of %s (%s:%i), first in assertion %i, last in assertion %i", 
+                site.count - m_limit, site.statement ? site.statement : "CHECK/ASSERT", site.file, 
+                site.line, site.firstAssertion, site.lastAssertion);
+            logger->log(pBuf);
+            if(!site.firstMessage.empty() || !site.lastMessage.empty())
+            {
+                sprintf_s(pBuf, "#suppressed: first msg: %s, last msg: %s", site.firstMessage.c_str(), 
+                    site.lastMessage.c_str());
+                logger->log(pBuf);
+            }
+        }
+        m_sites.clear();
+        m_last = 0;
+    }
+
+private:
+    struct Site
+    {
+        Site(const char *iFile, int iLine) 
+            : file(iFile), line(iLine), count(0), statement(0), firstAssertion(0), lastAssertion(0) {}
+
+        const char *file;
+        int         line;
+        int         count;
+        const char *statement;
+        int         firstAssertion;
+        int         lastAssertion;
+        std::string firstMessage;
+        std::string lastMessage;
+    };
+
+    /**
+     * A test has a few failing assertions and the same one usually fails again, so the 
+     * last one is checked first and the rest are searched linearly
+     */
+    Site* Find(const char *ipFile, int iLine)
+    {
+        if(m_last < m_sites.size() && m_sites[m_last].line == iLine && m_sites[m_last].file == ipFile)
+            return &m_sites[m_last];
+        for(m_last = 0; m_last < m_sites.size(); m_last++)
+            if(m_sites[m_last].line == iLine && m_sites[m_last].file == ipFile)
+                return &m_sites[m_last];
+        m_sites.push_back(Site(ipFile, iLine));
+        return &m_sites[m_last];
+    }
+
+    int                 m_limit;
+    int                 m_firstAssertion;
+    std::vector<Site>   m_sites;
+    size_t              m_last;     //site of the last failure
+};
+
+/**
+ * Base class to define the collection of tests. User extends this class by 
+ * defining test methods as well as overriding the SetUp and TearDown methods
+ *
+ */
+struct TestSuiteBase
+{
+    /** 
+     * This method will be called just after a TestSuite object is constructed but
+     * before calling any test method on it. It replaces the constructor and used here 
+     * to avoid name dependency in TestSuite class. 
+     *
+     * @return: 0 to indicate success. Any non-zero will make the suite as failed and no 
+     * test will be executed
+     */
+    virtual int Construct() {return 0;}
+
+    /**
+     * This method will be called just before destroying the TestSuite object. It replaces
+     * the destructor and used to avoid name dependency to the test suite class
+     */
+    virtual void Destruct() {};
+
+    /**
+     * This method will be called before each test method execution. If you need to 
+     * provide one time set up for all tests you should use the constructor for your class
+     * A single test suite object will be initialized to be used by all test methods provided 
+     * in that suite.
+     *
+     * @return: 0 to indicate success. Any non-zero value will mark the suite as failed and 
+     * following test method and TearDown calls will not be invoked
+     */
+    virtual int SetUp(const std::string &iName) {return 0; }
+    
+    /**
+     * This method will be called after each test method execution. If you need to 
+     * provide one time cleaning use destructor of your test suite.
+     */
+    virtual void TearDown(const std::string &iName) {}
+
+    /**
+     * Number of workers to share the tests of this suite. Tests are split into contiguous
+     * ranges and each worker executes its range with its own instance of the suite, so 
+     * Construct/Destruct are called once per worker. Override it for suites with many 
+     * independent tests, 0 means one worker per processor.
+     */
+    virtual int Workers() { return 1; }
+
+    /**
+     * Number of tests to be executed in each forked copy of the suite, 0 to execute the 
+     * tests in the suite itself. Suite is constructed once and each batch of tests gets a 
+     * copy on write snapshot of it, so expensive Construct calls can be shared by tests 
+     * which modify the suite. It is ignored where fork is not supported.
+     */
+    virtual int TestsPerFork() { return 0; }
+
+    /**
+     * Time budget of each test of this suite in seconds, 0 for no limit and negative to 
+     * use the default of the run (see TestManager::DefaultTimeout). Budget covers SetUp,
+     * the test and TearDown.
+     */
+    virtual double Timeout() { return -1; }
+
+    /**
+     * Constructor will set the current object as the current suite. 
+     */
+    TestSuiteBase()
+        : numAssertions(0)
+        , numFailedAssertions(0)
+        , logger(0)
+        , name("")
+        , currentTest("")
+        , m_serial(platform::AtomicAdd(&Serials(), 1))
+    {
+    }
+
+    virtual ~TestSuiteBase()
+    {
+        for(size_t i = 0; i < m_threadCounts.size(); i++)
+            delete m_threadCounts[i];
+    }
+
+    /*
+    * Abstract method to indicate if the test suite is active or not. Inactive test suites are 
+    * ignored by the test execution.
+    */
+    virtual bool Active() = 0;
+
+    Logger *logger;
+
+    /**
+     * Name of the suite, set by the runner which creates the suite
+     */
+    const char *name;
+
+    /**
+     * Name of the test being executed, set by the runner before SetUp
+     */
+    const char *currentTest;
+    
+    //
+    //
+    //
+    typedef std::vector<TestBase*> TestList;
+    TestList Tests;
+
+    int numAssertions;
+    int numFailedAssertions;
+
+    /**
+     * Failures of the running test, see TestManager::FailureLimit
+     */
+    FailureLimiter failureLimiter;
+
+    /**
+     * Counts an assertion. The thread running the test counts on the suite itself, any 
+     * other thread of the test counts on a slot of its own so threads never write to the
+     * same counter. Slots are added to the suite by MergeThreads.
+     */
+    void CountAssertion()
+    {
+        if(ESINTILER_LIKELY(RunningSuite() == this))
+            numAssertions++;
+        else
+            ThreadSlot().numAssertions++;
+    }
+
+    /**
+     * Handles a failed assertion. It is kept out of line so the passing path of the 
+     * macros is only a counter increment and a branch. Failures of the other threads 
+     * are queued on their slots and logged by MergeThreads on the thread running the 
+     * test, so neither the limiter nor the logger has to be thread safe. Slots apply the 
+     * failure limit themselves, so a failing loop on a thread only keeps the first 
+     * failures of each assertion.
+     */
+    ESINTILER_COLD void AssertionFailed(const char *ipStatement, const char *ipMessage, 
+        const char *ipFile, int iLine)
+    {
+        if(RunningSuite() != this)
+        {
+            ThreadCounts &slot = ThreadSlot();
+            slot.numFailedAssertions++;
+            slot.Queue(ipStatement, ipMessage, ipFile, iLine, failureLimiter.Limit());
+            return;
+        }
+        numFailedAssertions++;
+        FailureRecord failure = { ipStatement, ipMessage, ipFile, iLine, name, currentTest };
+        if(failureLimiter.Count(failure, numAssertions))
+            logger->failure(failure);
+    }
+
+    /**
+     * Makes the calling thread the one running the tests of the suite, returns the 
+     * previous suite of the thread to be restored once the tests are executed.
+     */
+    TestSuiteBase* RunOnThisThread()
+    {
+        TestSuiteBase *pPrevious = RunningSuite();
+        RunningSuite() = this;
+        return pPrevious;
+    }
+
+    static void RestoreRunningSuite(TestSuiteBase *ipSuite)
+    {
+        RunningSuite() = ipSuite;
+    }
+
+    /**
+     * Adds the counts of the other threads to the suite and logs their failures. It is 
+     * called by the thread running the test once the test is completed, threads started 
+     * by the test should be joined by then.
+     */
+    void MergeThreads()
+    {
+        std::vector<ThreadFailure> failures;
+        std::vector<ThreadSite> sites;
+        {
+            platform::ScopedLock lock(m_threadMutex);
+            for(size_t i = 0; i < m_threadCounts.size(); i++)
+            {
+                ThreadCounts &slot = *m_threadCounts[i];
+                numAssertions += slot.numAssertions;
+                numFailedAssertions += slot.numFailedAssertions;
+                slot.numAssertions = 0;
+                slot.numFailedAssertions = 0;
+
+                platform::ScopedLock slotLock(slot.mutex);
+                failures.insert(failures.end(), slot.failures.begin(), slot.failures.end());
+                sites.insert(sites.end(), slot.sites.begin(), slot.sites.end());
+                slot.failures.clear();
+                slot.sites.clear();
+            }
+        }
+        for(size_t i = 0; i < failures.size(); i++)
+        {
+            const ThreadFailure &f = failures[i];
+            FailureRecord failure = { f.statement, f.hasMessage ? f.message.c_str() : 0, 
+                f.file, f.line, name, currentTest };
+            if(failureLimiter.Count(failure, numAssertions))
+                logger->failure(failure);
+        }
+        for(size_t i = 0; i < sites.size(); i++)
+        {
+            const ThreadSite &site = sites[i];
+            if(site.count <= site.limit)
+                continue;
+            FailureRecord failure = { site.statement, site.firstMessage.c_str(), site.file, 
+                site.line, name, currentTest };
+            failureLimiter.Suppress(failure, site.lastMessage.c_str(), site.count - site.limit, 
+                numAssertions);
+        }
+    }
+
+private:
+    /**
+     * Failure of an assertion made on another thread, message is copied since it may 
+     * not live until the failure is logged
+     */
+    struct ThreadFailure
+    {
+        const char     *statement;
+        std::string     message;
+        bool            hasMessage;
+        const char     *file;
+        int             line;
+    };
+
+    /**
+     * Failures of an assertion on a thread, the first limit of them are queued and the 
+     * rest are only counted, like in FailureLimiter
+     */
+    struct ThreadSite
+    {
+        const char     *file;
+        int             line;
+        int             limit;
+        int             count;
+        const char     *statement;
+        std::string     firstMessage;
+        std::string     lastMessage;
+    };
+
+    /**
+     * Counters of a thread, each one has a cache line of its own. Failures are only 
+     * touched on the cold path so they follow the counters.
+     */
+    struct ThreadCounts
+    {
+        int     numAssertions;
+        int     numFailedAssertions;
+        char    padding[64 - 2 * sizeof(int)];
+
+        platform::Mutex             mutex;      //failures are taken by MergeThreads
+        std::vector<ThreadFailure>  failures;
+        std::vector<ThreadSite>     sites;
+
+        ThreadCounts() : numAssertions(0), numFailedAssertions(0) {}
+
+        /**
+         * Queues a failure unless its assertion failed more than iLimit times on this 
+         * thread, 0 to queue all of them
+         */
+        void Queue(const char *ipStatement, const char *ipMessage, const char *ipFile, 
+            int iLine, int iLimit)
+        {
+            platform::ScopedLock lock(mutex);
+            if(iLimit > 0)
+            {
+                ThreadSite &site = Find(ipFile, iLine, iLimit);
+                if(++site.count > iLimit)
+                {
+                    if(site.count == iLimit + 1)
+                    {
+                        site.statement = ipStatement;
+                        site.firstMessage = ipMessage ? ipMessage : "";
+                    }
+                    site.lastMessage = ipMessage ? ipMessage : "";
+                    return;
+                }
+            }
+            ThreadFailure failure = { ipStatement, ipMessage ? ipMessage : "", ipMessage != 0, 
+                ipFile, iLine };
+            failures.push_back(failure);
+        }
+
+        ThreadSite& Find(const char *ipFile, int iLine, int iLimit)
+        {
+            for(size_t i = sites.size(); i > 0; i--)
+                if(sites[i - 1].line == iLine && sites[i - 1].file == ipFile)
+                    return sites[i - 1];
+            ThreadSite site = { ipFile, iLine, iLimit, 0, 0, "", "" };
+            sites.push_back(site);
+            return sites.back();
+        }
+    };
+
+    /**
+     * Suite whose tests are executed by the calling thread
+     */
+    static TestSuiteBase*& RunningSuite()
+    {
+        static ESINTILER_THREAD_LOCAL TestSuiteBase *pSuite = 0;
+        return pSuite;
+    }
+
+    /**
+     * Slot of the calling thread and the serial of the suite it belongs to. Serial is 
+     * used instead of the address of the suite since a new suite may get the address
+     * of a deleted one.
+     */
+    static ThreadCounts*& CurrentSlot()
+    {
+        static ESINTILER_THREAD_LOCAL ThreadCounts *pSlot = 0;
+        return pSlot;
+    }
+
+    static long& CurrentSlotSerial()
+    {
+        static ESINTILER_THREAD_LOCAL long serial = 0;
+        return serial;
+    }
+
+    static volatile long& Serials()
+    {
+        static volatile long serials = 0;
+        return serials;
+    }
+
+    ThreadCounts& ThreadSlot()
+    {
+        if(ESINTILER_UNLIKELY(CurrentSlotSerial() != m_serial))
+            AddThreadSlot();
+        return *CurrentSlot();
+    }
+
+    void AddThreadSlot()
+    {
+        ThreadCounts *pSlot = new ThreadCounts();
+        {
+            platform::ScopedLock lock(m_threadMutex);
+            m_threadCounts.push_back(pSlot);
+        }
+        CurrentSlot() = pSlot;
+        CurrentSlotSerial() = m_serial;
+    }
+
+    long                        m_serial;
+    platform::Mutex             m_threadMutex;
+    std::vector<ThreadCounts*>  m_threadCounts;
+};
+
+/**
+ * Tests of a suite class in the order of their definition. Test objects are static, one
+ * for each TEST, and they link themselves to the list of their suite when the application
+ * is loaded. Registration does not allocate anything, so the tests can be listed and
+ * selected by name before any suite is constructed. Tests of an inactive suite are not 
+ * registered.
+ */
+template<class SuiteName>
+struct TestCatalog
+{
+    static TestBase *first;
+    static TestBase *last;
+
+    static void Register(TestBase &ioTest, int iOrder, bool iActive)
+    {
+        if(!iActive)
+            return;
+        ioTest.order = iOrder;
+        if(!last || last->order <= iOrder)
+        {
+            //tests of a file are usually loaded in the order of their definition
+            (last ? last->next : first) = &ioTest;
+            last = &ioTest;
+            return;
+        }
+        TestBase **ppNext = &first;
+        while((*ppNext)->order <= iOrder)
+            ppNext = &(*ppNext)->next;
+        ioTest.next = *ppNext;
+        *ppNext = &ioTest;
+    }
+};
+
+template<class SuiteName>
+TestBase *TestCatalog<SuiteName>::first = 0;
+
+template<class SuiteName>
+TestBase *TestCatalog<SuiteName>::last = 0;
+
+/**
+ * Holds the static object of a test. Test macros refer to it, which is enough for the 
+ * compiler to create it without any code executing the test.
+ */
+template<class TestClass>
+struct TestRegistration
+{
+    static TestClass test;
+};
+
+template<class TestClass>
+TestClass TestRegistration<TestClass>::test;
+
+/**
+ * Factory object to instantiate TestSuite objects when requested. Test runners are created 
+ * as soon as application is loaded since they all have static/global instances. However a 
+ * test suite will be instantiated only when needed and it will be destroyed as soon as all 
+ * tests are executed
+ * 
+ * This is an internal class and users do not need to interact with it.
+ */
+struct TestRunnerBase
+{
+    virtual TestSuiteBase *CreateSuite() = 0;
+
+    /**
+     * First test of the suite, available without constructing it. Tests are linked by 
+     * TestBase::next.
+     */
+    virtual TestBase* Tests() = 0;
+
+    /**
+     * False for the suites defined with _TEST_SUITE
+     */
+    virtual bool Active() = 0;
+
+    /**
+     * Name of the suite as given to TEST_SUITE
+     */
+    const char *name;
+
+    /**
+     * Next runner in the order of registration, see TestManager::Register
+     */
+    TestRunnerBase *next;
+};
+
+
+/**
+ * Description of a failed statement of CHECK and ASSERT which are not given a message.
+ * Statements which know why they failed overload it, e.g. the bulk checks of numeric.h.
+ */
+template<class StatementType>
+inline const char* FailureMessage(const StatementType &iStatement)
+{
+    return 0;
+}
+
+class Evaluator 
+{
+public:
+    class Exception : public std::exception
+    {
+      virtual const char* what() const throw()
+      {
+        return "Evaluator Exception";
+      }
+    };
+
+    Evaluator(Logger *iLogger,
+        int iRaiseException, 
+        int &ioNumAssertions, 
+        int &ioNumFailedAssertions,
+        const char *iFile,
+        int iLine)
+    : logger(iLogger)
+    , raiseException(iRaiseException)
+    , numAssertions(ioNumAssertions)
+    , numFailedAssertions(ioNumFailedAssertions)
+    , file(iFile)
+    , line(iLine)
+    , testSuite(0)
+    {}
+
+    /**
+     * Counts on the suite so checks can be made from any thread of the test, this is 
+     * what CHECK and ASSERT use
+     */
+    Evaluator(TestSuiteBase *ipSuite,
+        int iRaiseException, 
+        const char *iFile,
+        int iLine)
+    : logger(ipSuite->logger)
+    , raiseException(iRaiseException)
+    , numAssertions(ipSuite->numAssertions)
+    , numFailedAssertions(ipSuite->numFailedAssertions)
+    , file(iFile)
+    , line(iLine)
+    , testSuite(ipSuite)
+    {}
+
+    template<typename ValueType>
+    void True(ValueType statement, const char* msg=0) {
+        if(testSuite)
+            testSuite->CountAssertion();
+        else
+            numAssertions ++;
+        if(ESINTILER_UNLIKELY(!(statement)))
+            Failed(msg ? msg : FailureMessage(statement));
+    }
+    
+private:
+    /**
+     * Out of line so only the counter and the branch are inlined at each check
+     */
+    ESINTILER_COLD void Failed(const char* msg)
+    {
+        if(testSuite)
+            testSuite->AssertionFailed(0, msg, file, line);
+        else
+        {
+            numFailedAssertions++;
+            FailureRecord failure = { 0, msg, file, line, "", "" };
+            logger->failure(failure);
+        }
+        if(raiseException)
+            throw Exception(); 
+    }
+
+    Logger *logger;
+    int raiseException;
+    int &numAssertions;
+    int &numFailedAssertions;
+    const char* file;
+    int         line;
+    TestSuiteBase *testSuite;
+};
+
+/**
+ * Base of the tests defined with TEST_CONCURRENT. Execute starts the threads, they wait 
+ * on a barrier so they all start at the same time and each one repeats the body the 
+ * given number of times. Assertions of the threads are counted by the suite (see 
+ * TestSuiteBase::CountAssertion). A thread stops at its first failing ASSERT, a failing
+ * ASSERT_THAT only ends the iteration.
+ *
+ * Once all threads are completed the wall time of the test and the throughput of each
+ * thread are logged:
+ *
+    ...Concurrent (4 threads x 100000 iterations): wall 12.30 ms
+    ...Thread 0: 11.90 ms, 8.40e+06 iterations/s
+ */
+struct ConcurrentTestBase : public TestBase
+{
+    ConcurrentTestBase(const char *iName, int iThreads, long iIterations)
+        : TestBase(iName)
+        , threads(iThreads > 0 ? iThreads : 1)
+        , iterations(iIterations)
+    {}
+
+    /**
+     * Executes the body iIterations times on the given thread, defined by the macro
+     */
+    virtual void Run(TestSuiteBase *ipSuite, int iThread, long iIterations) = 0;
+
+    void Execute(TestSuiteBase *ipSuite)
+    {
+        platform::Barrier barrier(threads);
+        std::vector<Worker*> workers;
+        for(int i = 0; i < threads; i++)
+        {
+            Worker *pWorker = new Worker(this, ipSuite, &barrier, i);
+            if(!pWorker->Start())
+            {
+                //could not get a thread, run its share here without holding the others
+                barrier.Arrive();
+                pWorker->barrier = 0;
+                pWorker->Run();
+            }
+            workers.push_back(pWorker);
+        }
+        for(int i = 0; i < threads; i++)
+            workers[i]->Join();
+
+        double start = workers[0]->start;
+        double end = workers[0]->end;
+        for(int i = 1; i < threads; i++)
+        {
+            start = workers[i]->start < start ? workers[i]->start : start;
+            end = workers[i]->end > end ? workers[i]->end : end;
+        }
+        char pBuf[256];
+        sprintf_s(pBuf, "...Concurrent (%i threads x %li iterations): wall %s", threads, iterations, 
+            BenchmarkResult::Format(end - start).c_str());
+        ipSuite->logger->log(pBuf);
+        for(int i = 0; i < threads; i++)
+        {
+            double seconds = workers[i]->end - workers[i]->start;
+            sprintf_s(pBuf, "...Thread %i: %s, %.2e iterations/s", i, 
+                BenchmarkResult::Format(seconds).c_str(), 
+                seconds > 0 ? workers[i]->completed / seconds : 0.0);
+            ipSuite->logger->log(pBuf);
+            delete workers[i];
+        }
+    }
+
+    const int   threads;
+    const long  iterations;
+
+private:
+    struct Worker : public platform::Thread
+    {
+        Worker(ConcurrentTestBase *ipTest, TestSuiteBase *ipSuite, platform::Barrier *ipBarrier, 
+            int iIndex)
+            : test(ipTest), suite(ipSuite), barrier(ipBarrier), index(iIndex)
+            , start(0), end(0), completed(0)
+        {}
+
+        void Run()
+        {
+            if(barrier)
+                barrier->Wait();
+            start = platform::Now();
+            try{
+                test->Run(suite, index, test->iterations);
+                completed = test->iterations;
+            }
+            catch(Evaluator::Exception &e){
+            }
+            end = platform::Now();
+        }
+
+        ConcurrentTestBase  *test;
+        TestSuiteBase       *suite;
+        platform::Barrier   *barrier;
+        int                 index;
+        double              start;
+        double              end;
+        long                completed;
+    };
+};
+
+
+
+/**
+ * Wall times of the suites and tests measured by the previous runs. Manager uses them 
+ * to start the longest work first and to balance the shards by duration instead of by 
+ * number of tests. Times are kept in a small text file, one entry per line:
+ *
+ *     <seconds>\t<suite>\t<test>
+ *
+ * where test is empty for the suite entries. New measurements are averaged with the 
+ * stored ones to damp the noise, entries which are not measured are kept as they are.
+ *
+ * Shards of a run have to read the same history to agree on their tests, so a sharded
+ * run does not rewrite the file. Each shard saves its own measurements instead and they 
+ * are merged into the history once all shards are completed:
+ *
+ *     History history;
+ *     history.Load("history.txt");
+ *     history.Merge("history.txt.shard0");
+ *     history.Merge("history.txt.shard1");
+ *     history.Save("history.txt");
+ */
+class History
+{
+public:
+    History() : m_enabled(false) {}
+
+    /**
+     * Measurements are only recorded if the history is enabled
+     */
+    bool Enabled() const { return m_enabled; }
+    void Enable(bool iEnabled) { m_enabled = iEnabled; }
+
+    /**
+     * Replaces the content with the given file, returns false if it can not be read
+     */
+    bool Load(const char *ipFile)
+    {
+        platform::ScopedLock lock(m_mutex);
+        m_times.clear();
+        m_measured.clear();
+        m_suites = Total();
+        m_tests = Total();
+        return Read(ipFile);
+    }
+
+    /**
+     * Replaces the entries given in the file, e.g. the measurements saved by a shard. 
+     * Returns false if it can not be read.
+     */
+    bool Merge(const char *ipFile)
+    {
+        platform::ScopedLock lock(m_mutex);
+        return Read(ipFile);
+    }
+
+    /**
+     * Writes the entries to the file, only the ones recorded since the history is loaded
+     * if iMeasured is true
+     */
+    bool Save(const char *ipFile, bool iMeasured = false) const
+    {
+        platform::ScopedLock lock(m_mutex);
+        FILE *pFile = platform::OpenFile(ipFile, "w");
+        if(!pFile)
+            return false;
+
+        TimeMap::const_iterator it = m_times.begin();
+        for(; it != m_times.end(); it++)
+            if(!iMeasured || m_measured.count(it->first))
+                fprintf(pFile, "%.6f\t%s\n", it->second, it->first.c_str());
+        fclose(pFile);
+        return true;
+    }
+
+    /**
+     * Hash of the entries as they are saved, shards reading the same file have the same 
+     * fingerprint
+     */
+    unsigned int Fingerprint() const
+    {
+        platform::ScopedLock lock(m_mutex);
+        unsigned int hash = 2166136261u;   //FNV-1a
+        TimeMap::const_iterator it = m_times.begin();
+        for(; it != m_times.end(); it++)
+        {
+            char pBuf[4096];
+            sprintf_s(pBuf, "%.6f\t%s\n", it->second, it->first.c_str());
+            for(const char *pChar = pBuf; *pChar; pChar++)
+                hash = (hash ^ (unsigned char)*pChar) * 16777619u;
+        }
+        return hash;
+    }
+
+    /**
+     * Number of the entries
+     */
+    size_t Size() const
+    {
+        platform::ScopedLock lock(m_mutex);
+        return m_times.size();
+    }
+
+    /**
+     * Stores a new measurement, test is NULL for suite entries
+     */
+    void Record(const char *ipSuite, const char *ipTest, double iSeconds)
+    {
+        if(!m_enabled)
+            return;
+        std::string key = Key(ipSuite, ipTest);
+        platform::ScopedLock lock(m_mutex);
+        TimeMap::const_iterator it = m_times.find(key);
+        Set(key, it == m_times.end() ? iSeconds : (it->second + iSeconds) / 2);
+        m_measured.insert(key);
+    }
+
+    /**
+     * Expected duration of the suite or test, average of the known entries of the same 
+     * kind if it is not in the history and 0 if the history is empty
+     */
+    double Predict(const char *ipSuite, const char *ipTest) const
+    {
+        std::string key = Key(ipSuite, ipTest);
+        platform::ScopedLock lock(m_mutex);
+        TimeMap::const_iterator it = m_times.find(key);
+        if(it != m_times.end())
+            return it->second;
+        return ipTest ? m_tests.Average() : m_suites.Average();
+    }
+
+    bool Empty() const
+    {
+        platform::ScopedLock lock(m_mutex);
+        return m_times.empty();
+    }
+
+    /**
+     * Exchanges the entries and the state with the other history
+     */
+    void Swap(History &ioOther)
+    {
+        platform::ScopedLock lock(m_mutex);
+        platform::ScopedLock otherLock(ioOther.m_mutex);
+        m_times.swap(ioOther.m_times);
+        m_measured.swap(ioOther.m_measured);
+        std::swap(m_suites, ioOther.m_suites);
+        std::swap(m_tests, ioOther.m_tests);
+        std::swap(m_enabled, ioOther.m_enabled);
+    }
+
+    /**
+     * Unique key of a suite or test, also used by the shard assignment
+     */
+    static std::string Key(const char *ipSuite, const char *ipTest)
+    {
+        std::string key = Clean(ipSuite);
+        key += '\t';
+        if(ipTest)
+            key += Clean(ipTest);
+        return key;
+    }
+
+private:
+    //Adds the entries of the file, lock should be held by the caller
+    bool Read(const char *ipFile)
+    {
+        FILE *pFile = platform::OpenFile(ipFile, "r");
+        if(!pFile)
+            return false;
+
+        char pLine[4096];
+        while(fgets(pLine, sizeof(pLine), pFile))
+        {
+            char *pSuite = strchr(pLine, '\t');
+            char *pTest = pSuite ? strchr(pSuite + 1, '\t') : 0;
+            if(!pTest)
+                continue;
+            char *pEnd = pTest + strcspn(pTest, "\r\n");
+            *pEnd = 0;
+            Set(std::string(pSuite + 1, pEnd), atof(pLine));
+        }
+        fclose(pFile);
+        return true;
+    }
+
+    //Separators can not be a part of the names
+    static std::string Clean(const char *ipName)
+    {
+        std::string name(ipName);
+        for(size_t i = 0; i < name.size(); i++)
+            if(name[i] == '\t' || name[i] == '\n' || name[i] == '\r')
+                name[i] = ' ';
+        return name;
+    }
+
+    /**
+     * Sum of the entries of a kind, Predict returns their average for unknown entries
+     */
+    struct Total
+    {
+        Total() : seconds(0), count(0) {}
+        double Average() const { return count ? seconds / count : 0; }
+        double  seconds;
+        int     count;
+    };
+
+    //Adds or replaces the entry, lock should be held by the caller
+    void Set(const std::string &iKey, double iSeconds)
+    {
+        Total &total = iKey[iKey.size() - 1] == '\t' ? m_suites : m_tests;
+        std::pair<TimeMap::iterator, bool> inserted = m_times.insert(std::make_pair(iKey, iSeconds));
+        if(inserted.second)
+            total.count ++;
+        else
+            total.seconds -= inserted.first->second;
+        total.seconds += iSeconds;
+        inserted.first->second = iSeconds;
+    }
+
+    typedef std::map<std::string, double> TimeMap;
+    TimeMap                 m_times;
+    std::set<std::string>   m_measured;     //keys recorded since the last Load
+    Total                   m_suites;
+    Total                   m_tests;
+    mutable platform::Mutex m_mutex;
+    bool                    m_enabled;
+
+    History(const History&);
+    History& operator=(const History&);
+};
+
+
+/**
+ * Samples of the benchmarks measured by a previous run. A benchmark is failed if it is 
+ * significantly slower than its baseline, see TestManager::RunBenchmark. Content is only
+ * modified before and after the suites are executed, it is read by the workers without 
+ * any locking.
+ */
+class Baseline
+{
+public:
+    /**
+     * Adds the content of the given file, existing entries with the same name are 
+     * replaced. Returns false if it can not be read
+     */
+    bool Load(const char *ipFile)
+    {
+        FILE *pFile = platform::OpenFile(ipFile, "r");
+        if(!pFile)
+            return false;
+
+        std::string line;
+        char pBuf[4096];
+        while(fgets(pBuf, sizeof(pBuf), pFile))
+        {
+            line += pBuf;
+            if(line[line.size() - 1] != '\n' && !feof(pFile))
+                continue;
+
+            size_t tab = line.find('\t');
+            if(tab != std::string::npos)
+            {
+                std::vector<double> samples;
+                std::string values = line.substr(0, tab);
+                const char *pValue = values.c_str();
+                char *pEnd = 0;
+                for(double value = strtod(pValue, &pEnd); pEnd != pValue; value = strtod(pValue, &pEnd))
+                {
+                    samples.push_back(value);
+                    pValue = pEnd;
+                }
+                size_t end = line.find_last_not_of("\r\n");
+                m_samples[line.substr(tab + 1, end - tab)] = samples;
+            }
+            line.clear();
+        }
+        fclose(pFile);
+        return true;
+    }
+
+    bool Save(const char *ipFile) const
+    {
+        FILE *pFile = platform::OpenFile(ipFile, "w");
+        if(!pFile)
+            return false;
+
+        SampleMap::const_iterator it = m_samples.begin();
+        for(; it != m_samples.end(); it++)
+        {
+            for(size_t i = 0; i < it->second.size(); i++)
+                fprintf(pFile, i ? " %.6g" : "%.6g", it->second[i]);
+            fprintf(pFile, "\t%s\n", it->first.c_str());
+        }
+        fclose(pFile);
+        return true;
+    }
+
+    void Record(const BenchmarkResult &iResult)
+    {
+        m_samples[History::Key(iResult.suite.c_str(), iResult.test.c_str())] = iResult.samples;
+    }
+
+    /**
+     * Samples of the benchmark, NULL if it is not in the baseline
+     */
+    const std::vector<double>* Samples(const char *ipSuite, const char *ipTest) const
+    {
+        SampleMap::const_iterator it = m_samples.find(History::Key(ipSuite, ipTest));
+        return it != m_samples.end() ? &it->second : 0;
+    }
+
+    bool Empty() const { return m_samples.empty(); }
+
+    void Clear() { m_samples.clear(); }
+
+    /**
+     * One sided Mann-Whitney U test. Returns the probability of observing the given 
+     * difference if the new samples were not larger (slower) than the baseline samples,
+     * it uses the normal approximation with the tie correction.
+     */
+    static double MannWhitney(const std::vector<double> &iBase, const std::vector<double> &iNew)
+    {
+        size_t n1 = iBase.size();
+        size_t n2 = iNew.size();
+        if(n1 == 0 || n2 == 0)
+            return 1;
+
+        //rank all samples together, ties get the average of their ranks
+        std::vector<std::pair<double, int> > all;
+        for(size_t i = 0; i < n1; i++)
+            all.push_back(std::make_pair(iBase[i], 0));
+        for(size_t i = 0; i < n2; i++)
+            all.push_back(std::make_pair(iNew[i], 1));
+        std::sort(all.begin(), all.end());
+
+        double n = (double)all.size();
+        double rankSum = 0;
+        double ties = 0;
+        for(size_t i = 0; i < all.size();)
+        {
+            size_t j = i;
+            while(j < all.size() && all[j].first == all[i].first)
+                j++;
+            double rank = (i + 1 + j) / 2.0;
+            for(size_t k = i; k < j; k++)
+                if(all[k].second == 1)
+                    rankSum += rank;
+            double t = (double)(j - i);
+            ties += t * t * t - t;
+            i = j;
+        }
+
+        double u = rankSum - n2 * (n2 + 1) / 2.0;
+        double mean = n1 * n2 / 2.0;
+        double variance = n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1)));
+        if(variance <= 0)
+            return 1;
+        double z = (u - mean - 0.5) / sqrt(variance);
+        return 1 - NormalCdf(z);
+    }
+
+private:
+    /**
+     * Cumulative distribution function of the standard normal distribution, Abramowitz 
+     * and Stegun 26.2.17 (error < 7.5e-8). erfc is not available in every runtime.
+     */
+    static double NormalCdf(double iZ)
+    {
+        double x = iZ < 0 ? -iZ : iZ;
+        double t = 1 / (1 + 0.2316419 * x);
+        double poly = t * (0.319381530 + t * (-0.356563782 + t * (1.781477937 + t * (-1.821255978 + t * 1.330274429))));
+        double upper = 0.3989422804014327 * exp(-x * x / 2) * poly;
+        return iZ < 0 ? upper : 1 - upper;
+    }
+
+    typedef std::map<std::string, std::vector<double> > SampleMap;
+    SampleMap m_samples;
+};
+
+
+/**
+ * Work stealing pool of threads. Tasks are identified by their index and given to the 
+ * pool in priority order. Each worker has its own queue which is filled in round robin 
+ * fashion, a worker consumes its own queue from the front and once it is empty it steals 
+ * from the back of the busiest queue. 
+ *
+ * Derived classes implement Execute() which is called on the worker threads.
+ */
+class WorkerPool
+{
+public:
+    WorkerPool() {}
+
+    virtual ~WorkerPool()
+    {
+        Join();
+    }
+
+    /**
+     * Called by a worker thread for each task. 
+     * 
+     * @iTask: Index of the task as given to Start()
+     * @iWorker: Index of the worker thread, [0, numWorkers)
+     */
+    virtual void Execute(int iTask, int iWorker) = 0;
+
+    /**
+     * Distributes the tasks to the worker queues and starts the threads. It returns 
+     * immediately, call Join() to wait for all tasks to finish
+     */
+    void Start(const std::vector<int> &iTasks, int iNumWorkers)
+    {
+        if(iNumWorkers < 1)
+            iNumWorkers = 1;
+        for(int i = 0; i < iNumWorkers; i++)
+            m_queues.push_back(new Queue());
+        for(unsigned int i = 0; i < iTasks.size(); i++)
+            m_queues[i % iNumWorkers]->tasks.push_back(iTasks[i]);
+        for(int i = 0; i < iNumWorkers; i++)
+        {
+            m_workers.push_back(new Worker(this, i));
+            m_workers.back()->Start();
+        }
+    }
+
+    /**
+     * Waits until all the tasks are executed and releases the threads
+     */
+    void Join()
+    {
+        for(unsigned int i = 0; i < m_workers.size(); i++)
+        {
+            m_workers[i]->Join();
+            delete m_workers[i];
+        }
+        m_workers.clear();
+        for(unsigned int i = 0; i < m_queues.size(); i++)
+            delete m_queues[i];
+        m_queues.clear();
+    }
+
+private:
+    struct Queue
+    {
+        platform::Mutex mutex;
+        std::deque<int> tasks;
+    };
+
+    struct Worker : public platform::Thread
+    {
+        Worker(WorkerPool *ipPool, int iIndex) : pool(ipPool), index(iIndex) {}
+        void Run()
+        {
+            int task = 0;
+            while(pool->Next(index, task))
+                pool->Execute(task, index);
+        }
+        WorkerPool *pool;
+        int index;
+    };
+
+    /**
+     * Picks the next task for the given worker, own queue first then steals from others
+     */
+    bool Next(int iWorker, int &oTask)
+    {
+        {
+            Queue *pQueue = m_queues[iWorker];
+            platform::ScopedLock lock(pQueue->mutex);
+            if(!pQueue->tasks.empty())
+            {
+                oTask = pQueue->tasks.front();
+                pQueue->tasks.pop_front();
+                return true;
+            }
+        }
+        for(;;)
+        {
+            Queue *pVictim = 0;
+            size_t maxSize = 0;
+            for(unsigned int i = 0; i < m_queues.size(); i++)
+            {
+                platform::ScopedLock lock(m_queues[i]->mutex);
+                size_t size = m_queues[i]->tasks.size();
+                if(size > maxSize)
+                {
+                    maxSize = size;
+                    pVictim = m_queues[i];
+                }
+            }
+            if(pVictim == 0)
+                return false;
+
+            platform::ScopedLock lock(pVictim->mutex);
+            if(!pVictim->tasks.empty())
+            {
+                oTask = pVictim->tasks.back();
+                pVictim->tasks.pop_back();
+                return true;
+            }
+        }
+    }
+
+    std::vector<Queue*>  m_queues;
+    std::vector<Worker*> m_workers;
+
+    WorkerPool(const WorkerPool&);
+    WorkerPool& operator=(const WorkerPool&);
+};
+
+
+/**
+ * Selects the tests by their "Suite.Test" names, a suite without any test is named by 
+ * itself. Filter is a comma separated list of patterns, a name is selected if it matches
+ * any of the patterns and none of the ones starting with '-' (only exclusions select all
+ * the other names). A pattern is either a glob which should match the whole name ('*' 
+ * for any text, '?' for any character) or a regular expression between slashes which 
+ * is searched in the name:
+ *
+ *     Parser*,-*.slow*
+ *     /^Parser\.(parse|skip)/
+ *
+ * Regular expressions support . [] [^] * + ? ^ $ | \ and groups, quantifiers can not
+ * be applied to the groups. It is enough to pick tests by their names.
+ */
+class NameFilter
+{
+public:
+    NameFilter(const char *ipFilter)
+    {
+        const char *p = ipFilter ? ipFilter : "";
+        while(*p)
+        {
+            Pattern pattern;
+            pattern.exclude = *p == '-';
+            if(pattern.exclude)
+                p++;
+            pattern.regex = *p == '/';
+            if(pattern.regex)
+            {
+                p++;
+                for(; *p && *p != '/'; p++)
+                {
+                    if(*p == '\\' && p[1])
+                        pattern.text += *p++;
+                    pattern.text += *p;
+                }
+                if(*p == '/')
+                    p++;
+            }
+            for(; *p && *p != ','; p++)
+                pattern.text += *p;
+            if(*p == ',')
+                p++;
+            m_patterns.push_back(pattern);
+        }
+    }
+
+    bool Matches(const std::string &iName) const
+    {
+        bool included = true;
+        for(size_t i = 0; i < m_patterns.size(); i++)
+        {
+            if(!m_patterns[i].exclude)
+            {
+                included = false;
+                break;
+            }
+        }
+        for(size_t i = 0; i < m_patterns.size(); i++)
+        {
+            const Pattern &pattern = m_patterns[i];
+            bool match = pattern.regex ? Search(pattern.text.c_str(), iName.c_str()) : 
+                Glob(pattern.text.c_str(), iName.c_str());
+            if(match && pattern.exclude)
+                return false;
+            included |= match;
+        }
+        return included;
+    }
+
+    /**
+     * Returns true if the glob matches the whole text
+     */
+    static bool Glob(const char *ipGlob, const char *ipText)
+    {
+        const char *pStar = 0;
+        const char *pResume = 0;
+        while(*ipText)
+        {
+            if(*ipGlob == '*')
+            {
+                pStar = ipGlob++;
+                pResume = ipText;
+            }
+            else if(*ipGlob == '?' || *ipGlob == *ipText)
+            {
+                ipGlob++;
+                ipText++;
+            }
+            else if(pStar)
+            {
+                ipGlob = pStar + 1;
+                ipText = ++pResume;
+            }
+            else
+                return false;
+        }
+        while(*ipGlob == '*')
+            ipGlob++;
+        return *ipGlob == 0;
+    }
+
+    /**
+     * Returns true if the regular expression matches any part of the text
+     */
+    static bool Search(const char *ipRegex, const char *ipText)
+    {
+        if(*ipRegex == '^')
+            return MatchAlternatives(ipRegex + 1, End(ipRegex + 1), ipText);
+        do
+        {
+            if(MatchAlternatives(ipRegex, End(ipRegex), ipText))
+                return true;
+        } while(*ipText++);
+        return false;
+    }
+
+private:
+    struct Pattern
+    {
+        bool        exclude;
+        bool        regex;
+        std::string text;
+    };
+
+    static const char* End(const char *ipRegex)
+    {
+        return ipRegex + strlen(ipRegex);
+    }
+
+    /**
+     * Length of the atom at the start of the regex: a character, an escape, a class or a
+     * group
+     */
+    static size_t AtomLength(const char *ipRegex, const char *ipEnd)
+    {
+        const char *p = ipRegex;
+        if(*p == '\\' && p + 1 < ipEnd)
+            return 2;
+        if(*p == '[')
+        {
+            p++;
+            if(p < ipEnd && *p == '^')
+                p++;
+            if(p < ipEnd && *p == ']')
+                p++;
+            while(p < ipEnd && *p != ']')
+                p += (*p == '\\' && p + 1 < ipEnd) ? 2 : 1;
+            return (p < ipEnd ? p + 1 : ipEnd) - ipRegex;
+        }
+        if(*p == '(')
+            return Close(p, ipEnd) - ipRegex;
+        return 1;
+    }
+
+    /**
+     * Position after the group starting at the given parenthesis
+     */
+    static const char* Close(const char *ipOpen, const char *ipEnd)
+    {
+        int depth = 0;
+        for(const char *p = ipOpen; p < ipEnd; p++)
+        {
+            if(*p == '\\')
+                p++;
+            else if(*p == '[')
+                p += AtomLength(p, ipEnd) - 1;
+            else if(*p == '(')
+                depth++;
+            else if(*p == ')' && --depth == 0)
+                return p + 1;
+        }
+        return ipEnd;
+    }
+
+    /**
+     * Returns true if the single character atom matches the character
+     */
+    static bool MatchCharacter(const char *ipAtom, size_t iLength, char iChar)
+    {
+        if(iChar == 0)
+            return false;
+        if(*ipAtom == '.')
+            return true;
+        if(*ipAtom == '\\')
+            return ipAtom[1] == iChar;
+        if(*ipAtom != '[')
+            return *ipAtom == iChar;
+
+        const char *p = ipAtom + 1;
+        const char *pEnd = ipAtom + iLength - 1;
+        bool negate = *p == '^';
+        if(negate)
+            p++;
+        bool match = false;
+        while(p < pEnd)
+        {
+            char low = *p == '\\' ? *++p : *p;
+            char high = low;
+            if(p + 2 < pEnd && p[1] == '-')
+            {
+                p += 2;
+                high = *p == '\\' ? *++p : *p;
+            }
+            match |= low <= iChar && iChar <= high;
+            p++;
+        }
+        return match != negate;
+    }
+
+    /**
+     * Matches one of the '|' separated alternatives of [ipRegex, ipEnd) at the start of 
+     * the text, the rest of the regex after a group is given as ipNext
+     */
+    static bool MatchAlternatives(const char *ipRegex, const char *ipEnd, const char *ipText, 
+        const char *ipNext = 0, const char *ipNextEnd = 0)
+    {
+        const char *pStart = ipRegex;
+        const char *p = ipRegex;
+        while(p <= ipEnd)
+        {
+            if(p == ipEnd || *p == '|')
+            {
+                if(Match(pStart, p, ipText, ipNext, ipNextEnd))
+                    return true;
+                pStart = p + 1;
+                p++;
+            }
+            else
+                p += AtomLength(p, ipEnd);
+        }
+        return false;
+    }
+
+    /**
+     * Matches [ipRegex, ipEnd) followed by [ipNext, ipNextEnd) at the start of the text
+     */
+    static bool Match(const char *ipRegex, const char *ipEnd, const char *ipText, 
+        const char *ipNext, const char *ipNextEnd)
+    {
+        if(ipRegex == ipEnd)
+            return ipNext ? Match(ipNext, ipNextEnd, ipText, 0, 0) : true;
+        if(*ipRegex == '$' && ipRegex + 1 == ipEnd && !ipNext)
+            return *ipText == 0;
+
+        size_t length = AtomLength(ipRegex, ipEnd);
+        const char *pRest = ipRegex + length;
+        if(*ipRegex == '(')
+        {
+            //groups are matched in place, the rest is the continuation of the group
+            const char *pRestEnd = ipEnd;
+            std::string rest(pRest, pRestEnd);
+            if(ipNext)
+                rest.append(ipNext, ipNextEnd);
+            return MatchAlternatives(ipRegex + 1, pRest - 1, ipText, rest.c_str(), 
+                rest.c_str() + rest.size());
+        }
+
+        char quantifier = pRest < ipEnd ? *pRest : 0;
+        if(quantifier == '*' || quantifier == '+' || quantifier == '?')
+        {
+            size_t count = 0;
+            size_t max = quantifier == '?' ? 1 : (size_t)-1;
+            while(count < max && MatchCharacter(ipRegex, length, ipText[count]))
+                count++;
+            size_t min = quantifier == '+' ? 1 : 0;
+            for(size_t i = count + 1; i-- > min; )
+                if(Match(pRest + 1, ipEnd, ipText + i, ipNext, ipNextEnd))
+                    return true;
+            return false;
+        }
+        return MatchCharacter(ipRegex, length, *ipText) && 
+            Match(pRest, ipEnd, ipText + 1, ipNext, ipNextEnd);
+    }
+
+    std::vector<Pattern> m_patterns;
+};
+
+/**
+ * User interacts with this class to run a single test suite or all of them
+ *
+ * Suites are executed one by one on the calling thread by default. If "--jobs N" is given 
+ * as an argument (see args) or ESINTILER_JOBS is set in the environment, suites are 
+ * distributed to N worker threads instead. "--jobs 0" uses one worker per processor. The 
+ * log of each suite is buffered and passed to the logger in registration order so the 
+ * output, the return value and the assertion totals are same as a serial run.
+ *
+ * "--processes N" (or ESINTILER_PROCESSES) executes the suites in N forked worker 
+ * processes instead. A crashing test is reported as failed, the worker is replaced and 
+ * the remaining tests of the suite continue in the new worker. It is only available 
+ * where fork is supported, suites are executed in process otherwise.
+ *
+ * "--history <file>" (or ESINTILER_HISTORY) keeps the durations of the suites and tests
+ * in the given file (see History). When it is given, the longest suites are started 
+ * first, the tests of a suite are split to its Workers by duration and the shards are
+ * balanced by duration. Shards use the same assignment only if they read the same file:
+ * each shard logs the fingerprint of the history it read, and a sharded run saves its 
+ * measurements to "<file>.shard<I>" instead of the file (see History::Merge).
+ *
+ * "--timeout <seconds>" (or ESINTILER_TIMEOUT) gives each test a time budget, see 
+ * DefaultTimeout.
+ *
+ * "--run tests" or "--run benchmarks" (or ESINTILER_RUN) executes only the tests or only 
+ * the benchmarks of the suites, both are executed by default. See RunBenchmark for the 
+ * options of the benchmarks and BaselineFile for the regression checks.
+ *
+ * "--junit <file>" and "--jsonl <file>" (or ESINTILER_JUNIT and ESINTILER_JSONL) also 
+ * write the results to the given files as they are completed, see JUnitFile.
+ *
+ * "--filter <patterns>" (or ESINTILER_FILTER) executes only the tests whose "Suite.Test"
+ * names match the patterns, see NameFilter. Tests are selected from their TestCatalog so the
+ * suites without any selected test are never constructed. "--list" (or ESINTILER_LIST)
+ * logs the names of the selected tests instead of executing them.
+ */
+class TestManager
+{
+public:
+    typedef std::vector<std::pair<std::string, TestRunnerBase*>>  TestRunnerList;
+
+    /**
+     * Utility method to store the command line arrgumens if they need to be accessed
+     * Note that this method can be called multiple times, each call will modify on top
+     * of the previously stored values. 
+     * It returns a ref so caller can actually append to args 
+     * call without parameters to retrieve the current values
+     */
+    typedef std::map<std::string, std::string> ArgumentList;
+    static ArgumentList & args(int argc = 0, char *argv[] = NULL)
+    {
+        static ArgumentList args;
+        if(argc > 1 && argv != NULL)
+        {
+            if(argc % 2 != 1){ //First one is always the application name
+                //cout << "Can't parse arguments, it should be given as '-key value' pairs such as: " << endl;
+                //cout << " app input <input folder>  output <output folder> test <testname>" << endl;
+            }
+            for(int i = 1; i < argc; i += 2)
+            {
+                //an option without a value, like "--list", is set to "1"
+                if(strncmp(argv[i], "--", 2) == 0 && (i + 1 == argc || strncmp(argv[i + 1], "--", 2) == 0))
+                {
+                    args[argv[i]] = "1";
+                    i--;
+                    continue;
+                }
+                args[argv[i]] = argv[i + 1];
+            }
+        }
+        return args;
+    }
+    //Use to access to the individual argument values, it will return NULL of value is not there
+    static const char* arg(const char* name)
+    {
+        return args()[name].c_str();
+    }
+
+    /**
+     * Returns the value of a runner option. Command line arguments (see args) have priority
+     * over the environment variable. It returns NULL if option is not given in either way.
+     */
+    static const char* option(const char* name, const char* envName)
+    {
+        ArgumentList &arguments = args();
+        ArgumentList::const_iterator it = arguments.find(name);
+        if(it != arguments.end() && !it->second.empty())
+            return it->second.c_str();
+        const char *pEnv = envName ? getenv(envName) : NULL;
+        if(pEnv && *pEnv)
+            return pEnv;
+        return NULL;
+    }
+
+    /**
+     * Integer version of option(), iDefault is returned if option is not given
+     */
+    static int intOption(const char* name, const char* envName, int iDefault)
+    {
+        const char *pValue = option(name, envName);
+        return pValue ? atoi(pValue) : iDefault;
+    }
+
+    /**
+     * Number of worker threads to be used for suite execution
+     */
+    static int Jobs()
+    {
+        int jobs = intOption("--jobs", "ESINTILER_JOBS", 1);
+        if(jobs <= 0)
+            jobs = platform::CpuCount();
+        return jobs;
+    }
+
+    /**
+     * Number of worker processes to be used for suite execution, 0 if suites should be 
+     * executed in this process
+     */
+    static int Processes()
+    {
+        if(!platform::HasFork)
+            return 0;
+        int processes = intOption("--processes", "ESINTILER_PROCESSES", 0);
+        if(processes < 0)
+            processes = platform::CpuCount();
+        return processes;
+    }
+
+    /**
+     * File to keep the durations of the suites and tests, NULL if not given
+     */
+    static const char* HistoryFile()
+    {
+        return option("--history", "ESINTILER_HISTORY");
+    }
+
+    /**
+     * File the given shard saves its measurements to, "<file>.shard<I>"
+     */
+    static std::string ShardHistoryFile(const char *ipFile, int iShardIndex)
+    {
+        char pBuf[32];
+        sprintf_s(pBuf, ".shard%i", iShardIndex);
+        return std::string(ipFile) + pBuf;
+    }
+
+    /**
+     * Durations of the previous runs, loaded from the HistoryFile
+     */
+    static History& RunHistory()
+    {
+        static History history;
+        return history;
+    }
+
+    /**
+     * File the RunHistory is loaded from, empty if none
+     */
+    static std::string& RunHistoryFile()
+    {
+        static std::string file;
+        return file;
+    }
+
+    /**
+     * Loads the RunHistory for a run and restores the one of the enclosing run. Runs 
+     * nested in the tests keep the RunHistory of the enclosing run if they are not given
+     * another file, but they do not record their fixture suites into it.
+     */
+    struct HistoryScope
+    {
+        HistoryScope(const char *ipFile) 
+            : loaded(ipFile && RunHistoryFile() != ipFile)
+            , enabled(RunHistory().Enabled())
+            , previousFile(RunHistoryFile())
+        {
+            if(loaded)
+            {
+                previous.Swap(RunHistory());
+                RunHistory().Load(ipFile);
+                RunHistory().Enable(true);
+                RunHistoryFile() = ipFile;
+            }
+            else if(!previousFile.empty())
+                RunHistory().Enable(false);
+        }
+
+        ~HistoryScope()
+        {
+            if(loaded)
+            {
+                RunHistory().Swap(previous);
+                RunHistoryFile() = previousFile;
+            }
+            RunHistory().Enable(enabled);
+        }
+
+        /**
+         * Saves the history to its file. A shard only saves its own measurements, to 
+         * the ShardHistoryFile, so the shards of the next run still read the same file.
+         */
+        void Save(int iShardIndex, int iShardCount)
+        {
+            if(!loaded)
+                return;
+            if(iShardCount <= 1)
+                RunHistory().Save(RunHistoryFile().c_str());
+            else
+                RunHistory().Save(ShardHistoryFile(RunHistoryFile().c_str(), iShardIndex).c_str(), true);
+        }
+
+        bool        loaded;
+        bool        enabled;
+        std::string previousFile;
+        History     previous;
+    };
+
+    /**
+     * Shard of the run to be executed by this process, given by "--shard-index I" and 
+     * "--shard-count N" (or ESINTILER_SHARD_INDEX and ESINTILER_SHARD_COUNT). Every test 
+     * belongs to exactly one of the N shards by the hash of its "Suite.Test" name, so 
+     * running all the shards, possibly on different machines, executes each test once. 
+     * Suites without any test are assigned by the hash of the suite name. If a history is 
+     * given (see HistoryFile), tests are assigned by their durations instead. Runs nested 
+     * in the tests are not sharded unless they are given other shard options.
+     */
+    static int ShardIndex()
+    {
+        return intOption("--shard-index", "ESINTILER_SHARD_INDEX", 0);
+    }
+
+    static int ShardCount()
+    {
+        return intOption("--shard-count", "ESINTILER_SHARD_COUNT", 1);
+    }
+
+    /**
+     * Number of the slowest tests and suites listed in the summary of the run, given by
+     * "--slowest N" (or ESINTILER_SLOWEST). 0 lists none of them.
+     */
+    static int Slowest()
+    {
+        return intOption("--slowest", "ESINTILER_SLOWEST", 10);
+    }
+
+    /**
+     * Time budget of the tests in seconds, given by "--timeout S" (or ESINTILER_TIMEOUT).
+     * 0 (default) for no limit, suites and tests can override it. A test which exceeds 
+     * its budget in a forked child or a worker process is killed and reported as failed, 
+     * the rest of the suite continues in a new process. The whole run is aborted with a 
+     * diagnostic if it is executed in this process, it is not possible to stop a single 
+     * thread safely.
+     */
+    static double DefaultTimeout()
+    {
+        const char *pValue = option("--timeout", "ESINTILER_TIMEOUT");
+        return pValue ? atof(pValue) : 0;
+    }
+
+    /**
+     * Number of failures logged for each assertion of a test, given by "--failure-limit N"
+     * (or ESINTILER_FAILURE_LIMIT), 10 by default and 0 for no limit. Further failures of 
+     * the assertion are counted and summarized at the end of the test, see FailureLimiter.
+     */
+    static int FailureLimit()
+    {
+        return intOption("--failure-limit", "ESINTILER_FAILURE_LIMIT", 10);
+    }
+
+    /**
+     * Time budget of the given test of the suite, 0 if there is no limit
+     */
+    static double Timeout(TestSuiteBase *pSuite, TestBase *pTest)
+    {
+        return Timeout(pSuite, pTest, DefaultTimeout());
+    }
+
+    /**
+     * Same as above with the given default, runs use the one of their Selection
+     */
+    static double Timeout(TestSuiteBase *pSuite, TestBase *pTest, double iDefault)
+    {
+        double timeout = pTest->timeout;
+        if(timeout < 0)
+            timeout = pSuite->Timeout();
+        if(timeout < 0)
+            timeout = iDefault;
+        return timeout > 0 ? timeout : 0;
+    }
+
+    /**
+     * Returns true if the test of the given suite should be executed in this run. If 
+     * test is NULL, it checks if a suite without any test should be executed
+     */
+    static bool Selected(const char *ipSuite, const char *ipTest)
+    {
+        const Selection &selection = RunSelection();
+        if(selection.shardCount <= 1)
+            return true;
+
+        const ShardPlan &plan = selection.plan;
+        if(plan.count == selection.shardCount)
+        {
+            std::map<std::string, int>::const_iterator it = plan.shards.find(History::Key(ipSuite, ipTest));
+            if(it != plan.shards.end())
+                return it->second == selection.shardIndex;
+        }
+
+        unsigned int hash = Hash(ipSuite);
+        if(ipTest)
+        {
+            hash = Hash(".", hash);
+            hash = Hash(ipTest, hash);
+        }
+        return (int)(hash % selection.shardCount) == selection.shardIndex;
+    }
+
+    /**
+     * Returns true if the given test (NULL for a suite without any test) of the suite 
+     * should be executed in this run, see "--run" option
+     */
+    static bool Selected(TestSuiteBase *pSuite, TestBase *pTest)
+    {
+        return Selected(pSuite->name, pTest ? pTest->name : 0, pTest && pTest->benchmark);
+    }
+
+    /**
+     * Same as above for a test which is not constructed yet, see "--run" and "--filter"
+     */
+    static bool Selected(const char *ipSuite, const char *ipTest, bool iBenchmark)
+    {
+        const Selection &selection = RunSelection();
+        if(!(iBenchmark ? selection.benchmarks : selection.tests))
+            return false;
+        if(selection.filtered)
+        {
+            std::string name(ipSuite);
+            if(ipTest)
+                name.append(".").append(ipTest);
+            if(!selection.filter.Matches(name))
+                return false;
+        }
+        return Selected(ipSuite, ipTest);
+    }
+
+    /**
+     * Assignment of the tests to the shards by their durations, keys are History keys
+     */
+    struct ShardPlan
+    {
+        ShardPlan() : count(0) {}
+        int                         count;  //0 if there is no plan
+        std::map<std::string, int>  shards;
+    };
+
+    /**
+     * "--run", "--filter", shard, timeout and failure limit options of the current run. 
+     * ExecuteSuites loads them once (see SelectionScope) so the options are not parsed 
+     * again for each test.
+     */
+    struct Selection
+    {
+        Selection() 
+            : active(false), tests(true), benchmarks(true), filtered(false), filter(0)
+            , shardIndex(0), shardCount(1), shardIndexOption(0), shardCountOption(1) 
+            , timeout(0), failureLimit(0)
+        {
+        }
+
+        /**
+         * Filter and shards of the enclosing run are not applied to the runs nested in its
+         * tests, they are only applied if the nested run is given other options
+         */
+        void Load(const Selection &iEnclosing)
+        {
+            const char *pRun = option("--run", "ESINTILER_RUN");
+            tests = !pRun || strcmp(pRun, "benchmarks") != 0;
+            benchmarks = !pRun || strcmp(pRun, "tests") != 0;
+            const char *pFilter = Filter();
+            filterOption = pFilter ? pFilter : "";
+            if(iEnclosing.active && filterOption == iEnclosing.filterOption)
+                pFilter = 0;
+            filtered = pFilter != 0;
+            filter = NameFilter(pFilter);
+
+            shardIndexOption = ShardIndex();
+            shardCountOption = ShardCount();
+            bool inherited = iEnclosing.active && shardIndexOption == iEnclosing.shardIndexOption && 
+                shardCountOption == iEnclosing.shardCountOption;
+            shardIndex = inherited ? 0 : shardIndexOption;
+            shardCount = inherited ? 1 : shardCountOption;
+            plan = ShardPlan();
+            timeout = DefaultTimeout();
+            failureLimit = FailureLimit();
+            active = true;
+        }
+
+        bool        active;     //false if there is no run
+        bool        tests;
+        bool        benchmarks;
+        bool        filtered;
+        NameFilter  filter;
+        std::string filterOption;
+        int         shardIndex; //shard executed by this run, see Selected
+        int         shardCount;
+        int         shardIndexOption;
+        int         shardCountOption;
+        ShardPlan   plan;
+        double      timeout;    //see DefaultTimeout
+        int         failureLimit;
+    };
+
+    static Selection& RunSelection()
+    {
+        static Selection selection;
+        return selection;
+    }
+
+    /**
+     * Loads the RunSelection for a run and restores the one of the enclosing run, runs
+     * nested in the tests may be given other options
+     */
+    struct SelectionScope
+    {
+        SelectionScope() : previous(RunSelection())
+        {
+            RunSelection().Load(previous);
+        }
+
+        ~SelectionScope()
+        {
+            RunSelection() = previous;
+        }
+
+        Selection previous;
+    };
+
+    /**
+     * Patterns of the tests to be executed, "--filter <patterns>" (or ESINTILER_FILTER). 
+     * NULL if all tests are executed. Runs nested in the tests are not filtered unless 
+     * they are given another filter.
+     */
+    static const char* Filter()
+    {
+        return option("--filter", "ESINTILER_FILTER");
+    }
+
+    /**
+     * True if the selected tests should only be listed, "--list" (or ESINTILER_LIST)
+     */
+    static bool ListTests()
+    {
+        return intOption("--list", "ESINTILER_LIST", 0) != 0;
+    }
+
+    /**
+     * Number of samples taken for each benchmark, "--benchmark-samples N" (or 
+     * ESINTILER_BENCHMARK_SAMPLES)
+     */
+    static int BenchmarkSamples()
+    {
+        int samples = intOption("--benchmark-samples", "ESINTILER_BENCHMARK_SAMPLES", 20);
+        return samples > 0 ? samples : 1;
+    }
+
+    /**
+     * Minimum duration of a benchmark sample in seconds, "--benchmark-time S" (or 
+     * ESINTILER_BENCHMARK_TIME). Iterations of a sample are calibrated to take this long.
+     */
+    static double BenchmarkTime()
+    {
+        const char *pValue = option("--benchmark-time", "ESINTILER_BENCHMARK_TIME");
+        double seconds = pValue ? atof(pValue) : 0.01;
+        return seconds > 0 ? seconds : 0.01;
+    }
+
+    /**
+     * File to compare the benchmarks against, "--benchmark-baseline <file>" (or 
+     * ESINTILER_BENCHMARK_BASELINE), NULL if not given
+     */
+    static const char* BaselineFile()
+    {
+        return option("--benchmark-baseline", "ESINTILER_BENCHMARK_BASELINE");
+    }
+
+    /**
+     * File to save the samples of the benchmarks, "--benchmark-save <file>" (or 
+     * ESINTILER_BENCHMARK_SAVE), NULL if not given. Benchmarks which are not executed keep
+     * their existing samples in the file so it can be the same as the BaselineFile.
+     */
+    static const char* BaselineSaveFile()
+    {
+        return option("--benchmark-save", "ESINTILER_BENCHMARK_SAVE");
+    }
+
+    /**
+     * Files to write the results as JUnit XML and as JSON Lines, given by "--junit <file>"
+     * and "--jsonl <file>" (or ESINTILER_JUNIT and ESINTILER_JSONL), NULL if not given.
+     * See JUnitReporter and JsonLinesReporter.
+     */
+    static const char* JUnitFile()
+    {
+        return option("--junit", "ESINTILER_JUNIT");
+    }
+
+    static const char* JsonLinesFile()
+    {
+        return option("--jsonl", "ESINTILER_JSONL");
+    }
+
+    /**
+     * Name of the report file of this shard. If the run is sharded, shard index is added
+     * before the extension ("results.xml" is "results.2.xml" for the shard 2) so shards 
+     * sharing a directory do not overwrite each other.
+     */
+    static std::string ReportFile(const char *ipFile)
+    {
+        return ReportFile(ipFile, ShardIndex(), ShardCount());
+    }
+
+    /**
+     * Same as above for the given shard, runs use the shard of their Selection
+     */
+    static std::string ReportFile(const char *ipFile, int iShardIndex, int iShardCount)
+    {
+        std::string file(ipFile);
+        if(iShardCount <= 1)
+            return file;
+        char pBuf[32];
+        sprintf_s(pBuf, ".%i", iShardIndex);
+        size_t dot = file.rfind('.');
+        size_t slash = file.find_last_of("/\\");
+        if(dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            dot = file.size();
+        return file.insert(dot, pBuf);
+    }
+
+    /**
+     * Relative increase of the median which fails a benchmark if it is also significant,
+     * "--benchmark-threshold R" (or ESINTILER_BENCHMARK_THRESHOLD), 0.05 by default
+     */
+    static double BenchmarkThreshold()
+    {
+        const char *pValue = option("--benchmark-threshold", "ESINTILER_BENCHMARK_THRESHOLD");
+        return pValue ? atof(pValue) : 0.05;
+    }
+
+    /**
+     * Benchmarks of the BaselineFile
+     */
+    static Baseline& RunBaseline()
+    {
+        static Baseline baseline;
+        return baseline;
+    }
+
+    /**
+     * File the RunBaseline is loaded from, empty if none. Runs nested in the tests keep 
+     * the RunBaseline of the enclosing run if they are given the same file.
+     */
+    static std::string& RunBaselineFile()
+    {
+        static std::string file;
+        return file;
+    }
+
+    /**
+     * 32 bit FNV-1a hash, it is used for the shard assignment so it should never change
+     */
+    static unsigned int Hash(const char *ipText, unsigned int iHash = 2166136261u)
+    {
+        for(; *ipText; ipText++)
+        {
+            iHash ^= (unsigned char)*ipText;
+            iHash *= 16777619u;
+        }
+        return iHash;
+    }
+
+    /**
+     * Wrapper method for the ExecuteSuite which triggers execution of all registered 
+     * test suites
+     *
+     * @return: 0 if all tests are OK, non zero if any test failed 
+     */
+    static int ExecuteAllSuites(Logger *logger = new Logger())
+    {
+        return ExecuteSuite("", logger);
+    }
+
+    /**
+     * Method to execute one (given) or all (given is empty) test suites registered by the 
+     * manager
+     *
+     * @return: 0 if all tests are OK, non zero if any test failed 
+     */
+    static int ExecuteSuite(const std::string &iSuiteName, Logger *logger = new Logger())
+    {
+        std::vector<std::string> names;
+        if(iSuiteName != "")
+            names.push_back(iSuiteName);
+        return ExecuteSuites(names, logger);
+    }
+
+    /**
+     * Method to execute the given list of test suites, all registered suites are executed 
+     * if the list is empty. Suites are always executed in registration order. Each phase 
+     * of the suites and the tests is timed (see Logger::timing) and the totals of the run 
+     * are passed to Logger::summary at the end.
+     *
+     * @return: 0 if all tests are OK, non zero if any test failed 
+     */
+    static int ExecuteSuites(const std::vector<std::string> &iSuiteNames, Logger *logger = new Logger())
+    {
+        SelectionScope selectionScope;
+        SuiteList suites;
+        TestRunnerList& testRunners = TestRunners();
+        TestRunnerList::iterator it = testRunners.begin();
+        for(; it != testRunners.end(); it++)
+        {
+            bool selected = iSuiteNames.empty();
+            for(unsigned int i = 0; !selected && i < iSuiteNames.size(); i++)
+                selected = it->first == iSuiteNames[i];
+            //a filter drops the suites before they are constructed
+            if(selected && RunSelection().filtered)
+                selected = HasFilteredTests(it->second);
+            if(selected)
+                suites.push_back(SuiteTask(it->first, it->second));
+        }
+
+        double start = platform::Now();
+        int retVal = 0;
+        int numAllAssertions = 0;
+        int numAllFailedAssertions = 0;
+
+        const Selection &selection = RunSelection();
+        if(selection.shardIndex < 0 || (selection.shardCount > 1 && selection.shardIndex >= selection.shardCount))
+        {
+            char pBuf[1024];
+            sprintf_s(pBuf, "Invalid shard index %i for %i shards", selection.shardIndex, selection.shardCount);
+            logger->log(pBuf);
+            return 1;
+        }
+
+        //Report files are written by the outermost run, runs nested in the tests are a 
+        //part of the tests
+        Reporter *pJUnit = 0;
+        Reporter *pJsonLines = 0;
+        bool listing = ListTests();
+        bool reporting = !listing && (JUnitFile() || JsonLinesFile()) && 
+            platform::AtomicCompareExchange(&ReportingRun(), 0, 1);
+        if(reporting && JUnitFile())
+            logger = pJUnit = new JUnitReporter(ReportFile(JUnitFile(), selection.shardIndex, selection.shardCount).c_str(), logger);
+        if(reporting && JsonLinesFile())
+            logger = pJsonLines = new JsonLinesReporter(ReportFile(JsonLinesFile(), selection.shardIndex, selection.shardCount).c_str(), 
+                logger, selection.shardIndex);
+        if((pJUnit && !pJUnit->IsOpen()) || (pJsonLines && !pJsonLines->IsOpen()))
+            logger->log("Could not create the report files");
+
+        HistoryScope history(HistoryFile());
+        BuildPlan(selection.shardCount, logger);
+
+        if(listing)
+        {
+            for(SuiteList::iterator it = suites.begin(); it != suites.end(); it++)
+                List(it->name, it->runner, logger);
+            return 0;
+        }
+
+        const char *pBaselineFile = BaselineFile();
+        bool loadBaseline = !pBaselineFile || RunBaselineFile() != pBaselineFile;
+        Baseline previousBaseline;
+        std::string previousBaselineFile;
+        if(loadBaseline)
+        {
+            previousBaseline = RunBaseline();
+            previousBaselineFile = RunBaselineFile();
+            RunBaseline().Clear();
+            if(pBaselineFile)
+                RunBaseline().Load(pBaselineFile);
+            RunBaselineFile() = pBaselineFile ? pBaselineFile : "";
+        }
+
+        SummaryLogger summaryLogger(logger, Slowest());
+        int jobs = Jobs();
+        int processes = Processes();
+        if(processes > 0 && !suites.empty())
+            ExecuteInProcesses(suites, processes, &summaryLogger);
+        else if(jobs > 1 && suites.size() > 1)
+            ExecuteParallel(suites, jobs, &summaryLogger);
+        else
+            ExecuteSerial(suites, &summaryLogger);
+
+        history.Save(selection.shardIndex, selection.shardCount);
+
+        const char *pSaveFile = BaselineSaveFile();
+        const std::vector<BenchmarkResult> &results = summaryLogger.Benchmarks();
+        if(pSaveFile && !results.empty())
+        {
+            Baseline saved;
+            saved.Load(pSaveFile);
+            for(unsigned int i = 0; i < results.size(); i++)
+                saved.Record(results[i]);
+            saved.Save(pSaveFile);
+        }
+        if(loadBaseline)
+        {
+            RunBaseline() = previousBaseline;
+            RunBaselineFile() = previousBaselineFile;
+        }
+
+        SuiteList::iterator itSuite = suites.begin();
+        for(; itSuite != suites.end(); itSuite++)
+        {
+            retVal += itSuite->retVal;
+            numAllAssertions += itSuite->numAssertions;
+            numAllFailedAssertions += itSuite->numFailedAssertions;
+        }
+
+        if(suites.empty())
+        {
+            logger->log("Could not found any suit to execute");
+            retVal = 1;
+        }
+
+        RunSummary summary;
+        summary.retVal = retVal;
+        summary.numAssertions = numAllAssertions;
+        summary.numFailedAssertions = numAllFailedAssertions;
+        summary.seconds = platform::Now() - start;
+        summaryLogger.Fill(summary);
+        logger->summary(summary);
+
+        if(reporting)
+        {
+            delete pJsonLines;
+            delete pJUnit;
+            platform::AtomicStore(&ReportingRun(), 0);
+        }
+        return retVal;
+    }
+
+    /**
+     * Registered suites in the order of registration. List is built from the runners 
+     * linked by Register on its first use.
+     */
+    static TestRunnerList& TestRunners()
+    {
+        static TestRunnerList testRunners;
+        if(testRunners.size() != (size_t)NumRunners())
+        {
+            testRunners.clear();
+            testRunners.reserve(NumRunners());
+            for(TestRunnerBase *pRunner = FirstRunner(); pRunner; pRunner = pRunner->next)
+                testRunners.push_back(std::make_pair(std::string(pRunner->name), pRunner));
+        }
+        return testRunners;
+    }
+
+    /**
+     * Runner of the registered suite with the given name, NULL if there is none
+     */
+    static TestRunnerBase* FindRunner(const char *ipSuite)
+    {
+        for(TestRunnerBase *pRunner = FirstRunner(); pRunner; pRunner = pRunner->next)
+            if(strcmp(pRunner->name, ipSuite) == 0)
+                return pRunner;
+        return 0;
+    }
+
+    /**
+     * Adds the runner of a suite, it is called while the application is loaded so it only
+     * links the runner to the list without any allocation
+     */
+    static void Register(TestRunnerBase *ipRunner)
+    {
+        (LastRunner() ? LastRunner()->next : FirstRunner()) = ipRunner;
+        LastRunner() = ipRunner;
+        NumRunners()++;
+    }
+
+private:
+    static TestRunnerBase*& FirstRunner()
+    {
+        static TestRunnerBase *first = 0;
+        return first;
+    }
+
+    static TestRunnerBase*& LastRunner()
+    {
+        static TestRunnerBase *last = 0;
+        return last;
+    }
+
+    static int& NumRunners()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    /**
+     * 1 while a run writes the report files
+     */
+    static volatile long& ReportingRun()
+    {
+        static volatile long reporting = 0;
+        return reporting;
+    }
+
+    /**
+     * A suite selected for execution and its results. Results are filled by RunSuite, 
+     * assertion numbers are only set if the suite made any assertion
+     */
+    struct SuiteTask
+    {
+        SuiteTask(const std::string &iName, TestRunnerBase *ipRunner)
+            : name(iName)
+            , runner(ipRunner)
+            , retVal(0)
+            , numAssertions(0)
+            , numFailedAssertions(0)
+        {
+        }
+
+        std::string     name;
+        TestRunnerBase *runner;
+        int             retVal;
+        int             numAssertions;
+        int             numFailedAssertions;
+    };
+    typedef std::vector<SuiteTask> SuiteList;
+
+    /**
+     * An entry of the shard plan or the schedule with its expected duration
+     */
+    struct Estimate
+    {
+        Estimate(const std::string &iKey, double iSeconds, int iIndex = 0) 
+            : key(iKey), seconds(iSeconds), index(iIndex) {}
+
+        //Longest first, ties are ordered by key so every shard finds the same order
+        bool operator<(const Estimate &iOther) const
+        {
+            if(seconds != iOther.seconds)
+                return seconds > iOther.seconds;
+            return key < iOther.key;
+        }
+
+        std::string key;
+        double      seconds;
+        int         index;
+    };
+
+    /**
+     * Assigns all registered tests to the shards, longest first to the shard with the 
+     * least total duration. It is only done if there is a history, otherwise Selected 
+     * uses the hash of the names. Fingerprint of the history is logged so shards which 
+     * read different histories, and may skip or repeat tests, can be detected.
+     */
+    static void BuildPlan(int iShardCount, Logger *logger)
+    {
+        ShardPlan &plan = RunSelection().plan;
+        plan.count = 0;
+        plan.shards.clear();
+        History &history = RunHistory();
+        if(iShardCount <= 1 || !history.Enabled())
+            return;
+        char pBuf[128];
+        sprintf_s(pBuf, "#history  : fingerprint %08x of %i entries", history.Fingerprint(), 
+            (int)history.Size());
+        logger->log(pBuf);
+        if(history.Empty())
+            return;
+
+        std::vector<Estimate> estimates;
+        TestRunnerList::iterator it = TestRunners().begin();
+        for(; it != TestRunners().end(); it++)
+        {
+            const char *pSuite = it->first.c_str();
+            TestBase *pFirst = it->second->Tests();
+            if(!pFirst)
+                estimates.push_back(Estimate(History::Key(pSuite, 0), history.Predict(pSuite, 0)));
+            for(TestBase *pTest = pFirst; pTest; pTest = pTest->next)
+                estimates.push_back(Estimate(History::Key(pSuite, pTest->name), history.Predict(pSuite, pTest->name)));
+        }
+        std::sort(estimates.begin(), estimates.end());
+
+        std::vector<double> loads(iShardCount, 0.0);
+        for(unsigned int i = 0; i < estimates.size(); i++)
+        {
+            int shard = (int)(std::min_element(loads.begin(), loads.end()) - loads.begin());
+            loads[shard] += estimates[i].seconds;
+            plan.shards[estimates[i].key] = shard;
+        }
+        plan.count = iShardCount;
+    }
+
+    /**
+     * Order to start the suites, longest first if there is a history
+     */
+    static std::vector<int> Schedule(const SuiteList &iSuites)
+    {
+        History &history = RunHistory();
+        std::vector<Estimate> estimates;
+        for(unsigned int i = 0; i < iSuites.size(); i++)
+        {
+            double seconds = history.Enabled() ? history.Predict(iSuites[i].name.c_str(), 0) : 0;
+            //ties keep the registration order
+            char pKey[16];
+            sprintf_s(pKey, "%08u", i);
+            estimates.push_back(Estimate(pKey, seconds, i));
+        }
+        std::sort(estimates.begin(), estimates.end());
+
+        std::vector<int> order;
+        for(unsigned int i = 0; i < estimates.size(); i++)
+            order.push_back(estimates[i].index);
+        return order;
+    }
+
+    /**
+     * Splits the tests into contiguous ranges with similar expected durations, each 
+     * range has at least one test
+     */
+    static std::vector<size_t> SplitTests(TestSuiteBase *pSuite, size_t iNumRanges)
+    {
+        History &history = RunHistory();
+        size_t numTests = pSuite->Tests.size();
+        std::vector<double> weights(numTests, 1.0);
+        double total = 0;
+        for(size_t i = 0; i < numTests; i++)
+        {
+            if(history.Enabled() && !history.Empty())
+                weights[i] = history.Predict(pSuite->name, pSuite->Tests[i]->name) + 1e-6;
+            total += weights[i];
+        }
+
+        std::vector<size_t> bounds(1, 0);
+        double sum = 0;
+        size_t next = 0;
+        for(size_t range = 1; range < iNumRanges; range++)
+        {
+            double target = total * range / iNumRanges;
+            //leave at least one test for each of the remaining ranges
+            size_t limit = numTests - (iNumRanges - range);
+            do
+            {
+                sum += weights[next++];
+            } while(next < limit && sum + weights[next] / 2 <= target);
+            bounds.push_back(next);
+        }
+        bounds.push_back(numTests);
+        return bounds;
+    }
+
+    /**
+     * Passes everything to the actual logger and collects the durations of the tests and 
+     * the suites for the summary of the run. Only the given number of the slowest ones 
+     * are kept.
+     */
+    class SummaryLogger : public Logger
+    {
+    public:
+        using Logger::log;
+
+        SummaryLogger(Logger *ipTarget, int iSlowest) 
+            : m_target(ipTarget)
+            , m_slowest(iSlowest > 0 ? iSlowest : 0)
+            , m_numTests(0)
+        {
+        }
+
+        void log(const char *ipMsg)
+        {
+            m_target->log(ipMsg);
+        }
+
+        void timing(const char *ipSuite, const char *ipTest, TimingPhase iPhase, double iSeconds)
+        {
+            m_target->timing(ipSuite, ipTest, iPhase, iSeconds);
+            if(iPhase == PhaseTest)
+            {
+                m_numTests ++;
+                Keep(m_tests, TimingEntry(ipSuite, ipTest, iSeconds));
+            }
+            else if(iPhase == PhaseSuite)
+            {
+                Keep(m_suites, TimingEntry(ipSuite, "", iSeconds));
+            }
+        }
+
+        void benchmark(const BenchmarkResult &iResult)
+        {
+            m_target->benchmark(iResult);
+            m_benchmarks.push_back(iResult);
+        }
+
+        void failure(const FailureRecord &iFailure)
+        {
+            m_target->failure(iFailure);
+        }
+
+        void result(const TestRecord &iRecord)
+        {
+            m_target->result(iRecord);
+        }
+
+        const std::vector<BenchmarkResult>& Benchmarks() const
+        {
+            return m_benchmarks;
+        }
+
+        void Fill(RunSummary &ioSummary)
+        {
+            Trim(m_tests);
+            Trim(m_suites);
+            ioSummary.numTests = m_numTests;
+            ioSummary.slowestTests = m_tests;
+            ioSummary.slowestSuites = m_suites;
+        }
+
+    private:
+        void Keep(std::vector<TimingEntry> &ioEntries, const TimingEntry &iEntry)
+        {
+            if(m_slowest == 0)
+                return;
+            ioEntries.push_back(iEntry);
+            if(ioEntries.size() >= 2 * m_slowest)
+                Trim(ioEntries);
+        }
+
+        void Trim(std::vector<TimingEntry> &ioEntries)
+        {
+            size_t size = ioEntries.size() < m_slowest ? ioEntries.size() : m_slowest;
+            std::partial_sort(ioEntries.begin(), ioEntries.begin() + size, ioEntries.end());
+            ioEntries.resize(size);
+        }
+
+        Logger                     *m_target;
+        size_t                      m_slowest;
+        int                         m_numTests;
+        std::vector<TimingEntry>    m_tests;
+        std::vector<TimingEntry>    m_suites;
+        std::vector<BenchmarkResult> m_benchmarks;
+    };
+
+    static void ExecuteSerial(SuiteList &ioSuites, Logger *logger)
+    {
+        SuiteList::iterator it = ioSuites.begin();
+        for(; it != ioSuites.end(); it++)
+            RunSuite(*it, logger);
+    }
+
+    /**
+     * Pool which executes each task with its own buffered logger. Manager passes the 
+     * buffers to the actual logger in task order as soon as the tasks are completed.
+     */
+    class OrderedPool : public WorkerPool
+    {
+    public:
+        OrderedPool(int iNumTasks)
+        {
+            for(int i = 0; i < iNumTasks; i++)
+            {
+                m_loggers.push_back(new BufferedLogger());
+                m_done.push_back(new platform::Signal());
+            }
+        }
+
+        ~OrderedPool()
+        {
+            Join();
+            for(unsigned int i = 0; i < m_loggers.size(); i++)
+            {
+                delete m_loggers[i];
+                delete m_done[i];
+            }
+        }
+
+        /**
+         * Implemented by derived classes to execute a single task
+         */
+        virtual void Process(int iTask, Logger *logger) = 0;
+
+        void Execute(int iTask, int iWorker)
+        {
+            Process(iTask, m_loggers[iTask]);
+            m_done[iTask]->Set();
+        }
+
+        /**
+         * Executes all the tasks on the given number of workers and logs their messages 
+         * in task order. Tasks are started in the given order, or in task order if empty.
+         */
+        void Run(int iJobs, Logger *logger, const std::vector<int> &iOrder = std::vector<int>())
+        {
+            std::vector<int> tasks(iOrder);
+            if(tasks.empty())
+                for(unsigned int i = 0; i < m_loggers.size(); i++)
+                    tasks.push_back(i);
+
+            Start(tasks, iJobs < (int)tasks.size() ? iJobs : (int)tasks.size());
+            for(unsigned int i = 0; i < m_loggers.size(); i++)
+            {
+                m_done[i]->Wait();
+                m_loggers[i]->Flush(logger);
+            }
+            Join();
+        }
+
+    private:
+        std::vector<BufferedLogger*>    m_loggers;
+        std::vector<platform::Signal*>  m_done;
+    };
+
+    class SuitePool : public OrderedPool
+    {
+    public:
+        SuitePool(SuiteList &ioSuites) 
+            : OrderedPool((int)ioSuites.size())
+            , m_suites(ioSuites)
+        {
+        }
+
+        void Process(int iTask, Logger *logger)
+        {
+            RunSuite(m_suites[iTask], logger);
+        }
+
+    private:
+        SuiteList &m_suites;
+    };
+
+    static void ExecuteParallel(SuiteList &ioSuites, int iJobs, Logger *logger)
+    {
+        SuitePool pool(ioSuites);
+        pool.Run(iJobs, logger, Schedule(ioSuites));
+    }
+
+    /**
+     * A contiguous range of tests of a suite which is executed with a single suite 
+     * instance, the whole suite is a single range unless suite asks for more Workers
+     */
+    struct TestRange
+    {
+        TestRange(TestRunnerBase *ipRunner, size_t iFirst, size_t iLast)
+            : runner(ipRunner)
+            , suite(0)
+            , first(iFirst)
+            , last(iLast)
+            , retVal(0)
+            , numAssertions(0)
+            , numFailedAssertions(0)
+            , constructFailed(false)
+        {
+        }
+
+        TestRunnerBase *runner;
+        TestSuiteBase  *suite;  //optional, range creates its own instance if it is not given
+        size_t          first;
+        size_t          last;
+        int             retVal;
+        int             numAssertions;
+        int             numFailedAssertions;
+        bool            constructFailed;
+    };
+    typedef std::vector<TestRange> RangeList;
+
+    /**
+     * Receives the progress of a test range, used by the worker processes to report 
+     * the results of each test as soon as it is completed
+     */
+    struct RangeListener
+    {
+        /**
+         * Listener is responsible of the time budget of the test, 0 if there is no limit
+         */
+        virtual void TestStarted(size_t iIndex, const char *ipName, double iTimeout) = 0;
+        virtual void TestFinished(size_t iIndex, const char *ipName, int iRetVal, 
+            int iNumAssertions, int iNumFailedAssertions, double iSeconds) = 0;
+    };
+
+    class RangePool : public OrderedPool
+    {
+    public:
+        RangePool(RangeList &ioRanges) 
+            : OrderedPool((int)ioRanges.size())
+            , m_ranges(ioRanges)
+        {
+        }
+
+        void Process(int iTask, Logger *logger)
+        {
+            RunRange(m_ranges[iTask], logger);
+        }
+
+    private:
+        RangeList &m_ranges;
+    };
+
+    /**
+     * Executes all the tests of a single suite, this is the unit of work for both serial
+     * and parallel execution so it should not touch any shared state other than the logger
+     */
+    static void RunSuite(SuiteTask &ioTask, Logger *logger)
+    {
+        int retVal = 0;
+        double start = platform::Now();
+        if(!HasSelectedTests(ioTask.runner))
+            return;
+
+        TestSuiteBase *pSuite = ioTask.runner->CreateSuite();
+        pSuite->logger = logger;
+        
+        if(pSuite->Active() && HasSelectedTests(pSuite))
+        {
+            logger->log(ioTask.name);
+
+            size_t numTests = pSuite->Tests.size();
+            size_t numWorkers = pSuite->Workers() > 0 ? pSuite->Workers() : platform::CpuCount();
+            if(numWorkers > numTests)
+                numWorkers = numTests;
+
+            RangeList ranges;
+            if(numWorkers > 1)
+            {
+                std::vector<size_t> bounds = SplitTests(pSuite, numWorkers);
+                for(size_t i = 0; i < numWorkers; i++)
+                    ranges.push_back(TestRange(ioTask.runner, bounds[i], bounds[i + 1]));
+                ranges[0].suite = pSuite;
+                RangePool pool(ranges);
+                pool.Run((int)numWorkers, logger);
+            }
+            else
+            {
+                ranges.push_back(TestRange(ioTask.runner, 0, numTests));
+                ranges[0].suite = pSuite;
+                RunRange(ranges[0], logger);
+            }
+
+            //Merge the ranges, a failing Construct is reported once like in a single instance
+            int numAssertions = 0;
+            int numFailedAssertions = 0;
+            bool constructFailed = false;
+            RangeList::iterator it = ranges.begin();
+            for(; it != ranges.end(); it++)
+            {
+                retVal += it->retVal;
+                numAssertions += it->numAssertions;
+                numFailedAssertions += it->numFailedAssertions;
+                constructFailed |= it->constructFailed;
+            }
+            if(constructFailed)
+                retVal ++;
+
+            if(numAssertions == 0)
+            {
+                logger->log("...Failed (No Assertions)");
+                retVal ++;
+            }
+            else
+            {
+                ioTask.numAssertions = numAssertions;
+                ioTask.numFailedAssertions = numFailedAssertions;
+            }
+            double seconds = platform::Now() - start;
+            logger->timing(pSuite->name, "", PhaseSuite, seconds);
+            RunHistory().Record(pSuite->name, 0, seconds);
+        }
+        delete pSuite;
+        pSuite = 0;
+
+        ioTask.retVal = retVal;
+    }
+
+    /**
+     * Returns true if any test of the suite passes the filter, the suite is not 
+     * constructed
+     */
+    static bool HasFilteredTests(TestRunnerBase *ipRunner)
+    {
+        if(!ipRunner->Active())
+            return false;
+        const NameFilter &filter = RunSelection().filter;
+        std::string suite(ipRunner->name);
+        if(!ipRunner->Tests())
+            return filter.Matches(suite);
+        for(TestBase *pTest = ipRunner->Tests(); pTest; pTest = pTest->next)
+            if(filter.Matches(suite + "." + pTest->name))
+                return true;
+        return false;
+    }
+
+    /**
+     * Logs the names of the selected tests of the suite
+     */
+    static void List(const std::string &iSuite, TestRunnerBase *ipRunner, Logger *logger)
+    {
+        if(!ipRunner->Active())
+            return;
+        if(!ipRunner->Tests() && Selected(iSuite.c_str(), 0, false))
+            logger->log(iSuite);
+        for(TestBase *pTest = ipRunner->Tests(); pTest; pTest = pTest->next)
+            if(Selected(iSuite.c_str(), pTest->name, pTest->benchmark))
+                logger->log(iSuite + "." + pTest->name);
+    }
+
+    /**
+     * Same as below without constructing the suite
+     */
+    static bool HasSelectedTests(TestRunnerBase *ipRunner)
+    {
+        if(!ipRunner->Active())
+            return false;
+        if(!ipRunner->Tests())
+            return Selected(ipRunner->name, 0, false);
+        for(TestBase *pTest = ipRunner->Tests(); pTest; pTest = pTest->next)
+            if(Selected(ipRunner->name, pTest->name, pTest->benchmark))
+                return true;
+        return false;
+    }
+
+    /**
+     * Returns true if the suite should be executed in this run at all
+     */
+    static bool HasSelectedTests(TestSuiteBase *pSuite)
+    {
+        if(pSuite->Tests.empty())
+            return Selected(pSuite, 0);
+
+        TestSuiteBase::TestList::iterator it = pSuite->Tests.begin();
+        for(; it != pSuite->Tests.end(); it++)
+            if(Selected(pSuite, *it))
+                return true;
+        return false;
+    }
+
+    /**
+     * Constructs the suite instance of the range, executes its tests and destructs it
+     */
+    static void RunRange(TestRange &ioRange, Logger *logger, RangeListener *ipListener = 0)
+    {
+        TestSuiteBase *pSuite = ioRange.suite ? ioRange.suite : ioRange.runner->CreateSuite();
+        pSuite->logger = logger;
+        TestSuiteBase *pPrevious = pSuite->RunOnThisThread();
+
+        double start = platform::Now();
+        int constructed = pSuite->Construct();
+        logger->timing(pSuite->name, "", PhaseConstruct, platform::Now() - start);
+        if(constructed == 0)
+        {
+            int testsPerFork = platform::HasFork ? pSuite->TestsPerFork() : 0;
+            if(testsPerFork > 0)
+                RunForked(pSuite, ioRange, testsPerFork, logger, ipListener);
+            else
+                RunTests(pSuite, ioRange.first, ioRange.last, 0, 0, ioRange, logger, ipListener);
+        }
+        else
+        {
+            logger->log("Could not Initialize the Test Suite, all tests will be skipped");
+            ioRange.constructFailed = true;
+        }
+        
+        start = platform::Now();
+        pSuite->Destruct();
+        logger->timing(pSuite->name, "", PhaseDestruct, platform::Now() - start);
+        TestSuiteBase::RestoreRunningSuite(pPrevious);
+
+        if(!ioRange.suite)
+            delete pSuite;
+    }
+
+    /**
+     * Aborts the process with a diagnostic if the armed test does not finish in its time 
+     * budget. It is used for the tests executed in this process, forked tests are killed 
+     * by their parent instead. Thread is only started when a test with a budget is armed.
+     */
+    class Watchdog : public platform::Thread
+    {
+    public:
+        Watchdog() : m_deadline(0), m_start(0), m_timeout(0), m_running(false) {}
+
+        ~Watchdog()
+        {
+            if(m_running)
+            {
+                m_stop.Set();
+                Join();
+            }
+        }
+
+        void Arm(const char *ipSuite, const char *ipTest, double iTimeout)
+        {
+            if(iTimeout <= 0)
+                return;
+            platform::ScopedLock lock(m_mutex);
+            m_suite = ipSuite;
+            m_test = ipTest;
+            m_timeout = iTimeout;
+            m_start = platform::Now();
+            m_deadline = m_start + iTimeout;
+            if(!m_running)
+                m_running = Start();
+        }
+
+        void Disarm()
+        {
+            platform::ScopedLock lock(m_mutex);
+            m_deadline = 0;
+        }
+
+        void Run()
+        {
+            while(!m_stop.Wait(0.05))
+            {
+                platform::ScopedLock lock(m_mutex);
+                double now = platform::Now();
+                if(m_deadline > 0 && now >= m_deadline)
+                {
+                    fprintf(stderr, "Timeout: %s.%s is running for %.3f s, its budget is %.3f s. Aborting.\n", 
+                        m_suite.c_str(), m_test.c_str(), now - m_start, m_timeout);
+                    fflush(stdout);
+                    fflush(stderr);
+                    abort();
+                }
+            }
+        }
+
+    private:
+        platform::Mutex     m_mutex;
+        platform::Signal    m_stop;
+        std::string         m_suite;
+        std::string         m_test;
+        double              m_deadline;     //0 if nothing is armed
+        double              m_start;
+        double              m_timeout;
+        bool                m_running;
+    };
+
+    /**
+     * Time to wait in milliseconds until the given deadline, -1 if there is no deadline
+     */
+    static int WaitTime(double iDeadline)
+    {
+        if(iDeadline <= 0)
+            return -1;
+        double remaining = iDeadline - platform::Now();
+        return remaining > 0 ? (int)(remaining * 1000) + 1 : 0;
+    }
+
+    /**
+     * Executes the tests [iFirst, iLast) on a constructed suite and adds their results to 
+     * the range. Assertions of each test are counted from the given initial numbers.
+     */
+    static void RunTests(TestSuiteBase *pSuite, size_t iFirst, size_t iLast, 
+        int iNumAssertions, int iNumFailedAssertions, 
+        TestRange &ioRange, Logger *logger, RangeListener *ipListener)
+    {
+        int numAssertions = iNumAssertions;
+        int numFailedAssertions = iNumFailedAssertions;
+        const Selection &selection = RunSelection();
+        Watchdog watchdog;
+        TestSuiteBase *pPrevious = pSuite->RunOnThisThread();
+
+        TestSuiteBase::TestList::iterator itTest = pSuite->Tests.begin() + iFirst;
+        TestSuiteBase::TestList::iterator itLast = pSuite->Tests.begin() + iLast;
+        for(size_t index = iFirst; itTest != itLast; itTest++, index++)
+        {
+            if(!Selected(pSuite, *itTest))
+                continue;
+
+            const char *pName = (*itTest)->name;
+            double timeout = Timeout(pSuite, *itTest, selection.timeout);
+            if(ipListener)
+                ipListener->TestStarted(index, pName, timeout);
+            else
+                watchdog.Arm(pSuite->name, pName, timeout);
+
+            double start = platform::Now();
+            pSuite->currentTest = pName;
+            int setUp = pSuite->SetUp((*itTest)->name);
+            double executeStart = platform::Now();
+            logger->timing(pSuite->name, pName, PhaseSetUp, executeStart - start);
+            if(setUp != 0)
+            {
+                watchdog.Disarm();
+                ioRange.retVal ++;
+                logger->timing(pSuite->name, pName, PhaseTest, executeStart - start);
+                TestRecord record = { pSuite->name, pName, 1, 0, 0, executeStart - start, "SetUp failed" };
+                logger->result(record);
+                if(ipListener)
+                    ipListener->TestFinished(index, pName, 1, 0, 0, executeStart - start);
+                continue;
+            }
+
+            int testRetVal = 0;
+            const char *pReason = 0;
+
+            logger->log(pName);
+            pSuite->failureLimiter.Reset(selection.failureLimit, pSuite->numAssertions);
+            try{
+                if((*itTest)->benchmark)
+                    RunBenchmark(pSuite, *itTest, logger);
+                else
+                    (*itTest)->Execute(pSuite);
+            }
+            catch(Evaluator::Exception &e){
+            }
+            double executeEnd = platform::Now();
+            pSuite->MergeThreads();
+            pSuite->failureLimiter.Flush(logger);
+            
+            if(pSuite->numAssertions == numAssertions)
+            {
+                logger->log("...Failed (No Assertions)");
+                testRetVal ++;
+                pReason = "No Assertions";
+            }
+            else if(pSuite->numFailedAssertions != numFailedAssertions)
+            {
+                char pBuf[1024];
+                sprintf_s(pBuf, "...Failed (%i Assertions)", pSuite->numFailedAssertions - numFailedAssertions);
+                logger->log(pBuf);
+                testRetVal ++;
+            }
+            else {
+                //char pBuf[1024];
+                //sprintf_s(pBuf, "...OK (%i Assertions)", pSuite->numAssertions - numAssertions);
+                //logger->log(pBuf);
+                logger->log("...OK");
+            }
+            int testAssertions = pSuite->numAssertions - numAssertions;
+            int testFailedAssertions = pSuite->numFailedAssertions - numFailedAssertions;
+            numAssertions = pSuite->numAssertions;
+            numFailedAssertions = pSuite->numFailedAssertions;
+
+            ioRange.retVal += testRetVal;
+            ioRange.numAssertions += testAssertions;
+            ioRange.numFailedAssertions += testFailedAssertions;
+            logger->timing(pSuite->name, pName, PhaseExecute, executeEnd - executeStart);
+            
+            double tearDownStart = platform::Now();
+            pSuite->TearDown((*itTest)->name);
+            pSuite->currentTest = "";
+            double end = platform::Now();
+            watchdog.Disarm();
+            logger->timing(pSuite->name, pName, PhaseTearDown, end - tearDownStart);
+
+            double seconds = end - start;
+            logger->timing(pSuite->name, pName, PhaseTest, seconds);
+            TestRecord record = { pSuite->name, pName, testRetVal, testAssertions, 
+                testFailedAssertions, seconds, pReason };
+            logger->result(record);
+            RunHistory().Record(pSuite->name, pName, seconds);
+            if(ipListener)
+                ipListener->TestFinished(index, pName, testRetVal, testAssertions, 
+                    testFailedAssertions, seconds);
+        }
+        TestSuiteBase::RestoreRunningSuite(pPrevious);
+    }
+
+    /**
+     * Executes a benchmark of a suite. Number of iterations is increased until a sample 
+     * takes at least BenchmarkTime, one more sample is taken as warm up and then the 
+     * BenchmarkSamples are taken. SetUp and TearDown are called once around all of them. 
+     * Benchmark stops at the first failing assertion, otherwise its result is passed to 
+     * the logger and the completed benchmark counts as an assertion so benchmarks do not 
+     * need any CHECK. Passing assertions of the iterations are not counted, they would
+     * overflow the counters of a long run.
+     *
+     * If the benchmark is in the RunBaseline, it is also asserted that it is not slower:
+     * it fails if its median is more than BenchmarkThreshold larger than the median of 
+     * the baseline and the Mann-Whitney U test finds the difference significant (p < 0.01).
+     */
+    static void RunBenchmark(TestSuiteBase *pSuite, TestBase *pTest, Logger *logger)
+    {
+        int numAssertions = pSuite->numAssertions;
+        int numFailedAssertions = pSuite->numFailedAssertions;
+        double sampleTime = BenchmarkTime();
+
+        BenchmarkResult result;
+        result.suite = pSuite->name;
+        result.test = pTest->name;
+        result.iterations = 1;
+        //long is 32 bits on Windows, counts are computed in double and clamped to it
+        const long maxIterations = 1L << 30;
+        for(;;)
+        {
+            double start = platform::Now();
+            pTest->Repeat(pSuite, result.iterations);
+            double seconds = platform::Now() - start;
+            pSuite->MergeThreads();
+            pSuite->numAssertions = numAssertions + pSuite->numFailedAssertions - numFailedAssertions;
+            if(pSuite->numFailedAssertions != numFailedAssertions)
+                return;
+            if(seconds >= sampleTime || result.iterations >= maxIterations)
+                break;
+            double factor = seconds > 0 ? 1.2 * sampleTime / seconds : 100;
+            factor = factor < 2 ? 2 : (factor > 100 ? 100 : factor);
+            double iterations = result.iterations * factor;
+            result.iterations = iterations < maxIterations ? (long)iterations : maxIterations;
+        }
+
+        int numSamples = BenchmarkSamples();
+        for(int i = -1; i < numSamples; i++)
+        {
+            double start = platform::Now();
+            pTest->Repeat(pSuite, result.iterations);
+            double seconds = platform::Now() - start;
+            pSuite->MergeThreads();
+            pSuite->numAssertions = numAssertions + pSuite->numFailedAssertions - numFailedAssertions;
+            if(pSuite->numFailedAssertions != numFailedAssertions)
+                return;
+            if(i >= 0) //first one is the warm up
+                result.samples.push_back(seconds / result.iterations);
+        }
+        result.Compute();
+        logger->benchmark(result);
+        pSuite->numAssertions ++;
+
+        const std::vector<double> *pBaseline = RunBaseline().Samples(pSuite->name, pTest->name);
+        if(pBaseline && !pBaseline->empty())
+        {
+            BenchmarkResult baseline;
+            baseline.samples = *pBaseline;
+            baseline.Compute();
+            double change = baseline.median > 0 ? result.median / baseline.median - 1 : 0;
+            double p = Baseline::MannWhitney(*pBaseline, result.samples);
+            pSuite->numAssertions ++;
+            if(change > BenchmarkThreshold() && p < 0.01)
+            {
+                char pBuf[1024];
+                sprintf_s(pBuf, "...Regression: median %s -> %s (+%.1f%%, p=%.4f)", 
+                    BenchmarkResult::Format(baseline.median).c_str(), 
+                    BenchmarkResult::Format(result.median).c_str(), change * 100, p);
+                logger->log(pBuf);
+                pSuite->numFailedAssertions ++;
+            }
+        }
+    }
+
+    /**
+     * A batch of tests executed in a forked copy of a constructed suite
+     */
+    struct ForkedBatch
+    {
+        TestSuiteBase  *suite;
+        size_t          first;
+        size_t          last;
+        int             numAssertions;
+        int             numFailedAssertions;
+    };
+
+    /**
+     * Executes the tests of a constructed suite in forked children, each child executes 
+     * iTestsPerFork tests on its own copy of the suite so tests can not see the changes 
+     * made by the others. Children report their results with the same frames as the 
+     * worker processes, a crashing child fails the test in progress and the batch is 
+     * continued in a new child.
+     */
+    static void RunForked(TestSuiteBase *pSuite, TestRange &ioRange, int iTestsPerFork,
+        Logger *logger, RangeListener *ipListener)
+    {
+        ForkedBatch batch;
+        batch.suite = pSuite;
+        //Assertions made by Construct are counted in the first test, same as in process
+        batch.numAssertions = 0;
+        batch.numFailedAssertions = 0;
+
+        size_t next = ioRange.first;
+        while(next < ioRange.last)
+        {
+            batch.first = next;
+            batch.last = next + iTestsPerFork < ioRange.last ? next + iTestsPerFork : ioRange.last;
+
+            platform::ChildProcess child;
+            if(!child.Start(&TestManager::ForkedMain, &batch))
+            {
+                //Could not fork, tests share the suite instance from now on
+                RunTests(pSuite, next, ioRange.last, batch.numAssertions, batch.numFailedAssertions, 
+                    ioRange, logger, ipListener);
+                return;
+            }
+
+            long currentTest = -1;
+            long lastFinished = (long)next - 1;
+            std::string currentName;
+            double testStart = 0;
+            double deadline = 0;
+            bool timedOut = false;
+            FrameBuffer frames;
+            char pBuf[4096];
+            std::vector<int> files(1, child.Input());
+            std::vector<int> ready;
+            for(;;)
+            {
+                platform::WaitReadable(files, WaitTime(deadline), ready);
+                if(ready.empty())
+                {
+                    if(deadline > 0 && platform::Now() >= deadline)
+                    {
+                        timedOut = true;
+                        child.Kill();
+                        break;
+                    }
+                    continue;
+                }
+                int numRead = platform::ReadSome(child.Input(), pBuf, sizeof(pBuf));
+                if(numRead <= 0)
+                    break;
+                frames.input.append(pBuf, numRead);
+                char kind = 0;
+                std::string data;
+                while(frames.Next(kind, data))
+                {
+                    switch(kind)
+                    {
+                    case 'L':
+                        logger->log(data.c_str());
+                        break;
+                    case 'P':
+                        PipeLogger::Timing(data, logger);
+                        break;
+                    case 'B':
+                        PipeLogger::Benchmark(data, logger);
+                        break;
+                    case 'F':
+                        PipeLogger::Failure(data, logger);
+                        break;
+                    case 'D':
+                        PipeLogger::Result(data, logger);
+                        break;
+                    case 'T':
+                        {
+                            TestStart started;
+                            memcpy(&started, data.data(), sizeof(started));
+                            currentTest = started.index;
+                            currentName = data.c_str() + sizeof(started);
+                            testStart = platform::Now();
+                            deadline = started.timeout > 0 ? testStart + started.timeout : 0;
+                            //Budget is kept by this process, listener should not kill us
+                            if(ipListener)
+                                ipListener->TestStarted(currentTest, currentName.c_str(), 0);
+                        }
+                        break;
+                    case 'E':
+                        {
+                            TestResult result;
+                            memcpy(&result, data.data(), sizeof(result));
+                            currentTest = -1;
+                            deadline = 0;
+                            lastFinished = result.index;
+                            ioRange.retVal += result.retVal;
+                            ioRange.numAssertions += result.numAssertions;
+                            ioRange.numFailedAssertions += result.numFailedAssertions;
+                            const char *pName = data.c_str() + sizeof(result);
+                            RunHistory().Record(pSuite->name, pName, result.seconds);
+                            if(ipListener)
+                                ipListener->TestFinished(result.index, pName, result.retVal, 
+                                    result.numAssertions, result.numFailedAssertions, result.seconds);
+                        }
+                        break;
+                    }
+                }
+            }
+
+            char status[64] = "";
+            if(!child.Wait(status, sizeof(status)))
+            {
+                char pReason[512];
+                double seconds = platform::Now() - testStart;
+                if(timedOut)
+                    sprintf_s(pReason, "Timeout, %s.%s after %.3f s", pSuite->name, 
+                        currentName.c_str(), seconds);
+                else
+                    sprintf_s(pReason, "Crashed, %s", status);
+                if(timedOut || currentTest >= 0)
+                    sprintf_s(pBuf, "...Failed (%s)", pReason);
+                else
+                    sprintf_s(pBuf, "...Crashed (%s)", status);
+                logger->log(pBuf);
+                ioRange.retVal ++;
+                if(currentTest >= 0)
+                {
+                    TestRecord record = { pSuite->name, currentName.c_str(), 1, 0, 0, seconds, pReason };
+                    logger->result(record);
+                    lastFinished = currentTest;
+                    if(ipListener)
+                        ipListener->TestFinished(currentTest, pSuite->Tests[currentTest]->name, 1, 0, 0, 0);
+                }
+                else if(lastFinished < (long)next)
+                {
+                    //Child died before starting any test, do not retry the batch
+                    lastFinished = (long)batch.last - 1;
+                }
+            }
+            next = (size_t)(lastFinished + 1);
+
+            //Later children start from the constructed state again
+            batch.numAssertions = pSuite->numAssertions;
+            batch.numFailedAssertions = pSuite->numFailedAssertions;
+        }
+    }
+
+    /**
+     * Entry point of the forked children of RunForked
+     */
+    static int ForkedMain(int iInput, int iOutput, void *ipData)
+    {
+        ForkedBatch *pBatch = (ForkedBatch*)ipData;
+        PipeLogger logger(iOutput);
+        pBatch->suite->logger = &logger;
+        //Other threads may have held the lock of the history at the time of the fork, 
+        //durations of the tests are recorded by RunForked from their results instead
+        RunHistory().Enable(false);
+
+        TestRange range(0, pBatch->first, pBatch->last);
+        RunTests(pBatch->suite, pBatch->first, pBatch->last, 
+            pBatch->numAssertions, pBatch->numFailedAssertions, range, &logger, &logger);
+        return 0;
+    }
+
+    /**
+     * Data of the frame sent when a test is started, it is followed by the test name
+     */
+    struct TestStart
+    {
+        int     index;
+        double  timeout;    //0 if there is no limit
+    };
+
+    /**
+     * Data of the frame sent when a test is finished, it is followed by the test name
+     */
+    struct TestResult
+    {
+        int     index;
+        int     retVal;
+        int     numAssertions;
+        int     numFailedAssertions;
+        double  seconds;
+    };
+
+    /**
+     * Logger used in the worker processes, it sends the messages, the timings and the 
+     * progress of the tests to the manager process. Each message is a frame of: kind 
+     * (1 byte), size of the data (4 bytes) and the data. 
+     */
+    class PipeLogger : public Logger, public RangeListener
+    {
+    public:
+        using Logger::log;
+
+        PipeLogger(int iFile) : m_file(iFile) {}
+
+        void log(const char *ipMsg)
+        {
+            Frame('L', ipMsg, strlen(ipMsg));
+        }
 
-    Evaluator(Logger *iLogger,
-        int iRaiseException, 
-        int &ioNumAssertions, 
-        int &ioNumFailedAssertions,
-        const char *iFile,
-        int iLine)
-    : logger(iLogger)
-    , raiseException(iRaiseException)
-    , numAssertions(ioNumAssertions)
-    , numFailedAssertions(ioNumFailedAssertions)
-    , file(iFile)
-    , line(iLine)
-    {}
+        void TestStarted(size_t iIndex, const char *ipName, double iTimeout)
+        {
+            TestStart started = { (int)iIndex, iTimeout };
+            std::string data((const char*)&started, sizeof(started));
+            data += ipName;
+            Frame('T', data.data(), data.size());
+        }
 
-    template<typename ValueType>
-    void True(ValueType statement, const char* msg=0) {
-        numAssertions ++;
-        if(!(statement)) 
+        void TestFinished(size_t iIndex, const char *ipName, int iRetVal, 
+            int iNumAssertions, int iNumFailedAssertions, double iSeconds)
         {
-            numFailedAssertions++;
-            char pBuf[2048];
-            sprintf_s(pBuf, "#file    : %s", file); logger->log(pBuf);
-            sprintf_s(pBuf, "#line    : %i", line); logger->log(pBuf);
-            if(msg)
+            TestResult result = { (int)iIndex, iRetVal, iNumAssertions, iNumFailedAssertions, iSeconds };
+            std::string data((const char*)&result, sizeof(result));
+            data += ipName;
+            Frame('E', data.data(), data.size());
+        }
+
+        void timing(const char *ipSuite, const char *ipTest, TimingPhase iPhase, double iSeconds)
+        {
+            TimingData timing = { (int)iPhase, iSeconds };
+            std::string data((const char*)&timing, sizeof(timing));
+            data += ipSuite;
+            data += '\0';
+            data += ipTest;
+            Frame('P', data.data(), data.size());
+        }
+
+        void benchmark(const BenchmarkResult &iResult)
+        {
+            BenchmarkData header = { (int)iResult.iterations, (int)iResult.samples.size() };
+            std::string data((const char*)&header, sizeof(header));
+            if(!iResult.samples.empty())
+                data.append((const char*)&iResult.samples[0], iResult.samples.size() * sizeof(double));
+            data += iResult.suite;
+            data += '\0';
+            data += iResult.test;
+            Frame('B', data.data(), data.size());
+        }
+
+        void failure(const FailureRecord &iFailure)
+        {
+            FailureData header = { iFailure.line, iFailure.statement != 0, iFailure.message != 0 };
+            std::string data((const char*)&header, sizeof(header));
+            const char *pParts[] = { iFailure.statement, iFailure.message, iFailure.file, 
+                iFailure.suite, iFailure.test };
+            for(int i = 0; i < 5; i++)
             {
-                sprintf_s(pBuf, "#msg     : %s", msg); 
-                logger->log(pBuf);
+                if(pParts[i])
+                    data += pParts[i];
+                data += '\0';
             }
-            if(raiseException)
-                throw Exception(); 
+            Frame('F', data.data(), data.size());
         }
-    }
-    
-private:
-    Logger *logger;
-    int raiseException;
-    int &numAssertions;
-    int &numFailedAssertions;
-    const char* statementText;
-    const char* file;
-    int         line;
-};
 
+        void result(const TestRecord &iRecord)
+        {
+            ResultData header = { iRecord.retVal, iRecord.numAssertions, iRecord.numFailedAssertions, 
+                iRecord.reason != 0, iRecord.seconds };
+            std::string data((const char*)&header, sizeof(header));
+            data += iRecord.suite;
+            data += '\0';
+            data += iRecord.test;
+            data += '\0';
+            if(iRecord.reason)
+                data += iRecord.reason;
+            Frame('D', data.data(), data.size());
+        }
 
+        /**
+         * Passes the result received in a 'D' frame to the given logger
+         */
+        static void Result(const std::string &iData, Logger *logger)
+        {
+            ResultData header;
+            memcpy(&header, iData.data(), sizeof(header));
+            const char *pSuite = iData.c_str() + sizeof(header);
+            const char *pTest = pSuite + strlen(pSuite) + 1;
+            const char *pReason = pTest + strlen(pTest) + 1;
+            TestRecord record = { pSuite, pTest, header.retVal, header.numAssertions, 
+                header.numFailedAssertions, header.seconds, header.hasReason ? pReason : 0 };
+            logger->result(record);
+        }
 
-/**
- * User interacts with this class to run a single test suite or all of them
- */
-class TestManager
-{
-private:
-    typedef std::vector<std::pair<std::string, TestRunnerBase*>>  TestRunnerList;
+        /**
+         * Passes the failure received in a 'F' frame to the given logger
+         */
+        static void Failure(const std::string &iData, Logger *logger)
+        {
+            FailureData header;
+            memcpy(&header, iData.data(), sizeof(header));
+            const char *pParts[5];
+            pParts[0] = iData.c_str() + sizeof(header);
+            for(int i = 1; i < 5; i++)
+                pParts[i] = pParts[i - 1] + strlen(pParts[i - 1]) + 1;
+            FailureRecord record = { header.hasStatement ? PersistentString(pParts[0]) : 0, 
+                header.hasMessage ? pParts[1] : 0, PersistentString(pParts[2]), header.line, 
+                pParts[3], pParts[4] };
+            logger->failure(record);
+        }
+
+        /**
+         * Passes the benchmark result received in a 'B' frame to the given logger
+         */
+        static void Benchmark(const std::string &iData, Logger *logger)
+        {
+            BenchmarkData header;
+            memcpy(&header, iData.data(), sizeof(header));
+            BenchmarkResult result;
+            result.iterations = header.iterations;
+            result.samples.resize(header.numSamples);
+            if(header.numSamples > 0)
+                memcpy(&result.samples[0], iData.data() + sizeof(header), header.numSamples * sizeof(double));
+            const char *pSuite = iData.c_str() + sizeof(header) + header.numSamples * sizeof(double);
+            result.suite = pSuite;
+            result.test = pSuite + strlen(pSuite) + 1;
+            result.Compute();
+            logger->benchmark(result);
+        }
+
+        /**
+         * Passes the timing received in a 'P' frame to the given logger
+         */
+        static void Timing(const std::string &iData, Logger *logger)
+        {
+            TimingData timing;
+            memcpy(&timing, iData.data(), sizeof(timing));
+            const char *pSuite = iData.c_str() + sizeof(timing);
+            const char *pTest = pSuite + strlen(pSuite) + 1;
+            logger->timing(pSuite, pTest, (TimingPhase)timing.phase, timing.seconds);
+        }
+
+        void Frame(char iKind, const void *ipData, size_t iSize)
+        {
+            char header[5];
+            unsigned int size = (unsigned int)iSize;
+            header[0] = iKind;
+            memcpy(header + 1, &size, 4);
+            platform::WriteAll(m_file, header, 5);
+            platform::WriteAll(m_file, (const char*)ipData, iSize);
+        }
+
+    private:
+        struct TimingData
+        {
+            int     phase;
+            double  seconds;
+        };
+
+        //followed by the samples, suite and test names
+        struct BenchmarkData
+        {
+            int     iterations;
+            int     numSamples;
+        };
+
+        //followed by the statement, message, file, suite and test
+        struct FailureData
+        {
+            int     line;
+            int     hasStatement;
+            int     hasMessage;
+        };
+
+        //followed by the suite, test and reason
+        struct ResultData
+        {
+            int     retVal;
+            int     numAssertions;
+            int     numFailedAssertions;
+            int     hasReason;
+            double  seconds;
+        };
+
+        int m_file;
+    };
 
-public:
     /**
-     * Utility method to store the command line arrgumens if they need to be accessed
-     * Note that this method can be called multiple times, each call will modify on top
-     * of the previously stored values. 
-     * It returns a ref so caller can actually append to args 
-     * call without parameters to retrieve the current values
+     * Collects the bytes written by a PipeLogger and splits them into frames
      */
-    typedef std::map<std::string, std::string> ArgumentList;
-    static ArgumentList & args(int argc = 0, char *argv[] = NULL)
+    struct FrameBuffer
     {
-        static ArgumentList args;
-        if(argc > 1 && argv != NULL)
+        FrameBuffer() : pos(0) {}
+
+        /**
+         * Extracts the next complete frame, returns false if there is none yet
+         */
+        bool Next(char &oKind, std::string &oData)
         {
-            if(argc % 2 != 1){ //First one is always the application name
-                //cout << "Can't parse arguments, it should be given as '-key value' pairs such as: " << endl;
-                //cout << " app input <input folder>  output <output folder> test <testname>" << endl;
+            unsigned int size = 0;
+            if(input.size() - pos < 5)
+            {
+                Compact();
+                return false;
             }
-            for(int i = 1; i < argc; i += 2)
-                args[argv[i]] = argv[i + 1];
+            memcpy(&size, input.data() + pos + 1, 4);
+            if(input.size() - pos - 5 < size)
+            {
+                Compact();
+                return false;
+            }
+            oKind = input[pos];
+            oData.assign(input, pos + 5, size);
+            pos += 5 + size;
+            return true;
         }
-        return args;
-    }
-    //Use to access to the individual argument values, it will return NULL of value is not there
-    static const char* arg(const char* name)
-    {
-        return args()[name].c_str();
-    }
 
-    /**
-     * Wrapper method for the ExecuteSuite which triggers execution of all registered 
-     * test suites
-     *
-     * @return: 0 if all tests are OK, non zero if any test failed 
-     */
-    static int ExecuteAllSuites(Logger *logger = new Logger())
-    {
-        return ExecuteSuite("", logger);
-    }
+        void Compact()
+        {
+            input.erase(0, pos);
+            pos = 0;
+        }
+
+        std::string input;
+        size_t      pos;
+    };
 
     /**
-     * Method to execute one (given) or all (given is empty) test suites registered by the 
-     * manager
-     *
-     * @return: 0 if all tests are OK, non zero if any test failed 
+     * Executes the suites in forked worker processes. Work is given to the workers as 
+     * tasks, a task is a suite and the index of the first test to execute. If a worker 
+     * dies in the middle of a test, the test is reported as failed and the rest of the 
+     * suite is given to a new worker as another task.
      */
-    static int ExecuteSuite(const std::string &iSuiteName, Logger *logger = new Logger())
+    class ProcessPool
     {
-        int foundSuits = 0;
-        int retVal = 0;
-        TestRunnerList& testRunners = TestRunners();
-        TestRunnerList::iterator it = testRunners.begin();
+    public:
+        ProcessPool(SuiteList &ioSuites, int iNumProcesses)
+            : m_suites(ioSuites)
+            , m_workers(iNumProcesses < (int)ioSuites.size() ? iNumProcesses : ioSuites.size())
+            , m_states(ioSuites.size())
+            , m_nextToFlush(0)
+        {
+            std::vector<int> order = Schedule(m_suites);
+            for(unsigned int i = 0; i < order.size(); i++)
+                m_pending.push_back(Task(order[i], 0));
+        }
 
-        int numAllAssertions = 0;
-        int numAllFailedAssertions = 0;
+        ~ProcessPool()
+        {
+            //Idle workers exit as soon as their command pipe is closed
+            for(unsigned int i = 0; i < m_workers.size(); i++)
+                m_workers[i].process.Wait();
+        }
 
-        for(; it != testRunners.end(); it++)
+        /**
+         * Executes all the suites, returns false if no worker could be started
+         */
+        bool Run(Logger *logger)
         {
-            if(iSuiteName != "" && it->first != iSuiteName)
-                continue;
+            platform::IgnoreBrokenPipe ignoreBrokenPipe;
 
-            foundSuits ++;
-            int numAssertions = 0;
-            int numFailedAssertions = 0;
+            int numStarted = 0;
+            for(unsigned int i = 0; i < m_workers.size(); i++)
+                numStarted += Spawn(m_workers[i]) ? 1 : 0;
+            if(numStarted == 0)
+                return false;
 
-            TestRunnerBase *pRunner = it->second;
-            TestSuiteBase *pSuite = pRunner->CreateSuite();
-            pSuite->logger = logger;
-            
-            if(pSuite->Active())
+            std::vector<int> files;
+            std::vector<Worker*> busy;
+            std::vector<int> ready;
+            for(;;)
             {
-                logger->log(it->first);
+                Assign();
 
-                if(pSuite->Construct() == 0)
+                files.clear();
+                busy.clear();
+                double deadline = 0;
+                for(unsigned int i = 0; i < m_workers.size(); i++)
                 {
-                    TestSuiteBase::TestList::iterator itTest = pSuite->Tests.begin();
-                    for(; itTest != pSuite->Tests.end(); itTest++)
-                    {
-                        if(pSuite->SetUp((*itTest)->name) != 0)
-                        {
-                            retVal ++;
-                            continue;
-                        }
+                    if(m_workers[i].task < 0)
+                        continue;
+                    files.push_back(m_workers[i].process.Input());
+                    busy.push_back(&m_workers[i]);
+                    if(m_workers[i].deadline > 0 && (deadline == 0 || m_workers[i].deadline < deadline))
+                        deadline = m_workers[i].deadline;
+                }
+                if(busy.empty())
+                    break;
 
-                        logger->log((*itTest)->name.c_str());
-                        try{
-                            (*itTest)->Execute(pSuite);
-                        }
-                        catch(Evaluator::Exception &e){
-                        }
-                        
-                        if(pSuite->numAssertions == numAssertions)
-                        {
-                            logger->log("...Failed (No Assertions)");
-                            retVal ++;
-                        }
-                        else if(pSuite->numFailedAssertions != numFailedAssertions)
-                        {
-                            char pBuf[1024];
-                            sprintf_s(pBuf, "...Failed (%i Assertions)", pSuite->numFailedAssertions - numFailedAssertions);
-                            logger->log(pBuf);
-                            retVal ++;
-                        }
-                        else {
-                            //char pBuf[1024];
-                            //sprintf_s(pBuf, "...OK (%i Assertions)", pSuite->numAssertions - numAssertions);
-                            //logger->log(pBuf);
-                            logger->log("...OK");
-                        }
-                        numAssertions = pSuite->numAssertions;
-                        numFailedAssertions = pSuite->numFailedAssertions;
-                        
-                        pSuite->TearDown((*itTest)->name);
+                platform::WaitReadable(files, WaitTime(deadline), ready);
+                for(unsigned int i = 0; i < ready.size(); i++)
+                {
+                    Worker &worker = *busy[ready[i]];
+                    char pBuf[4096];
+                    int numRead = platform::ReadSome(worker.process.Input(), pBuf, sizeof(pBuf));
+                    if(numRead > 0)
+                    {
+                        worker.frames.input.append(pBuf, numRead);
+                        Parse(worker);
+                    }
+                    else
+                    {
+                        Crashed(worker);
                     }
                 }
-                else
+
+                double now = platform::Now();
+                for(unsigned int i = 0; i < m_workers.size(); i++)
                 {
-                    logger->log("Could not Initialize the Test Suite, all tests will be skipped");
-                    retVal ++;
+                    Worker &worker = m_workers[i];
+                    if(worker.task >= 0 && worker.deadline > 0 && now >= worker.deadline)
+                        Crashed(worker, true);
                 }
-                
-                pSuite->Destruct();
+                Flush(logger);
+            }
+
+            //Workers which could not be started or restarted leave unfinished suites behind
+            for(unsigned int i = 0; i < m_pending.size(); i++)
+            {
+                SuiteState &state = m_states[m_pending[i].suite];
+                state.log.log("...Failed (Could not start a worker process)");
+                state.retVal ++;
+                if(--state.pendingTasks == 0)
+                    Finish(m_pending[i].suite);
+            }
+            m_pending.clear();
+            Flush(logger);
+            return true;
+        }
+
+    private:
+        struct Task
+        {
+            Task(int iSuite = 0, size_t iFirst = 0) : suite(iSuite), first(iFirst) {}
+            int     suite;
+            size_t  first;
+        };
+
+        struct SuiteState
+        {
+            SuiteState()
+                : numTests(0)
+                , active(true)
+                , constructFailed(false)
+                , retVal(0)
+                , numAssertions(0)
+                , numFailedAssertions(0)
+                , pendingTasks(1)
+                , done(false)
+                , seconds(0)
+            {
+            }
+            BufferedLogger  log;
+            size_t          numTests;
+            bool            active;
+            bool            constructFailed;
+            int             retVal;
+            int             numAssertions;
+            int             numFailedAssertions;
+            int             pendingTasks;
+            bool            done;
+            double          seconds;    //total time of the tasks
+        };
+
+        struct Worker
+        {
+            Worker() 
+                : task(-1), currentTest(-1), numStarted(0), lastFinished(-1), start(0)
+                , testStart(0), deadline(0) 
+            {
+            }
+            platform::ChildProcess  process;
+            int                     task;           //index of the suite, -1 if worker is idle
+            Task                    current;
+            FrameBuffer             frames;
+            long                    currentTest;    //test in progress, -1 if none
+            int                     numStarted;     //number of tests started in current task
+            long                    lastFinished;
+            double                  start;          //time the task is given to the worker
+            std::string             testName;       //name of the test in progress
+            double                  testStart;
+            double                  deadline;       //end of the budget of the test, 0 if none
+        };
+
+        bool Spawn(Worker &ioWorker)
+        {
+            ioWorker.process.Wait();
+            ioWorker.frames = FrameBuffer();
+            ioWorker.task = -1;
+            return ioWorker.process.Start(&ProcessPool::WorkerMain, this);
+        }
+
+        /**
+         * Gives the pending tasks to the idle workers
+         */
+        void Assign()
+        {
+            for(unsigned int i = 0; i < m_workers.size() && !m_pending.empty(); i++)
+            {
+                Worker &worker = m_workers[i];
+                if(worker.task >= 0 || !worker.process.Running())
+                    continue;
 
-                if(numAssertions == 0)
+                Task task = m_pending.front();
+                m_pending.pop_front();
+                int command[2] = { task.suite, (int)task.first };
+                worker.task = task.suite;
+                worker.current = task;
+                worker.currentTest = -1;
+                worker.numStarted = 0;
+                worker.lastFinished = (long)task.first - 1;
+                worker.start = platform::Now();
+                worker.deadline = 0;
+                if(!platform::WriteAll(worker.process.Output(), (const char*)command, sizeof(command)))
                 {
-                    logger->log("...Failed (No Assertions)");
-                    retVal ++;
+                    //Worker exited before it got the task, suite is not started yet so the 
+                    //task is given to the next idle worker
+                    worker.process.Kill();
+                    m_pending.push_front(task);
+                    Spawn(worker);
                 }
-                else
+            }
+        }
+
+        /**
+         * Processes the complete frames received from the worker
+         */
+        void Parse(Worker &ioWorker)
+        {
+            char kind = 0;
+            std::string data;
+            while(ioWorker.task >= 0 && ioWorker.frames.Next(kind, data))
+            {
+                const int *pValues = (const int*)data.data();
+                SuiteState &state = m_states[ioWorker.task];
+                switch(kind)
                 {
-                    numAllAssertions += numAssertions;
-                    numAllFailedAssertions += numFailedAssertions;
+                case 'L':
+                    state.log.log(data.c_str());
+                    break;
+                case 'P':
+                    PipeLogger::Timing(data, &state.log);
+                    break;
+                case 'B':
+                    PipeLogger::Benchmark(data, &state.log);
+                    break;
+                case 'F':
+                    PipeLogger::Failure(data, &state.log);
+                    break;
+                case 'D':
+                    PipeLogger::Result(data, &state.log);
+                    break;
+                case 'A':
+                    state.active = pValues[0] != 0;
+                    state.numTests = pValues[1];
+                    break;
+                case 'C':
+                    state.constructFailed = true;
+                    break;
+                case 'T':
+                    {
+                        TestStart started;
+                        memcpy(&started, data.data(), sizeof(started));
+                        ioWorker.currentTest = started.index;
+                        ioWorker.testName = data.c_str() + sizeof(started);
+                        ioWorker.testStart = platform::Now();
+                        ioWorker.deadline = started.timeout > 0 ? ioWorker.testStart + started.timeout : 0;
+                        ioWorker.numStarted ++;
+                    }
+                    break;
+                case 'E':
+                    {
+                        TestResult result;
+                        memcpy(&result, data.data(), sizeof(result));
+                        ioWorker.currentTest = -1;
+                        ioWorker.deadline = 0;
+                        ioWorker.lastFinished = result.index;
+                        state.retVal += result.retVal;
+                        state.numAssertions += result.numAssertions;
+                        state.numFailedAssertions += result.numFailedAssertions;
+                        RunHistory().Record(m_suites[ioWorker.task].name.c_str(), 
+                            data.c_str() + sizeof(result), result.seconds);
+                    }
+                    break;
+                case 'R':
+                    {
+                        int suite = ioWorker.task;
+                        state.seconds += platform::Now() - ioWorker.start;
+                        ioWorker.task = -1;
+                        if(--state.pendingTasks == 0)
+                            Finish(suite);
+                    }
+                    break;
                 }
             }
-            delete pSuite;
-            pSuite = 0;
         }
 
+        /**
+         * Worker died in the middle of a task or its test exceeded the time budget (it is 
+         * killed then). Test in progress is failed, remaining tests of the suite are 
+         * scheduled as a new task and a new worker is started
+         */
+        void Crashed(Worker &ioWorker, bool iTimedOut = false)
+        {
+            char status[64] = "";
+            ioWorker.process.Kill();
+            ioWorker.process.Wait(status, sizeof(status));
+
+            int suite = ioWorker.task;
+            SuiteState &state = m_states[suite];
+            state.seconds += platform::Now() - ioWorker.start;
+            char pBuf[1024];
+            if(ioWorker.currentTest >= 0)
+            {
+                char pReason[512];
+                double seconds = platform::Now() - ioWorker.testStart;
+                if(iTimedOut)
+                    sprintf_s(pReason, "Timeout, %s.%s after %.3f s", m_suites[suite].name.c_str(), 
+                        ioWorker.testName.c_str(), seconds);
+                else
+                    sprintf_s(pReason, "Crashed, %s", status);
+                sprintf_s(pBuf, "...Failed (%s)", pReason);
+                state.log.log(pBuf);
+                TestRecord record = { m_suites[suite].name.c_str(), ioWorker.testName.c_str(), 1, 0, 0, 
+                    seconds, pReason };
+                state.log.result(record);
+                state.retVal ++;
+                ioWorker.lastFinished = ioWorker.currentTest;
+            }
+            else
+            {
+                sprintf_s(pBuf, "...Crashed (%s)", status);
+                state.log.log(pBuf);
+                if(ioWorker.numStarted == 0)
+                    state.constructFailed = true;
+                else
+                    state.retVal ++;
+            }
+
+            if(!state.constructFailed && (size_t)(ioWorker.lastFinished + 1) < state.numTests)
+            {
+                state.pendingTasks ++;
+                m_pending.push_front(Task(suite, ioWorker.lastFinished + 1));
+            }
+            if(--state.pendingTasks == 0)
+                Finish(suite);
+
+            Spawn(ioWorker);
+        }
+
+        /**
+         * All tasks of the suite are completed, same checks as RunSuite
+         */
+        void Finish(int iSuite)
+        {
+            SuiteState &state = m_states[iSuite];
+            SuiteTask &task = m_suites[iSuite];
+            state.done = true;
+            if(!state.active)
+                return;
+
+            if(state.constructFailed)
+                state.retVal ++;
+
+            if(state.numAssertions == 0)
+            {
+                state.log.log("...Failed (No Assertions)");
+                state.retVal ++;
+            }
+            else
+            {
+                task.numAssertions = state.numAssertions;
+                task.numFailedAssertions = state.numFailedAssertions;
+            }
+            task.retVal = state.retVal;
+            state.log.timing(task.name.c_str(), "", PhaseSuite, state.seconds);
+            RunHistory().Record(task.name.c_str(), 0, state.seconds);
+        }
 
-        if(foundSuits == 0)
+        void Flush(Logger *logger)
         {
-            logger->log("Could not found any suit to execute");
-            retVal = 1;
+            while(m_nextToFlush < m_states.size() && m_states[m_nextToFlush].done)
+                m_states[m_nextToFlush++].log.Flush(logger);
         }
 
-        /*
-        logger->log("");
-        logger->log("********************************");
-        logger->log("*");
-        logger->log("* TEST RESULT IS    : "); //TODO << retVal << endl;
-        logger->log("* #Total Assertaions: "); //TODO << numAllAssertions << endl;
-        logger->log("* #Failed Assertions: "); //TODO << numAllFailedAssertions << endl;
-        logger->log("*");
-        logger->log("********************************");
-        */
-        return retVal;
-    }
+        /**
+         * Entry point of the worker processes, executes the tasks sent by the manager 
+         * until the manager closes the pipe
+         */
+        static int WorkerMain(int iInput, int iOutput, void *ipData)
+        {
+            ProcessPool *pPool = (ProcessPool*)ipData;
+            //Pipes of the other workers are inherited, they should only be open in the manager
+            for(unsigned int i = 0; i < pPool->m_workers.size(); i++)
+                pPool->m_workers[i].process.Close();
+            //Durations are recorded by the manager from the results, see ForkedMain
+            RunHistory().Enable(false);
 
-    /**
-     *
-     */
-    static TestRunnerList& TestRunners()
+            PipeLogger logger(iOutput);
+            int command[2];
+            while(platform::ReadAll(iInput, (char*)command, sizeof(command)))
+                pPool->RunTask(Task(command[0], command[1]), logger);
+            return 0;
+        }
+
+        void RunTask(const Task &iTask, PipeLogger &logger)
+        {
+            SuiteTask &suite = m_suites[iTask.suite];
+            if(!HasSelectedTests(suite.runner))
+            {
+                int numTests = 0;
+                for(TestBase *pTest = suite.runner->Tests(); pTest; pTest = pTest->next)
+                    numTests++;
+                int header[2] = { 0, numTests };
+                logger.Frame('A', header, sizeof(header));
+                logger.Frame('R', 0, 0);
+                return;
+            }
+            TestSuiteBase *pSuite = suite.runner->CreateSuite();
+            pSuite->logger = &logger;
+
+            bool active = pSuite->Active() && HasSelectedTests(pSuite);
+            int header[2] = { active ? 1 : 0, (int)pSuite->Tests.size() };
+            logger.Frame('A', header, sizeof(header));
+            if(active)
+            {
+                if(iTask.first == 0)
+                    logger.log(suite.name);
+
+                TestRange range(suite.runner, iTask.first, pSuite->Tests.size());
+                range.suite = pSuite;
+                RunRange(range, &logger, &logger);
+                if(range.constructFailed)
+                    logger.Frame('C', 0, 0);
+            }
+            delete pSuite;
+            logger.Frame('R', 0, 0);
+        }
+
+        SuiteList               &m_suites;
+        std::vector<Worker>     m_workers;
+        std::vector<SuiteState> m_states;
+        std::deque<Task>        m_pending;
+        size_t                  m_nextToFlush;
+    };
+
+    static void ExecuteInProcesses(SuiteList &ioSuites, int iNumProcesses, Logger *logger)
     {
-        static TestRunnerList testRunners;
-        return testRunners;
+        ProcessPool pool(ioSuites, iNumProcesses);
+        if(!pool.Run(logger))
+            ExecuteSerial(ioSuites, logger);
     }
 };
 
@@ -421,14 +4993,34 @@ template<class SuiteName>
 class TestRunner : public TestRunnerBase
 {
 public:
-    TestRunner(const std::string &iName)
+    TestRunner(const char *iName)
     {
-        TestManager::TestRunners().push_back(std::make_pair(iName, this));
+        name = iName;
+        next = 0;
+        TestManager::Register(this);
     }
     
     TestSuiteBase *CreateSuite()
     {
-        return new SuiteName();
+        TestSuiteBase *pSuite = new SuiteName();
+        pSuite->name = name;
+        size_t numTests = 0;
+        for(TestBase *pTest = Tests(); pTest; pTest = pTest->next)
+            numTests++;
+        pSuite->Tests.reserve(numTests);
+        for(TestBase *pTest = Tests(); pTest; pTest = pTest->next)
+            pSuite->Tests.push_back(pTest);
+        return pSuite;
+    }
+
+    TestBase* Tests()
+    {
+        return TestCatalog<SuiteName>::first;
+    }
+
+    bool Active()
+    {
+        return SuiteName::ActiveSuite != 0;
     }
 };
 
@@ -459,10 +5051,7 @@ public:
  *   instantiated as soon as application is started
  * * Define a base class as "_SuiteName" which will contain some internal code for your test suite
  *   - typedef for the test suite so inner classes can refer to the class name
- *   - static method to keep the instance of the test suite, this will force you that you can not 
- *     instantiate two instances of the same suite at the same time, limit parallel testing but this 
- *     is very unlikely scenario
- *   - Constructor which will set the current instance for future access by test method instances
+ *   - ActiveSuite constant so test methods of an inactive suite are not registered
  *   - Starter for your test suite class. It uses "struct" rather than "class" to avoid necessary 
  *     "public" keyword afterwards. This causes all methods to be public but test suites are not 
  *     intended to be used outside the test manager.
@@ -471,12 +5060,10 @@ public:
     struct SuiteName;                                                           \
     TestRunner<SuiteName> SuiteRunner_##SuiteName(#SuiteName);                  \
     struct _##SuiteName : public TestSuiteBase {                                  \
-        _##SuiteName() : TestSuiteBase() { if(_Active) CurrentTestSuite = this; }\
         typedef SuiteName CurrentSuiteName ;                                    \
-        static TestSuiteBase* CurrentTestSuite;                                 \
+        enum { ActiveSuite = _Active };                                         \
         bool Active() {return _Active; }                                        \
     };                                                                          \
-    TestSuiteBase * _##SuiteName::CurrentTestSuite = 0;                         \
 struct SuiteName : public _##SuiteName
 
 
@@ -487,18 +5074,70 @@ struct SuiteName : public _##SuiteName
 #define UNIQUE_NAME(x,y) x ## y
 #define TEST(TestDesc) MAKE_TEST(__COUNTER__ , TestDesc)
 
-#define MAKE_TEST(TestID, TestDesc) \
+/**
+ * Same as TEST with its own time budget in seconds, 0 for no limit. See TestSuiteBase::Timeout
+ */
+#define TEST_TIMEOUT(TestDesc, Seconds) MAKE_TIMED_TEST(__COUNTER__ , TestDesc, Seconds)
+
+/**
+ * Defines a benchmark method, it is registered and selected like a TEST but its body is 
+ * repeated and timed by the runner (see TestManager::RunBenchmark)
+ */
+#define BENCHMARK(TestDesc) MAKE_TEST_OBJECT(__COUNTER__ , TestDesc, -1, true)
+
+/**
+ * Defines a stress test, its body is executed on Threads threads at the same time and 
+ * repeated Iterations times on each one. Body gets the index of its thread as 
+ * threadIndex and the iteration as iteration. See ConcurrentTestBase.
+ *
+    TEST_CONCURRENT("PushPop", 4, 100000)
+    {
+        queue.Push(threadIndex);
+        CHECK_THAT(queue.Pop() >= 0);
+    }
+ */
+#define TEST_CONCURRENT(TestDesc, Threads, Iterations) \
+    MAKE_CONCURRENT_TEST(__COUNTER__ , TestDesc, Threads, Iterations)
+
+#define MAKE_TEST(TestID, TestDesc) MAKE_TIMED_TEST(TestID, TestDesc, -1)
+
+#define MAKE_TIMED_TEST(TestID, TestDesc, Seconds) MAKE_TEST_OBJECT(TestID, TestDesc, Seconds, false)
+
+#define MAKE_TEST_OBJECT(TestID, TestDesc, Seconds, Benchmark) \
     struct UNIQUE_NAME(Test_, TestID) : public TestBase { \
-        UNIQUE_NAME(Test_, TestID)() : TestBase(TestDesc) {\
-            if(CurrentTestSuite) \
-                CurrentTestSuite->Tests.push_back(this); \
+        UNIQUE_NAME(Test_, TestID)() : TestBase(TestDesc, Seconds, Benchmark) {\
+            TestCatalog<CurrentSuiteName>::Register(*this, TestID, ActiveSuite != 0); \
+        } \
+        static TestBase& Instance() { \
+            return TestRegistration<UNIQUE_NAME(Test_, TestID)>::test; \
         } \
         void Execute(TestSuiteBase *ipSuite) { \
             ((CurrentSuiteName*)ipSuite)->UNIQUE_NAME(_Test_, TestID)(); \
         } \
-    } UNIQUE_NAME(Test_, TestID); \
+        void Repeat(TestSuiteBase *ipSuite, long iIterations) { \
+            CurrentSuiteName *pSuite = (CurrentSuiteName*)ipSuite; \
+            for(long i = 0; i < iIterations; i++) \
+                pSuite->UNIQUE_NAME(_Test_, TestID)(); \
+        } \
+    }; \
     void UNIQUE_NAME(_Test_, TestID)()
 
+#define MAKE_CONCURRENT_TEST(TestID, TestDesc, Threads, Iterations) \
+    struct UNIQUE_NAME(Test_, TestID) : public ConcurrentTestBase { \
+        UNIQUE_NAME(Test_, TestID)() : ConcurrentTestBase(TestDesc, Threads, Iterations) {\
+            TestCatalog<CurrentSuiteName>::Register(*this, TestID, ActiveSuite != 0); \
+        } \
+        static TestBase& Instance() { \
+            return TestRegistration<UNIQUE_NAME(Test_, TestID)>::test; \
+        } \
+        void Run(TestSuiteBase *ipSuite, int iThread, long iIterations) { \
+            CurrentSuiteName *pSuite = (CurrentSuiteName*)ipSuite; \
+            for(long i = 0; i < iIterations; i++) \
+                pSuite->UNIQUE_NAME(_Test_, TestID)(iThread, i); \
+        } \
+    }; \
+    void UNIQUE_NAME(_Test_, TestID)(int threadIndex, long iteration)
+
 
 /**
  * MACRO definition for disabled test methods. There is no registration so they are simply methods
@@ -533,14 +5172,10 @@ struct SuiteName : public _##SuiteName
  */
 #define ASSERT_INTERNAL(statement, shallReturn) \
     {                               \
-        numAssertions ++;           \
-        if(!(statement))              \
+        TestSuiteBase::CountAssertion();        \
+        if(ESINTILER_UNLIKELY(!(statement)))    \
         {                           \
-            numFailedAssertions++;  \
-            char pBuf[2048];        \
-            sprintf_s(pBuf, "#statement: %s", #statement); logger->log(pBuf);    \
-            sprintf_s(pBuf, "#file     : %s", __FILE__); logger->log(pBuf);      \
-            sprintf_s(pBuf, "#line     : %i", __LINE__); logger->log(pBuf);      \
+            TestSuiteBase::AssertionFailed(#statement, 0, __FILE__, __LINE__);  \
             if(shallReturn)         \
                 return;             \
         }                           \
@@ -555,8 +5190,8 @@ struct SuiteName : public _##SuiteName
 #define _ASSERT_THAT(statement) if(statement) {};
 
 
-#define CHECK  Evaluator(logger, false, numAssertions, numFailedAssertions, __FILE__, __LINE__)
-#define ASSERT Evaluator(logger, true,  numAssertions, numFailedAssertions, __FILE__, __LINE__)
+#define CHECK  Evaluator(this, false, __FILE__, __LINE__)
+#define ASSERT Evaluator(this, true,  __FILE__, __LINE__)
 
 
 }; //namespace
@@ -35,82 +35,84 @@
 namespace esintiler
 {
 
-typedef enum Operators
+/**
+ * Operator which combines the result of a tester method with the result of the chain 
+ * before it
+ */
+enum Operators
 {
     OpNone,
-    OpNot,
     OpAnd,
-    OpOr,
-    OpTrue,
-    OpFalse
+    OpOr
 };
 
 /**
- *
+ * State of a tester in a chain. Chains are evaluated from left to right as the tester 
+ * methods are called, so every object only keeps the value under test, the result of the
+ * chain so far and how to combine it with the next tester method. Objects have the 
+ * same size at any position of the chain and nothing is allocated.
  */
 struct Base
 {
-    Base(Base *ipParent = 0, Operators iOp = OpNone) 
-        : parent(ipParent), op(iOp)
+    Base() 
+        : pValue(0), op(OpNone), previous(true), negate(false)
     {
     }
 
-    Base *root() 
+    void Bind(void *ipValue, Operators iOp, bool iPrevious, bool iNegate)
     {
-        Base *pRoot = this;
-        while(pRoot->parent)
-            pRoot = pRoot->parent;
-        return pRoot;
+        pValue = ipValue;
+        op = iOp;
+        previous = iPrevious;
+        negate = iNegate;
     }
-    
-    Base *parent;
-    Operators op;
+
+    /**
+     * Result of the chain after a tester method returned iResult
+     */
+    bool Combine(bool iResult) const
+    {
+        if(negate)
+            iResult = !iResult;
+        switch(op)
+        {
+        case OpAnd:
+            return previous && iResult;
+        case OpOr:
+            return previous || iResult;
+        default:
+            return iResult;
+        }
+    }
+
+    void      *pValue;      //value object under test
+    Operators  op;
+    bool       previous;    //result of the chain before this tester
+    bool       negate;      //tester is reached by "not"
 };
 
 /**
- * Result class is used to return the test result. It needs the ValueType 
- * and the ShouldType so it can provide "and" and "or" operators
+ * Result class is used to return the test result. It needs the ShouldType so it can 
+ * provide "and" and "or" operators. Result of the whole chain is already known when it
+ * is constructed.
  */
 template<class ShouldType>
-class Result : public Base
+class Result
 {
 public:
-    const int verbose;  //dev time variable for easy testing
-
-    Result(Base *ipParent, bool iResult) 
-        : Base(ipParent, iResult ? OpTrue : OpFalse)
-        , verbose(false)
+    Result(void *ipValue, bool iResult) 
+        : m_result(iResult)
     {
-        or.op = OpOr;
-        or.parent = this;
-
-        and.op = OpAnd;
-        and.parent = this;
+        or.Bind(ipValue, OpOr, iResult);
+        and.Bind(ipValue, OpAnd, iResult);
     }
     
     /**
      * Bool cast operator so result itself can be used directly in checking
      */
-    virtual operator bool()
+    operator bool() const
     {
-        //Find the parent first
-        std::vector<Base*> parents; //we will not keep the value object
-        for(Base *pParent = this; pParent->parent != 0; pParent = pParent->parent)
-        {
-            if(pParent->op == OpNone)
-                continue;
-            parents.push_back(pParent);
-        }
-        //start from top and evaluate the result
-        bool result = true;
-        std::vector<Base*>::iterator iEnd = parents.end();
-        do
-        {
-            result = GetResultValue(result, --iEnd);
-        } while(iEnd != parents.begin() );
-        if(verbose)
-            printf (" = %s\n", result ? "true" : "false");
-        return result;
+        return m_result;
     }
 
     ShouldType or;
@@ -118,101 +120,63 @@ public:
     ShouldType and;
 
 private:
-    inline bool GetResultValue(bool iStartResult, std::vector<Base*>::iterator &iObj)
-    {
-
-        Base *pObj = *iObj;
-        bool result = true;
-        switch(pObj->op)
-        {
-        case OpNot:
-            if(verbose)
-                printf(".not");
-            result = !GetResultValue(iStartResult, --iObj);
-            break;
-        case OpAnd:
-            if(verbose)
-                printf(".and");
-            result = GetResultValue(iStartResult, --iObj);
-            result &= iStartResult; 
-            break;
-        case OpOr:
-            if(verbose)
-                printf(".or");
-            result = GetResultValue(iStartResult, --iObj);
-            result |= iStartResult;
-            break;
-        case OpTrue:
-            if(verbose)
-                printf(".true");
-            result = true;
-            break;
-        case OpFalse:
-            if(verbose)
-                printf(".false");
-            result = false;
-            break;
-        default:
-            break;
-        }
-        return result;
-    }
+    bool m_result;
 };
 
 /**
  * Base class for all user provided tester classes
- * It needs to know the ValueType since it will store it and ShouldType 
- * since it needs to return dedicated Result instances
+ * It needs to know the ShouldType since it needs to return dedicated Result instances
  */
 template<class ShouldType>
 struct TesterBase : public Base
 {
     inline Result<ShouldType> result(bool iResult)
     {
-        return Result<ShouldType>(this, iResult);
+        return Result<ShouldType>(pValue, Combine(iResult));
     }
 };
 
 /** 
- *
+ * Tester which also provides "not" to negate the next tester method
  */
 template <class TT>
 class Should : public TT
 {
 public:
-    Should()
+    void Bind(void *ipValue, Operators iOp, bool iPrevious)
     {
-        not.op = OpNot;
-        not.parent = this;
+        TT::Bind(ipValue, iOp, iPrevious, false);
+        not.Bind(ipValue, iOp, iPrevious, true);
     }
+
     TT not;
 };
 
 /**
- * 
+ * Value under test, the root of a chain
  */
 template<class VT, class ShouldType>
-struct Value : public Base
+struct Value
 {
 public:
     Value(VT& iVal)
         : m_pVal(&iVal)
     {
-        should.parent = this;
+        should.Bind(m_pVal, OpNone, true);
     }
     
     Value(VT *iVal)
         : m_pVal(iVal)
     {
-        should.parent = this;
+        should.Bind(m_pVal, OpNone, true);
     }
 
-    virtual operator VT&() 
+    operator VT&() 
     { 
         return *m_pVal; 
     }
     
-    virtual operator VT*()
+    operator VT*()
     { 
         return m_pVal; 
     }
@@ -239,8 +203,6 @@ private:
         typedef VT ValueType;                                       \
         ValueType& value();                                         \
         ValueType* valuePtr();                                      \
-        _Base##TT () { CurrentTester() = this; } \
-        static _Base##TT*& CurrentTester() {static _Base##TT *pTester = 0; return pTester; }\
     };                                                              \
     struct TT: public _Base##TT
 
@@ -248,13 +210,11 @@ private:
 #define DECLARE_TESTER_VALUE(TT)                                    \
     inline _Base##TT::ValueType& _Base##TT::value()                 \
     {                                                               \
-        Base *pRoot = root();                                       \
-        return  (ValueType&) (*(Value##TT*)pRoot) ;                 \
+        return *(ValueType*)pValue;                                 \
     }                                                               \
     inline _Base##TT::ValueType* _Base##TT::valuePtr()              \
     {                                                               \
-        Base *pRoot = root();                                       \
-        return  (ValueType*) (*(Value##TT*)pRoot) ;                 \
+        return (ValueType*)pValue;                                  \
     }                                                               \
     Value##TT value(TT::ValueType& iVal) { return Value##TT(iVal); }\
     Value##TT value(TT::ValueType* iVal) { return Value##TT(iVal); }
@@ -0,0 +1,44 @@
+// main.cpp : Converts a binary log written by BinaryLogger to text, JUnit XML or JSON Lines
+//
+
+#include "stdio.h"
+#include <map>
+#include <vector>
+
+#include "../include/binary_log.h"
+
+using namespace esintiler;
+
+int main(int argc, char* argv[])
+{
+    std::string format = argc > 2 ? argv[2] : "text";
+    if(argc < 2 || (format != "text" && argc < 4))
+    {
+        printf("usage: bdd_log_convert <binary log> [text]\n");
+        printf("       bdd_log_convert <binary log> junit|jsonl <output file>\n");
+        return 2;
+    }
+
+    Logger *pLogger = 0;
+    if(format == "text")
+        pLogger = new Logger();
+    else if(format == "junit")
+        pLogger = new JUnitReporter(argv[3]);
+    else if(format == "jsonl")
+        pLogger = new JsonLinesReporter(argv[3]);
+    else
+    {
+        printf("Unknown format %s\n", format.c_str());
+        return 2;
+    }
+
+    bool replayed = BinaryLogger::Replay(argv[1], pLogger);
+    //reporters complete their files when they are destroyed
+    delete pLogger;
+    if(!replayed)
+    {
+        printf("Could not read %s\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+// assertion_bench.cpp : Benchmarks for the cost of the assertions
+//
+
+#include "self_bench.h"
+
+/**
+ * Fixture suites where every assertion fails, they are only executed by the 
+ * AssertionBenchmark. The default failure limit applies, so most of the failures take 
+ * the path of the suppressed ones like in a failing hot loop.
+ */
+const int NumFailures = 1000;
+
+TEST_SUITE(FailingCheckFixture)
+{
+    TEST("loop")
+    {
+        for(int i = 0; i < NumFailures; i++)
+            CHECK_THAT(i < 0);
+    }
+};
+
+TEST_SUITE(FailingAssertFixture)
+{
+    void Assert(int i)
+    {
+        ASSERT_THAT(i < 0);
+    }
+
+    TEST("loop")
+    {
+        for(int i = 0; i < NumFailures; i++)
+            Assert(i);
+    }
+};
+
+TEST_SUITE(EmptyFixture)
+{
+    TEST("loop")
+    {
+        CHECK_THAT(NumFailures > 0);
+    }
+};
+
+/**
+ * Each iteration reads a value the compiler can not predict and checks it once, so the
+ * reported time is the cost of a single passing assertion. "LoopOnly" does the same work
+ * without an assertion as the reference.
+ *
+ * Failing benchmarks execute a fixture suite with NumFailures failing assertions, since
+ * a benchmark stops at its first failure. "FailingReference" executes the same suite
+ * with a single passing assertion, so the cost of a failure is the difference divided by 
+ * NumFailures.
+ */
+TEST_SUITE(AssertionBenchmark)
+{
+    int Construct()
+    {
+        index = 0;
+        sum = 0;
+        numAssertions = 0;
+        numFailures = 0;
+        for(int i = 0; i < 256; i++)
+            values[i] = i;
+        return 0;
+    }
+
+    BENCHMARK("LoopOnly")
+    {
+        sum += values[index++ & 255] < 1000;
+    }
+
+    BENCHMARK("PassingCheckThat")
+    {
+        CHECK_THAT(values[index++ & 255] < 1000);
+    }
+
+    BENCHMARK("PassingCheck")
+    {
+        CHECK.True(values[index++ & 255] < 1000, "value is out of range");
+    }
+
+    BENCHMARK("PassingAssertThat")
+    {
+        ASSERT_THAT(values[index++ & 255] < 1000);
+    }
+
+    BENCHMARK("PassingEvaluator")
+    {
+        Evaluator(&silentLogger, false, numAssertions, numFailures, __FILE__, __LINE__)
+            .True(values[index++ & 255] < 1000, "value is out of range");
+    }
+
+    BENCHMARK("FailingReference")
+    {
+        TestManager::ExecuteSuite("EmptyFixture", &silentLogger);
+    }
+
+    BENCHMARK("FailingCheckThat")
+    {
+        TestManager::ExecuteSuite("FailingCheckFixture", &silentLogger);
+    }
+
+    BENCHMARK("FailingAssertThat")
+    {
+        TestManager::ExecuteSuite("FailingAssertFixture", &silentLogger);
+    }
+
+    BENCHMARK("FailingEvaluator")
+    {
+        Evaluator(&silentLogger, false, numAssertions, numFailures, __FILE__, __LINE__)
+            .True(values[index++ & 255] > 1000, "value is out of range");
+    }
+
+    int             values[256];
+    unsigned int    index;
+    int             sum;
+    int             numAssertions;
+    int             numFailures;
+    SilentLogger    silentLogger;
+};
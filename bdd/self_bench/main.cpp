@@ -0,0 +1,22 @@
+// main.cpp : Benchmarks of the framework itself
+//
+// Results are written as JSON Lines to esintiler_self_bench.jsonl, or to the file given
+// with "--jsonl <file>". "--benchmark-save <file>" keeps the samples and a later run with
+// "--benchmark-baseline <file>" fails the benchmarks which became slower, see TestManager.
+
+#include "self_bench.h"
+
+int main(int argc, char* argv[])
+{
+    TestManager::args(argc, argv);
+    if(!TestManager::JsonLinesFile())
+        TestManager::args()["--jsonl"] = "esintiler_self_bench.jsonl";
+
+    std::vector<std::string> suites;
+    suites.push_back("RunnerBenchmark");
+    suites.push_back("AssertionBenchmark");
+    suites.push_back("MatcherBenchmark");
+    int retVal = TestManager::ExecuteSuites(suites);
+    printf("%i\n", retVal);
+    return retVal;
+}
@@ -0,0 +1,69 @@
+// matcher_bench.cpp : Benchmarks for the cost of the value(...).should chains
+//
+
+#include "self_bench.h"
+#include "../include/numeric.h"
+
+/**
+ * Same checks as plain comparisons and as chains of the NumericTester, each iteration
+ * reads a value the compiler can not predict. "Comparison" is the reference for the
+ * chains.
+ */
+TEST_SUITE(MatcherBenchmark)
+{
+    int Construct()
+    {
+        index = 0;
+        for(int i = 0; i < 256; i++)
+            values[i] = i;
+        std::vector<int> candidates;
+        for(int i = 0; i < 1000000; i++)
+            candidates.push_back(i * 7);
+        pCandidates = new NumericSet<int>(candidates);
+        return 0;
+    }
+
+    void Destruct()
+    {
+        delete pCandidates;
+    }
+
+    BENCHMARK("Comparison")
+    {
+        int &v = values[index++ & 255];
+        CHECK_THAT(v > -1 && v != 1000);
+    }
+
+    BENCHMARK("ValueShould")
+    {
+        CHECK_THAT(value(values[index++ & 255]).should.be_less_than(1000));
+    }
+
+    BENCHMARK("ValueShouldAndNot")
+    {
+        CHECK_THAT(value(values[index++ & 255]).should.be_greater_than(-1).and.not.equal_to(1000));
+    }
+
+    BENCHMARK("ValueShouldLongChain")
+    {
+        CHECK_THAT(value(values[index++ & 255]).should.be_greater_than(-1).and.be_less_than(256)
+            .and.not.equal_to(1000).or.equal_to(-1));
+    }
+
+    /**
+     * Membership in a set of 1 000 000 values, the set is sorted once in Construct
+     */
+    BENCHMARK("ValueShouldBeIn")
+    {
+        CHECK_THAT(value(values[index++ & 255]).should.be_in(*pCandidates).or.be_less_than(256));
+    }
+
+    BENCHMARK("ValuesShouldBeIn")
+    {
+        CHECK_THAT(value(values, 256).should.any.be_in(*pCandidates));
+    }
+
+    int             values[256];
+    unsigned int    index;
+    NumericSet<int> *pCandidates;
+};
@@ -0,0 +1,98 @@
+// runner_bench.cpp : Benchmarks for the cost of registering, constructing and executing tests
+//
+
+#include "self_bench.h"
+
+/**
+ * Test which only counts the assertion a test needs to pass, RunnerBenchmark links them
+ * to the catalog of RunnerFixture
+ */
+struct EmptyTest : public TestBase
+{
+    EmptyTest() : TestBase("empty") {}
+
+    void Execute(TestSuiteBase *ipSuite)
+    {
+        ipSuite->CountAssertion();
+    }
+};
+
+/**
+ * Fixture suite without any test of its own, it is only executed by the RunnerBenchmark
+ */
+TEST_SUITE(RunnerFixture)
+{
+};
+
+/**
+ * Registration, construction and execution of RunnerFixture with 1 000, 10 000 and
+ * 100 000 tests. "Register" links the tests to the catalog like the test objects do when
+ * the application is loaded, "CreateSuite" constructs the suite and "ExecuteSuite"
+ * executes it with a SilentLogger. Per test overhead of the runner is the difference of
+ * "ExecuteSuite1" and "ExecuteSuite1k" divided by 999.
+ */
+TEST_SUITE(RunnerBenchmark)
+{
+    int Construct()
+    {
+        tests = new EmptyTest[MaxTests];
+        numCataloged = -1;
+        pRunner = TestManager::FindRunner("RunnerFixture");
+        return pRunner ? 0 : 1;
+    }
+
+    void Destruct()
+    {
+        Catalog(0);
+        delete [] tests;
+    }
+
+    /**
+     * Replaces the tests of RunnerFixture with the first iNum EmptyTests
+     */
+    void Catalog(int iNum)
+    {
+        TestCatalog<RunnerFixture>::first = 0;
+        TestCatalog<RunnerFixture>::last = 0;
+        for(int i = 0; i < iNum; i++)
+        {
+            tests[i].next = 0;
+            TestCatalog<RunnerFixture>::Register(tests[i], i, true);
+        }
+        numCataloged = iNum;
+    }
+
+    void CreateSuite(int iNum)
+    {
+        if(numCataloged != iNum)
+            Catalog(iNum);
+        TestSuiteBase *pSuite = pRunner->CreateSuite();
+        CHECK_THAT(pSuite->Tests.size() == (size_t)iNum);
+        delete pSuite;
+    }
+
+    void ExecuteSuite(int iNum)
+    {
+        if(numCataloged != iNum)
+            Catalog(iNum);
+        CHECK_THAT(TestManager::ExecuteSuite("RunnerFixture", &silentLogger) == 0);
+    }
+
+    BENCHMARK("Register1k")     { Catalog(1000); }
+    BENCHMARK("Register10k")    { Catalog(10000); }
+    BENCHMARK("Register100k")   { Catalog(100000); }
+
+    BENCHMARK("CreateSuite1k")  { CreateSuite(1000); }
+    BENCHMARK("CreateSuite10k") { CreateSuite(10000); }
+    BENCHMARK("CreateSuite100k"){ CreateSuite(100000); }
+
+    BENCHMARK("ExecuteSuite1")  { ExecuteSuite(1); }
+    BENCHMARK("ExecuteSuite1k") { ExecuteSuite(1000); }
+
+    enum { MaxTests = 100000 };
+
+    EmptyTest       *tests;
+    int             numCataloged;
+    TestRunnerBase  *pRunner;
+    SilentLogger    silentLogger;
+};
@@ -0,0 +1,31 @@
+/**
+ * Common parts of the framework benchmarks
+ */
+#pragma once
+
+#include "stdio.h"
+#include <map>
+#include <vector>
+
+#include "../include/suite.h"
+
+using namespace esintiler;
+
+/**
+ * Logger of the nested runs, it ignores everything so only the framework is measured
+ */
+class SilentLogger : public Logger
+{
+public:
+    void log(const char* ipMsg)
+    {
+    }
+
+    void failure(const FailureRecord &iFailure)
+    {
+    }
+
+    void summary(const RunSummary &iSummary)
+    {
+    }
+};
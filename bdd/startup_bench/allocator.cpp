@@ -0,0 +1,27 @@
+// allocator.cpp : Counting allocator of the startup benchmark
+//
+// It is kept out of the other files so the compiler can not inline the replaced operators
+// into their callers and mismatch them with the allocations of the standard library.
+
+#include <stdlib.h>
+#include <new>
+
+long NumAllocations = 0;
+
+/**
+ * Counting allocator, the value read at the start of main is the number of allocations
+ * made by the static objects
+ */
+void* operator new(size_t iSize)
+{
+    NumAllocations++;
+    void *pMemory = malloc(iSize ? iSize : 1);
+    if(!pMemory)
+        throw std::bad_alloc();
+    return pMemory;
+}
+
+void operator delete(void *ipMemory) throw()
+{
+    free(ipMemory);
+}
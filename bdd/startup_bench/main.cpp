@@ -0,0 +1,62 @@
+// main.cpp : Measures the startup of an application with 100 000 registered tests
+//
+// Prints the CPU time and the heap allocations spent before main, then the time to walk
+// the registry and to list the tests. "--run" also executes all of them.
+
+#include "startup_tests.h"
+
+//Number of the allocations made so far, see allocator.cpp
+extern long NumAllocations;
+
+/**
+ * Logger which only counts the messages
+ */
+class CountingLogger : public Logger
+{
+public:
+    CountingLogger() : numMessages(0) {}
+
+    void log(const char* ipMsg)
+    {
+        numMessages++;
+    }
+
+    void summary(const RunSummary &iSummary)
+    {
+        printf("run tests        : %i\n", iSummary.numTests);
+        printf("run assertions   : %i\n", iSummary.numAssertions);
+    }
+
+    long numMessages;
+};
+
+int main(int argc, char* argv[])
+{
+    double startupTime = platform::ProcessCpuTime();
+    long startupAllocations = NumAllocations;
+
+    double start = platform::Now();
+    TestManager::TestRunnerList &runners = TestManager::TestRunners();
+    long numTests = 0;
+    for(size_t i = 0; i < runners.size(); i++)
+        for(TestBase *pTest = runners[i].second->Tests(); pTest; pTest = pTest->next)
+            numTests++;
+    double walkTime = platform::Now() - start;
+
+    printf("suites           : %i\n", (int)runners.size());
+    printf("tests            : %li\n", numTests);
+    printf("startup cpu      : %.6f s\n", startupTime);
+    printf("startup allocs   : %li\n", startupAllocations);
+    printf("registry walk    : %.6f s\n", walkTime);
+
+    bool run = argc > 1 && std::string(argv[1]) == "--run";
+    if(!run)
+        TestManager::args()["--list"] = "1";
+    CountingLogger logger;
+    start = platform::Now();
+    int retVal = TestManager::ExecuteAllSuites(&logger);
+    printf("%s             : %.6f s\n", run ? "run " : "list", platform::Now() - start);
+    if(!run)
+        printf("listed           : %li\n", logger.numMessages);
+    return retVal;
+}
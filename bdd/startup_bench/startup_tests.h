@@ -0,0 +1,34 @@
+/**
+ * Macros generating the suites of the startup benchmark. Each STARTUP_SUITES_10 defines
+ * 10 suites with 100 tests each, so the hundred files of the benchmark register 100 000 
+ * tests. Files are kept this small so each of them compiles quickly and in little memory.
+ * Tests only pass a single check, the benchmark is about their registration.
+ */
+#pragma once
+
+#include "stdio.h"
+#include <map>
+#include <vector>
+
+#include "../include/suite.h"
+
+using namespace esintiler;
+
+#define STARTUP_TEST(Index) TEST("test" #Index) { CHECK_THAT(true); }
+
+#define STARTUP_TESTS_10(Prefix) \
+    STARTUP_TEST(Prefix##0) STARTUP_TEST(Prefix##1) STARTUP_TEST(Prefix##2) STARTUP_TEST(Prefix##3) \
+    STARTUP_TEST(Prefix##4) STARTUP_TEST(Prefix##5) STARTUP_TEST(Prefix##6) STARTUP_TEST(Prefix##7) \
+    STARTUP_TEST(Prefix##8) STARTUP_TEST(Prefix##9)
+
+#define STARTUP_TESTS_100 \
+    STARTUP_TESTS_10(0) STARTUP_TESTS_10(1) STARTUP_TESTS_10(2) STARTUP_TESTS_10(3) \
+    STARTUP_TESTS_10(4) STARTUP_TESTS_10(5) STARTUP_TESTS_10(6) STARTUP_TESTS_10(7) \
+    STARTUP_TESTS_10(8) STARTUP_TESTS_10(9)
+
+#define STARTUP_SUITE(Index) TEST_SUITE(StartupSuite##Index) { STARTUP_TESTS_100 };
+
+#define STARTUP_SUITES_10(Prefix) \
+    STARTUP_SUITE(Prefix##0) STARTUP_SUITE(Prefix##1) STARTUP_SUITE(Prefix##2) STARTUP_SUITE(Prefix##3) \
+    STARTUP_SUITE(Prefix##4) STARTUP_SUITE(Prefix##5) STARTUP_SUITE(Prefix##6) STARTUP_SUITE(Prefix##7) \
+    STARTUP_SUITE(Prefix##8) STARTUP_SUITE(Prefix##9)
@@ -0,0 +1,6 @@
+// tests_00.cpp : Suites StartupSuite000 to StartupSuite009 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(00)
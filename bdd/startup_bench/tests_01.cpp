@@ -0,0 +1,6 @@
+// tests_01.cpp : Suites StartupSuite010 to StartupSuite019 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(01)
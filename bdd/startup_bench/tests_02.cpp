@@ -0,0 +1,6 @@
+// tests_02.cpp : Suites StartupSuite020 to StartupSuite029 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(02)
@@ -0,0 +1,6 @@
+// tests_03.cpp : Suites StartupSuite030 to StartupSuite039 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(03)
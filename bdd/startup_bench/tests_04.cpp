@@ -0,0 +1,6 @@
+// tests_04.cpp : Suites StartupSuite040 to StartupSuite049 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(04)
@@ -0,0 +1,6 @@
+// tests_05.cpp : Suites StartupSuite050 to StartupSuite059 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(05)
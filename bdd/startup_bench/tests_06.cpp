@@ -0,0 +1,6 @@
+// tests_06.cpp : Suites StartupSuite060 to StartupSuite069 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(06)
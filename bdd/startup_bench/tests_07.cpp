@@ -0,0 +1,6 @@
+// tests_07.cpp : Suites StartupSuite070 to StartupSuite079 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(07)
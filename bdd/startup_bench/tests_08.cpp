@@ -0,0 +1,6 @@
+// tests_08.cpp : Suites StartupSuite080 to StartupSuite089 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(08)
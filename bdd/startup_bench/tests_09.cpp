@@ -0,0 +1,6 @@
+// tests_09.cpp : Suites StartupSuite090 to StartupSuite099 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(09)
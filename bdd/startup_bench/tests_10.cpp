@@ -0,0 +1,6 @@
+// tests_10.cpp : Suites StartupSuite100 to StartupSuite109 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(10)
@@ -0,0 +1,6 @@
+// tests_11.cpp : Suites StartupSuite110 to StartupSuite119 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(11)
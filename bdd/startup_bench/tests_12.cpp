@@ -0,0 +1,6 @@
+// tests_12.cpp : Suites StartupSuite120 to StartupSuite129 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(12)
@@ -0,0 +1,6 @@
+// tests_13.cpp : Suites StartupSuite130 to StartupSuite139 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(13)
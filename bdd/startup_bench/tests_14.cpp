@@ -0,0 +1,6 @@
+// tests_14.cpp : Suites StartupSuite140 to StartupSuite149 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(14)
@@ -0,0 +1,6 @@
+// tests_15.cpp : Suites StartupSuite150 to StartupSuite159 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(15)
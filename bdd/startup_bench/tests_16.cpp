@@ -0,0 +1,6 @@
+// tests_16.cpp : Suites StartupSuite160 to StartupSuite169 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(16)
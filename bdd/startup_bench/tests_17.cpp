@@ -0,0 +1,6 @@
+// tests_17.cpp : Suites StartupSuite170 to StartupSuite179 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(17)
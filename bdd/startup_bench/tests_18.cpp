@@ -0,0 +1,6 @@
+// tests_18.cpp : Suites StartupSuite180 to StartupSuite189 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(18)
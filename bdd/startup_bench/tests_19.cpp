@@ -0,0 +1,6 @@
+// tests_19.cpp : Suites StartupSuite190 to StartupSuite199 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(19)
@@ -0,0 +1,6 @@
+// tests_20.cpp : Suites StartupSuite200 to StartupSuite209 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(20)
@@ -0,0 +1,6 @@
+// tests_21.cpp : Suites StartupSuite210 to StartupSuite219 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(21)
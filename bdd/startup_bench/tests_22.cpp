@@ -0,0 +1,6 @@
+// tests_22.cpp : Suites StartupSuite220 to StartupSuite229 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(22)
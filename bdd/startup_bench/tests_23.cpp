@@ -0,0 +1,6 @@
+// tests_23.cpp : Suites StartupSuite230 to StartupSuite239 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(23)
@@ -0,0 +1,6 @@
+// tests_24.cpp : Suites StartupSuite240 to StartupSuite249 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(24)
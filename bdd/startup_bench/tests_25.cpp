@@ -0,0 +1,6 @@
+// tests_25.cpp : Suites StartupSuite250 to StartupSuite259 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(25)
@@ -0,0 +1,6 @@
+// tests_26.cpp : Suites StartupSuite260 to StartupSuite269 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(26)
@@ -0,0 +1,6 @@
+// tests_27.cpp : Suites StartupSuite270 to StartupSuite279 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(27)
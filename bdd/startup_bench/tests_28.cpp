@@ -0,0 +1,6 @@
+// tests_28.cpp : Suites StartupSuite280 to StartupSuite289 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(28)
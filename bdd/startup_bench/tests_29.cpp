@@ -0,0 +1,6 @@
+// tests_29.cpp : Suites StartupSuite290 to StartupSuite299 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(29)
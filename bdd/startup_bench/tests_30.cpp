@@ -0,0 +1,6 @@
+// tests_30.cpp : Suites StartupSuite300 to StartupSuite309 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(30)
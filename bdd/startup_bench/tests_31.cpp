@@ -0,0 +1,6 @@
+// tests_31.cpp : Suites StartupSuite310 to StartupSuite319 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(31)
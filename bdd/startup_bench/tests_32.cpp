@@ -0,0 +1,6 @@
+// tests_32.cpp : Suites StartupSuite320 to StartupSuite329 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(32)
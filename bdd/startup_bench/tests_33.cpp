@@ -0,0 +1,6 @@
+// tests_33.cpp : Suites StartupSuite330 to StartupSuite339 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(33)
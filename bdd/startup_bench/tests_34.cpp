@@ -0,0 +1,6 @@
+// tests_34.cpp : Suites StartupSuite340 to StartupSuite349 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(34)
@@ -0,0 +1,6 @@
+// tests_35.cpp : Suites StartupSuite350 to StartupSuite359 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(35)
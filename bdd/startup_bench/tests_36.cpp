@@ -0,0 +1,6 @@
+// tests_36.cpp : Suites StartupSuite360 to StartupSuite369 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(36)
@@ -0,0 +1,6 @@
+// tests_37.cpp : Suites StartupSuite370 to StartupSuite379 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(37)
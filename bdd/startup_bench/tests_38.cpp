@@ -0,0 +1,6 @@
+// tests_38.cpp : Suites StartupSuite380 to StartupSuite389 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(38)
@@ -0,0 +1,6 @@
+// tests_39.cpp : Suites StartupSuite390 to StartupSuite399 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(39)
@@ -0,0 +1,6 @@
+// tests_40.cpp : Suites StartupSuite400 to StartupSuite409 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(40)
@@ -0,0 +1,6 @@
+// tests_41.cpp : Suites StartupSuite410 to StartupSuite419 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(41)
@@ -0,0 +1,6 @@
+// tests_42.cpp : Suites StartupSuite420 to StartupSuite429 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(42)
@@ -0,0 +1,6 @@
+// tests_43.cpp : Suites StartupSuite430 to StartupSuite439 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(43)
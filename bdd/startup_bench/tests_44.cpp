@@ -0,0 +1,6 @@
+// tests_44.cpp : Suites StartupSuite440 to StartupSuite449 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(44)
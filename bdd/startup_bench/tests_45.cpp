@@ -0,0 +1,6 @@
+// tests_45.cpp : Suites StartupSuite450 to StartupSuite459 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(45)
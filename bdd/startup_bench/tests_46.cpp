@@ -0,0 +1,6 @@
+// tests_46.cpp : Suites StartupSuite460 to StartupSuite469 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(46)
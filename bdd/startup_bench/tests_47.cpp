@@ -0,0 +1,6 @@
+// tests_47.cpp : Suites StartupSuite470 to StartupSuite479 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(47)
@@ -0,0 +1,6 @@
+// tests_48.cpp : Suites StartupSuite480 to StartupSuite489 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(48)
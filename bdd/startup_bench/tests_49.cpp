@@ -0,0 +1,6 @@
+// tests_49.cpp : Suites StartupSuite490 to StartupSuite499 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(49)
@@ -0,0 +1,6 @@
+// tests_50.cpp : Suites StartupSuite500 to StartupSuite509 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(50)
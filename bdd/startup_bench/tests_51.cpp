@@ -0,0 +1,6 @@
+// tests_51.cpp : Suites StartupSuite510 to StartupSuite519 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(51)
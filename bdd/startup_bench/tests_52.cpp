@@ -0,0 +1,6 @@
+// tests_52.cpp : Suites StartupSuite520 to StartupSuite529 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(52)
@@ -0,0 +1,6 @@
+// tests_53.cpp : Suites StartupSuite530 to StartupSuite539 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(53)
@@ -0,0 +1,6 @@
+// tests_54.cpp : Suites StartupSuite540 to StartupSuite549 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(54)
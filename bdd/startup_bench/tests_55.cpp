@@ -0,0 +1,6 @@
+// tests_55.cpp : Suites StartupSuite550 to StartupSuite559 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(55)
@@ -0,0 +1,6 @@
+// tests_56.cpp : Suites StartupSuite560 to StartupSuite569 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(56)
@@ -0,0 +1,6 @@
+// tests_57.cpp : Suites StartupSuite570 to StartupSuite579 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(57)
@@ -0,0 +1,6 @@
+// tests_58.cpp : Suites StartupSuite580 to StartupSuite589 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(58)
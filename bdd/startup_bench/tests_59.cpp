@@ -0,0 +1,6 @@
+// tests_59.cpp : Suites StartupSuite590 to StartupSuite599 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(59)
@@ -0,0 +1,6 @@
+// tests_60.cpp : Suites StartupSuite600 to StartupSuite609 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(60)
@@ -0,0 +1,6 @@
+// tests_61.cpp : Suites StartupSuite610 to StartupSuite619 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(61)
@@ -0,0 +1,6 @@
+// tests_62.cpp : Suites StartupSuite620 to StartupSuite629 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(62)
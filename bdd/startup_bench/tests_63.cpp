@@ -0,0 +1,6 @@
+// tests_63.cpp : Suites StartupSuite630 to StartupSuite639 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(63)
@@ -0,0 +1,6 @@
+// tests_64.cpp : Suites StartupSuite640 to StartupSuite649 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(64)
@@ -0,0 +1,6 @@
+// tests_65.cpp : Suites StartupSuite650 to StartupSuite659 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(65)
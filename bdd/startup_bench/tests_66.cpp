@@ -0,0 +1,6 @@
+// tests_66.cpp : Suites StartupSuite660 to StartupSuite669 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(66)
@@ -0,0 +1,6 @@
+// tests_67.cpp : Suites StartupSuite670 to StartupSuite679 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(67)
@@ -0,0 +1,6 @@
+// tests_68.cpp : Suites StartupSuite680 to StartupSuite689 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(68)
@@ -0,0 +1,6 @@
+// tests_69.cpp : Suites StartupSuite690 to StartupSuite699 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(69)
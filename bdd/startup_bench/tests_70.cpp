@@ -0,0 +1,6 @@
+// tests_70.cpp : Suites StartupSuite700 to StartupSuite709 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(70)
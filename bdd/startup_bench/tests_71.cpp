@@ -0,0 +1,6 @@
+// tests_71.cpp : Suites StartupSuite710 to StartupSuite719 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(71)
@@ -0,0 +1,6 @@
+// tests_72.cpp : Suites StartupSuite720 to StartupSuite729 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(72)
@@ -0,0 +1,6 @@
+// tests_73.cpp : Suites StartupSuite730 to StartupSuite739 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(73)
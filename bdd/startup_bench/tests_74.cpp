@@ -0,0 +1,6 @@
+// tests_74.cpp : Suites StartupSuite740 to StartupSuite749 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(74)
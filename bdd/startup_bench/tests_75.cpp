@@ -0,0 +1,6 @@
+// tests_75.cpp : Suites StartupSuite750 to StartupSuite759 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(75)
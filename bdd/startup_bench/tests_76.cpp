@@ -0,0 +1,6 @@
+// tests_76.cpp : Suites StartupSuite760 to StartupSuite769 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(76)
@@ -0,0 +1,6 @@
+// tests_77.cpp : Suites StartupSuite770 to StartupSuite779 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(77)
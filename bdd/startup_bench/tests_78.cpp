@@ -0,0 +1,6 @@
+// tests_78.cpp : Suites StartupSuite780 to StartupSuite789 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(78)
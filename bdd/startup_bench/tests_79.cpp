@@ -0,0 +1,6 @@
+// tests_79.cpp : Suites StartupSuite790 to StartupSuite799 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(79)
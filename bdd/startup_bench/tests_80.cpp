@@ -0,0 +1,6 @@
+// tests_80.cpp : Suites StartupSuite800 to StartupSuite809 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(80)
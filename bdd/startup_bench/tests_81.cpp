@@ -0,0 +1,6 @@
+// tests_81.cpp : Suites StartupSuite810 to StartupSuite819 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(81)
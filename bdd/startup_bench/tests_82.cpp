@@ -0,0 +1,6 @@
+// tests_82.cpp : Suites StartupSuite820 to StartupSuite829 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(82)
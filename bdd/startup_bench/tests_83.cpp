@@ -0,0 +1,6 @@
+// tests_83.cpp : Suites StartupSuite830 to StartupSuite839 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(83)
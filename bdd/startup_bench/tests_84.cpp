@@ -0,0 +1,6 @@
+// tests_84.cpp : Suites StartupSuite840 to StartupSuite849 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(84)
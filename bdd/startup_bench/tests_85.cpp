@@ -0,0 +1,6 @@
+// tests_85.cpp : Suites StartupSuite850 to StartupSuite859 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(85)
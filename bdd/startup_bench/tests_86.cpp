@@ -0,0 +1,6 @@
+// tests_86.cpp : Suites StartupSuite860 to StartupSuite869 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(86)
@@ -0,0 +1,6 @@
+// tests_87.cpp : Suites StartupSuite870 to StartupSuite879 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(87)
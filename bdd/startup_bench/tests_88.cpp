@@ -0,0 +1,6 @@
+// tests_88.cpp : Suites StartupSuite880 to StartupSuite889 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(88)
@@ -0,0 +1,6 @@
+// tests_89.cpp : Suites StartupSuite890 to StartupSuite899 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(89)
@@ -0,0 +1,6 @@
+// tests_90.cpp : Suites StartupSuite900 to StartupSuite909 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(90)
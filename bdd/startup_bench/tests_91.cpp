@@ -0,0 +1,6 @@
+// tests_91.cpp : Suites StartupSuite910 to StartupSuite919 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(91)
@@ -0,0 +1,6 @@
+// tests_92.cpp : Suites StartupSuite920 to StartupSuite929 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(92)
@@ -0,0 +1,6 @@
+// tests_93.cpp : Suites StartupSuite930 to StartupSuite939 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(93)
@@ -0,0 +1,6 @@
+// tests_94.cpp : Suites StartupSuite940 to StartupSuite949 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(94)
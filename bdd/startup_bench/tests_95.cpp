@@ -0,0 +1,6 @@
+// tests_95.cpp : Suites StartupSuite950 to StartupSuite959 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(95)
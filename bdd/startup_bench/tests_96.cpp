@@ -0,0 +1,6 @@
+// tests_96.cpp : Suites StartupSuite960 to StartupSuite969 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(96)
@@ -0,0 +1,6 @@
+// tests_97.cpp : Suites StartupSuite970 to StartupSuite979 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(97)
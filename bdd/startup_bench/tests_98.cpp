@@ -0,0 +1,6 @@
+// tests_98.cpp : Suites StartupSuite980 to StartupSuite989 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(98)
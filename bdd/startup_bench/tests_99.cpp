@@ -0,0 +1,6 @@
+// tests_99.cpp : Suites StartupSuite990 to StartupSuite999 of the startup benchmark
+//
+
+#include "startup_tests.h"
+
+STARTUP_SUITES_10(99)
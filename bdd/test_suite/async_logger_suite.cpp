@@ -0,0 +1,225 @@
+// async_logger_suite.cpp : Tests for the AsyncLogger
+//
+
+#include "stdio.h"
+#include <map>
+#include <vector>
+
+#include "../include/async_logger.h"
+#include "test_suite.h"
+
+const char *AsyncFileName = "esintiler_async_test.txt";
+
+std::vector<std::string> ReadLines(const char *ipFile)
+{
+    std::vector<std::string> lines;
+    FILE *pFile = platform::OpenFile(ipFile, "r");
+    if(!pFile)
+        return lines;
+    std::string line;
+    char pBuf[4096];
+    while(fgets(pBuf, sizeof(pBuf), pFile))
+    {
+        line += pBuf;
+        if(line[line.size() - 1] == '\n')
+        {
+            line.erase(line.size() - 1);
+            lines.push_back(line);
+            line.clear();
+        }
+    }
+    fclose(pFile);
+    return lines;
+}
+
+/**
+ * Logs numbered messages from its own thread
+ */
+struct LoggingThread : public platform::Thread
+{
+    LoggingThread(Logger *ipLogger, int iId, int iCount) : logger(ipLogger), id(iId), count(iCount) {}
+
+    void Run()
+    {
+        char pBuf[64];
+        for(int i = 0; i < count; i++)
+        {
+            sprintf_s(pBuf, "%i %i", id, i);
+            logger->log(pBuf);
+        }
+    }
+
+    Logger *logger;
+    int     id;
+    int     count;
+};
+
+/**
+ * Logs a few messages to the async logger and crashes
+ */
+int CrashingLoggerMain(int iInput, int iOutput, void *ipData)
+{
+    FILE *pFile = platform::OpenFile(AsyncFileName, "w");
+    AsyncLogger *pLogger = new AsyncLogger(fileno(pFile));
+    char pBuf[64];
+    for(int i = 0; i < 100; i++)
+    {
+        sprintf_s(pBuf, "message %i", i);
+        pLogger->log(pBuf);
+    }
+    abort();
+    return 0;
+}
+
+TEST_SUITE(AsyncLoggerTester)
+{
+    void TearDown(const std::string &iName)
+    {
+        remove(AsyncFileName);
+    }
+
+    TEST("MessagesOfEachThreadShouldBeWrittenInOrder")
+    {
+        const int numThreads = 4;
+        const int numMessages = 5000;
+        FILE *pFile = platform::OpenFile(AsyncFileName, "w");
+        ASSERT_THAT(pFile != 0);
+        {
+            //small buffer so the writers have to wait for each other
+            AsyncLogger asyncLogger(fileno(pFile), 4096);
+            std::vector<LoggingThread*> threads;
+            for(int i = 0; i < numThreads; i++)
+                threads.push_back(new LoggingThread(&asyncLogger, i, numMessages));
+            for(int i = 0; i < numThreads; i++)
+                threads[i]->Start();
+            for(int i = 0; i < numThreads; i++)
+            {
+                threads[i]->Join();
+                delete threads[i];
+            }
+        }
+        fclose(pFile);
+
+        std::vector<std::string> lines = ReadLines(AsyncFileName);
+        CHECK_THAT(lines.size() == numThreads * numMessages);
+        std::vector<int> next(numThreads, 0);
+        int numWrong = 0;
+        for(unsigned int i = 0; i < lines.size(); i++)
+        {
+            int id = -1;
+            int index = -1;
+            if(sscanf(lines[i].c_str(), "%i %i", &id, &index) != 2 || id < 0 || id >= numThreads)
+            {
+                numWrong++;
+                continue;
+            }
+            numWrong += index != next[id];
+            next[id] = index + 1;
+        }
+        CHECK_THAT(numWrong == 0);
+    }
+
+    TEST("LongMessagesShouldBeWrittenAsIs")
+    {
+        std::string longMessage;
+        for(int i = 0; i < 1000; i++)
+            longMessage += (char)('a' + i % 26);
+        FILE *pFile = platform::OpenFile(AsyncFileName, "w");
+        ASSERT_THAT(pFile != 0);
+        {
+            AsyncLogger asyncLogger(fileno(pFile));
+            asyncLogger.log("short");
+            asyncLogger.log(longMessage);
+            asyncLogger.log("");
+            asyncLogger.Flush();
+            std::vector<std::string> lines = ReadLines(AsyncFileName);
+            ASSERT_THAT(lines.size() == 3);
+            CHECK_THAT(lines[0] == "short");
+            CHECK_THAT(lines[1] == longMessage);
+            CHECK_THAT(lines[2] == "");
+        }
+        fclose(pFile);
+    }
+
+    TEST("FailuresShouldBeWrittenAsLoggerWritesThem")
+    {
+        std::string longMessage(1500, 'm');
+        char pLocal[32];
+        sprintf_s(pLocal, "local %i", 7);
+        FailureRecord failures[] = {
+            { "i < 100", 0, "suite.cpp", 12, "Suite", "test" },
+            { 0, pLocal, "suite.cpp", 13, "Suite", "test" },
+            { 0, 0, "suite.cpp", 14, "Suite", "test" },
+            { 0, longMessage.c_str(), "suite.cpp", 15, "Suite", "test" }
+        };
+        MessageLogger reference;
+        FILE *pFile = platform::OpenFile(AsyncFileName, "w");
+        ASSERT_THAT(pFile != 0);
+        {
+            AsyncLogger asyncLogger(fileno(pFile));
+            for(int i = 0; i < 4; i++)
+            {
+                asyncLogger.failure(failures[i]);
+                reference.failure(failures[i]);
+            }
+            //message is copied, it may be gone before the failure is written
+            strcpy(pLocal, "changed");
+        }
+        fclose(pFile);
+
+        std::vector<std::string> lines = ReadLines(AsyncFileName);
+        ASSERT_THAT(lines.size() == reference.m_log.size());
+        for(unsigned int i = 0; i + 1 < lines.size(); i++)
+            CHECK_THAT(lines[i] == reference.m_log[i]);
+        CHECK_THAT(lines.back() == "#msg     : " + longMessage.substr(0, 1024));
+    }
+
+    TEST("DroppedMessagesShouldBeReported")
+    {
+        const int numMessages = 20000;
+        FILE *pFile = platform::OpenFile(AsyncFileName, "w");
+        ASSERT_THAT(pFile != 0);
+        {
+            AsyncLogger asyncLogger(fileno(pFile), 4096, AsyncLogger::Drop);
+            LoggingThread thread(&asyncLogger, 0, numMessages);
+            thread.Run();
+        }
+        fclose(pFile);
+
+        //every message is either written or counted as dropped
+        std::vector<std::string> lines = ReadLines(AsyncFileName);
+        long total = 0;
+        for(unsigned int i = 0; i < lines.size(); i++)
+        {
+            long dropped = 0;
+            if(sscanf(lines[i].c_str(), "...%li log messages are dropped", &dropped) == 1)
+                total += dropped;
+            else
+                total++;
+        }
+        CHECK_THAT(total == numMessages);
+    }
+
+    TEST("MessagesShouldBeWrittenOnCrash")
+    {
+        if(!platform::HasFork)
+        {
+            CHECK_THAT(!platform::HasFork);
+            return;
+        }
+        platform::ChildProcess child;
+        ASSERT_THAT(child.Start(&CrashingLoggerMain, 0));
+        char status[64] = "";
+        CHECK_THAT(!child.Wait(status, sizeof(status)));
+
+        std::vector<std::string> lines = ReadLines(AsyncFileName);
+        int numMissing = 0;
+        for(int i = 0; i < 100; i++)
+        {
+            char pBuf[64];
+            sprintf_s(pBuf, "message %i", i);
+            numMissing += std::find(lines.begin(), lines.end(), pBuf) == lines.end();
+        }
+        CHECK_THAT(numMissing == 0);
+    }
+};
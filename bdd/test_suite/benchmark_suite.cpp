@@ -0,0 +1,271 @@
+// benchmark_suite.cpp : Tests for the benchmarks
+//
+
+#include "test_suite.h"
+
+/**
+ * Logger which keeps the messages and the benchmark results
+ */
+class BenchmarkLogger : public MessageLogger
+{
+public:
+    void benchmark(const BenchmarkResult &iResult)
+    {
+        m_results.push_back(iResult);
+        m_log.push_back("#benchmark");
+    }
+
+    void summary(const RunSummary &iSummary)
+    {
+        m_summary = iSummary;
+    }
+
+    std::vector<BenchmarkResult>    m_results;
+    RunSummary                      m_summary;
+};
+
+/**
+ * Fixture suites, they are only executed by the BenchmarkTester
+ */
+int BenchmarkSuiteCalls = 0;
+bool BenchmarkSuiteFails = false;
+
+TEST_SUITE(BenchmarkSuite)
+{
+    int SetUp(const std::string &iName)
+    {
+        logger->log(std::string("SetUp(") + iName + ")");
+        return 0;
+    }
+    void TearDown(const std::string &iName)
+    {
+        logger->log(std::string("TearDown(") + iName + ")");
+    }
+
+    TEST("test") { CHECK_THAT(true); }
+    BENCHMARK("sum")
+    {
+        BenchmarkSuiteCalls++;
+        CHECK_THAT(!BenchmarkSuiteFails);
+    }
+};
+
+/**
+ * Writes a baseline where "sum" of BenchmarkSuite has the given samples
+ */
+const char *BaselineFileName = "esintiler_baseline_test.txt";
+
+void WriteBaseline(double iSeconds)
+{
+    BenchmarkResult result;
+    result.suite = "BenchmarkSuite";
+    result.test = "sum";
+    for(int i = 0; i < 5; i++)
+        result.samples.push_back(iSeconds * (1 + i * 0.01));
+    Baseline baseline;
+    baseline.Record(result);
+    baseline.Save(BaselineFileName);
+}
+
+bool HasMessage(const std::vector<std::string> &iLog, const std::string &iPrefix)
+{
+    for(unsigned int i = 0; i < iLog.size(); i++)
+        if(iLog[i].compare(0, iPrefix.size(), iPrefix) == 0)
+            return true;
+    return false;
+}
+
+std::vector<std::string> Log(const char* ipRef[])
+{
+    std::vector<std::string> log;
+    for(int i = 0; ipRef[i]; i++)
+        log.push_back(ipRef[i]);
+    return log;
+}
+
+TEST_SUITE(BenchmarkTester)
+{
+    int SetUp(const std::string &iName)
+    {
+        TestManager::args()["--benchmark-samples"] = "5";
+        TestManager::args()["--benchmark-time"] = "0.001";
+        BenchmarkSuiteCalls = 0;
+        BenchmarkSuiteFails = false;
+        return 0;
+    }
+    void TearDown(const std::string &iName)
+    {
+        TestManager::args().erase("--benchmark-samples");
+        TestManager::args().erase("--benchmark-time");
+        TestManager::args().erase("--run");
+        TestManager::args().erase("--benchmark-baseline");
+        TestManager::args().erase("--benchmark-save");
+        remove(BaselineFileName);
+        BenchmarkSuiteFails = false;
+    }
+
+    TEST("BenchmarkShouldBeSampledBetweenSetUpAndTearDown")
+    {
+        const char* pRef[] = {
+            "BenchmarkSuite",
+            "SetUp(test)",
+            "test",
+            "...OK",
+            "TearDown(test)",
+            "SetUp(sum)",
+            "sum",
+            "#benchmark",
+            "...OK",
+            "TearDown(sum)",
+            0
+        };
+        BenchmarkLogger benchmarkLogger;
+        CHECK_THAT(TestManager::ExecuteSuite("BenchmarkSuite", &benchmarkLogger) == 0);
+        CHECK_THAT(benchmarkLogger.m_log == Log(pRef));
+
+        ASSERT_THAT(benchmarkLogger.m_results.size() == 1);
+        const BenchmarkResult &result = benchmarkLogger.m_results[0];
+        CHECK_THAT(result.suite == "BenchmarkSuite");
+        CHECK_THAT(result.test == "sum");
+        CHECK_THAT(result.samples.size() == 5);
+        CHECK_THAT(result.iterations >= 1);
+        CHECK_THAT(result.min <= result.median && result.median <= result.p99);
+        //calibration, warm up and the samples
+        CHECK_THAT(BenchmarkSuiteCalls >= 6 * result.iterations);
+    }
+
+    TEST("ProcessRunShouldPassBenchmarkResults")
+    {
+        if(!platform::HasFork)
+        {
+            CHECK_THAT(TestManager::Processes() == 0);
+            return;
+        }
+        TestManager::args()["--processes"] = "1";
+        BenchmarkLogger benchmarkLogger;
+        int retVal = TestManager::ExecuteSuite("BenchmarkSuite", &benchmarkLogger);
+        TestManager::args().erase("--processes");
+
+        CHECK_THAT(retVal == 0);
+        ASSERT_THAT(benchmarkLogger.m_results.size() == 1);
+        CHECK_THAT(benchmarkLogger.m_results[0].test == "sum");
+        CHECK_THAT(benchmarkLogger.m_results[0].samples.size() == 5);
+    }
+
+    TEST("RunOptionShouldSelectTestsOrBenchmarks")
+    {
+        TestManager::args()["--run"] = "tests";
+        BenchmarkLogger testLogger;
+        CHECK_THAT(TestManager::ExecuteSuite("BenchmarkSuite", &testLogger) == 0);
+
+        TestManager::args()["--run"] = "benchmarks";
+        BenchmarkLogger benchmarkLogger;
+        CHECK_THAT(TestManager::ExecuteSuite("BenchmarkSuite", &benchmarkLogger) == 0);
+
+        CHECK_THAT(std::find(testLogger.m_log.begin(), testLogger.m_log.end(), "test") != testLogger.m_log.end());
+        CHECK_THAT(std::find(testLogger.m_log.begin(), testLogger.m_log.end(), "sum") == testLogger.m_log.end());
+        CHECK_THAT(testLogger.m_results.empty());
+        CHECK_THAT(std::find(benchmarkLogger.m_log.begin(), benchmarkLogger.m_log.end(), "test") == benchmarkLogger.m_log.end());
+        CHECK_THAT(benchmarkLogger.m_results.size() == 1);
+    }
+
+    TEST("FailingBenchmarkShouldStopAtFirstFailure")
+    {
+        BenchmarkSuiteFails = true;
+        TestManager::args()["--run"] = "benchmarks";
+        BenchmarkLogger benchmarkLogger;
+        CHECK_THAT(TestManager::ExecuteSuite("BenchmarkSuite", &benchmarkLogger) == 1);
+        CHECK_THAT(BenchmarkSuiteCalls == 1);
+        CHECK_THAT(benchmarkLogger.m_results.empty());
+        CHECK_THAT(!benchmarkLogger.m_log.empty() && benchmarkLogger.m_log.back() == "TearDown(sum)");
+    }
+
+    TEST("BenchmarkShouldCountAsOneAssertion")
+    {
+        TestManager::args()["--run"] = "benchmarks";
+        BenchmarkLogger benchmarkLogger;
+        CHECK_THAT(TestManager::ExecuteSuite("BenchmarkSuite", &benchmarkLogger) == 0);
+        CHECK_THAT(BenchmarkSuiteCalls > 1);
+        CHECK_THAT(benchmarkLogger.m_summary.numAssertions == 1);
+        CHECK_THAT(benchmarkLogger.m_summary.numFailedAssertions == 0);
+
+        BenchmarkSuiteFails = true;
+        BenchmarkLogger failingLogger;
+        CHECK_THAT(TestManager::ExecuteSuite("BenchmarkSuite", &failingLogger) == 1);
+        CHECK_THAT(failingLogger.m_summary.numAssertions == 1);
+        CHECK_THAT(failingLogger.m_summary.numFailedAssertions == 1);
+    }
+
+    TEST("StatisticsShouldBeComputedFromSamples")
+    {
+        BenchmarkResult result;
+        result.samples.push_back(5);
+        result.samples.push_back(1);
+        result.samples.push_back(3);
+        result.samples.push_back(2);
+        result.samples.push_back(4);
+        result.Compute();
+        CHECK_THAT(result.min == 1);
+        CHECK_THAT(result.median == 3);
+        CHECK_THAT(result.p99 == 5);
+        CHECK_THAT(result.mean == 3);
+        CHECK_THAT(result.stddev > 1.5811 && result.stddev < 1.5812);
+        CHECK_THAT(BenchmarkResult::Format(0.0000012) == "1.20 us");
+    }
+
+    TEST("BaselineShouldBeSavedAndLoaded")
+    {
+        WriteBaseline(1.0);
+        TestManager::args()["--run"] = "benchmarks";
+        TestManager::args()["--benchmark-save"] = BaselineFileName;
+        BenchmarkLogger benchmarkLogger;
+        CHECK_THAT(TestManager::ExecuteSuite("BenchmarkSuite", &benchmarkLogger) == 0);
+
+        Baseline baseline;
+        ASSERT_THAT(baseline.Load(BaselineFileName));
+        const std::vector<double> *pSamples = baseline.Samples("BenchmarkSuite", "sum");
+        ASSERT_THAT(pSamples != 0 && pSamples->size() == 5);
+        ASSERT_THAT(benchmarkLogger.m_results.size() == 1);
+        double saved = (*pSamples)[0];
+        double measured = benchmarkLogger.m_results[0].samples[0];
+        CHECK_THAT(saved > measured * 0.999 && saved < measured * 1.001);
+        CHECK_THAT(baseline.Samples("BenchmarkSuite", "test") == 0);
+    }
+
+    TEST("SlowerBenchmarkShouldFail")
+    {
+        WriteBaseline(1e-12);
+        TestManager::args()["--run"] = "benchmarks";
+        TestManager::args()["--benchmark-baseline"] = BaselineFileName;
+        BenchmarkLogger benchmarkLogger;
+        CHECK_THAT(TestManager::ExecuteSuite("BenchmarkSuite", &benchmarkLogger) == 1);
+        CHECK_THAT(HasMessage(benchmarkLogger.m_log, "...Regression: median "));
+        CHECK_THAT(HasMessage(benchmarkLogger.m_log, "...Failed (1 Assertions)"));
+    }
+
+    TEST("FasterBenchmarkShouldPass")
+    {
+        WriteBaseline(1.0);
+        TestManager::args()["--run"] = "benchmarks";
+        TestManager::args()["--benchmark-baseline"] = BaselineFileName;
+        BenchmarkLogger benchmarkLogger;
+        CHECK_THAT(TestManager::ExecuteSuite("BenchmarkSuite", &benchmarkLogger) == 0);
+        CHECK_THAT(!HasMessage(benchmarkLogger.m_log, "...Regression"));
+    }
+
+    TEST("MannWhitneyShouldOnlyDetectSignificantSlowdowns")
+    {
+        const double pBase[] = {1.0, 1.1, 1.2, 1.3, 1.4};
+        const double pSlow[] = {2.0, 2.1, 2.2, 2.3, 2.4};
+        const double pMixed[] = {1.05, 1.15, 1.25, 1.35, 1.45};
+        std::vector<double> base(pBase, pBase + 5);
+        std::vector<double> slow(pSlow, pSlow + 5);
+        std::vector<double> mixed(pMixed, pMixed + 5);
+
+        CHECK_THAT(Baseline::MannWhitney(base, slow) < 0.01);
+        CHECK_THAT(Baseline::MannWhitney(slow, base) > 0.99);
+        CHECK_THAT(Baseline::MannWhitney(base, mixed) > 0.1);
+        CHECK_THAT(Baseline::MannWhitney(base, base) > 0.5);
+        CHECK_THAT(Baseline::MannWhitney(base, std::vector<double>()) == 1);
+    }
+};
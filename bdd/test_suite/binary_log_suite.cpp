@@ -0,0 +1,197 @@
+// binary_log_suite.cpp : Tests for the BinaryLogger
+//
+
+#include "stdio.h"
+#include <map>
+#include <vector>
+
+#include "../include/binary_log.h"
+
+using namespace esintiler;
+
+int& MappedValue(const std::string &val);
+
+/**
+ * Logger which keeps every event as a line of text
+ */
+class EventLogger : public Logger
+{
+public:
+    void log(const char* ipMsg)
+    {
+        m_events.push_back(std::string("L:") + ipMsg);
+    }
+
+    void timing(const char *ipSuite, const char *ipTest, TimingPhase iPhase, double iSeconds)
+    {
+        char pBuf[1024];
+        sprintf_s(pBuf, "P:%s.%s:%i:%.17g", ipSuite, ipTest, (int)iPhase, iSeconds);
+        m_events.push_back(pBuf);
+    }
+
+    void benchmark(const BenchmarkResult &iResult)
+    {
+        char pBuf[1024];
+        sprintf_s(pBuf, "B:%s.%s:%li:%i:%.17g", iResult.suite.c_str(), iResult.test.c_str(),
+            iResult.iterations, (int)iResult.samples.size(), iResult.median);
+        m_events.push_back(pBuf);
+    }
+
+    void failure(const FailureRecord &iFailure)
+    {
+        char pBuf[2048];
+        sprintf_s(pBuf, "F:%s.%s:%s:%i:%s:%s", iFailure.suite, iFailure.test, iFailure.file,
+            iFailure.line, iFailure.statement ? iFailure.statement : "(null)",
+            iFailure.message ? iFailure.message : "(null)");
+        m_events.push_back(pBuf);
+    }
+
+    void result(const TestRecord &iRecord)
+    {
+        char pBuf[2048];
+        sprintf_s(pBuf, "D:%s.%s:%i:%i:%i:%.17g:%s", iRecord.suite, iRecord.test, iRecord.retVal,
+            iRecord.numAssertions, iRecord.numFailedAssertions, iRecord.seconds,
+            iRecord.reason ? iRecord.reason : "(null)");
+        m_events.push_back(pBuf);
+    }
+
+    void summary(const RunSummary &iSummary)
+    {
+        char pBuf[1024];
+        sprintf_s(pBuf, "U:%i:%i:%i:%i:%.17g", iSummary.retVal, iSummary.numTests,
+            iSummary.numAssertions, iSummary.numFailedAssertions, iSummary.seconds);
+        m_events.push_back(pBuf);
+        for(unsigned int i = 0; i < iSummary.slowestTests.size(); i++)
+            m_events.push_back("W:" + iSummary.slowestTests[i].suite + "." + iSummary.slowestTests[i].test);
+        for(unsigned int i = 0; i < iSummary.slowestSuites.size(); i++)
+            m_events.push_back("W:" + iSummary.slowestSuites[i].suite);
+    }
+
+    std::vector<std::string> m_events;
+};
+
+const char *BinaryLogName = "esintiler_binary_test.bin";
+
+long FileSize(const char *ipFile)
+{
+    FILE *pFile = platform::OpenFile(ipFile, "rb");
+    if(!pFile)
+        return -1;
+    fseek(pFile, 0, SEEK_END);
+    long size = ftell(pFile);
+    fclose(pFile);
+    return size;
+}
+
+/**
+ * Logs a few messages to a binary log and crashes
+ */
+int CrashingBinaryLogMain(int iInput, int iOutput, void *ipData)
+{
+    BinaryLogger *pLogger = new BinaryLogger(BinaryLogName);
+    for(int i = 0; i < 100; i++)
+        pLogger->log("message");
+    abort();
+    return 0;
+}
+
+TEST_SUITE(BinaryLogTester)
+{
+    void TearDown(const std::string &iName)
+    {
+        MappedValue("CheckFails") = 0;
+        MappedValue("ObjectFails") = 0;
+        TestManager::args().erase("--benchmark-samples");
+        TestManager::args().erase("--benchmark-time");
+        remove(BinaryLogName);
+    }
+
+    TEST("ReplayShouldPassTheSameEvents")
+    {
+        MappedValue("CheckFails") = 1;
+        MappedValue("ObjectFails") = 1;
+        TestManager::args()["--benchmark-samples"] = "3";
+        TestManager::args()["--benchmark-time"] = "0.001";
+        std::vector<std::string> suites;
+        suites.push_back("SampleSuite");
+        suites.push_back("BenchmarkSuite");
+
+        EventLogger liveLogger;
+        {
+            BinaryLogger binaryLogger(BinaryLogName, &liveLogger);
+            ASSERT_THAT(binaryLogger.IsOpen());
+            CHECK_THAT(TestManager::ExecuteSuites(suites, &binaryLogger) > 0);
+        }
+        EventLogger replayLogger;
+        CHECK_THAT(BinaryLogger::Replay(BinaryLogName, &replayLogger));
+
+        CHECK_THAT(liveLogger.m_events.size() > 40);
+        CHECK_THAT(replayLogger.m_events == liveLogger.m_events);
+    }
+
+    TEST("StringsShouldBeWrittenOnce")
+    {
+        {
+            BinaryLogger binaryLogger(BinaryLogName);
+            for(int i = 0; i < 5000; i++)
+                binaryLogger.timing("Suite", "test", PhaseTest, 0.5);
+        }
+        //header, the strings with their padding and the records
+        CHECK_THAT(FileSize(BinaryLogName) == 8 + 2 * (40 + 8) + 5000 * 40);
+
+        EventLogger replayLogger;
+        CHECK_THAT(BinaryLogger::Replay(BinaryLogName, &replayLogger));
+        CHECK_THAT(replayLogger.m_events.size() == 5000);
+        CHECK_THAT(replayLogger.m_events.back() == "P:Suite.test:5:0.5");
+    }
+
+    TEST("MessagesShouldBeWrittenAfterTheirRecords")
+    {
+        long size = 8;
+        {
+            BinaryLogger binaryLogger(BinaryLogName);
+            for(int i = 0; i < 5000; i++)
+            {
+                char pBuf[64];
+                sprintf_s(pBuf, "...Failed (%i Assertions)", i);
+                binaryLogger.log(pBuf);
+                size += 40 + (long)((strlen(pBuf) + 7) / 8 * 8);
+            }
+        }
+        CHECK_THAT(FileSize(BinaryLogName) == size);
+
+        EventLogger replayLogger;
+        CHECK_THAT(BinaryLogger::Replay(BinaryLogName, &replayLogger));
+        CHECK_THAT(replayLogger.m_events.size() == 5000);
+        CHECK_THAT(replayLogger.m_events.back() == "L:...Failed (4999 Assertions)");
+    }
+
+    TEST("CrashedRunShouldBeReadUntilItsLastRecord")
+    {
+        if(!platform::HasFork)
+        {
+            CHECK_THAT(!platform::HasFork);
+            return;
+        }
+        platform::ChildProcess child;
+        ASSERT_THAT(child.Start(&CrashingBinaryLogMain, 0));
+        char status[64] = "";
+        CHECK_THAT(!child.Wait(status, sizeof(status)));
+
+        EventLogger replayLogger;
+        CHECK_THAT(BinaryLogger::Replay(BinaryLogName, &replayLogger));
+        CHECK_THAT(replayLogger.m_events.size() == 100);
+    }
+
+    TEST("OtherFilesShouldNotBeReplayed")
+    {
+        EventLogger replayLogger;
+        CHECK_THAT(!BinaryLogger::Replay(BinaryLogName, &replayLogger));
+        FILE *pFile = platform::OpenFile(BinaryLogName, "w");
+        ASSERT_THAT(pFile != 0);
+        fputs("SampleSuite\nfooTest1\n...OK\n", pFile);
+        fclose(pFile);
+        CHECK_THAT(!BinaryLogger::Replay(BinaryLogName, &replayLogger));
+        CHECK_THAT(replayLogger.m_events.empty());
+    }
+};
@@ -0,0 +1,150 @@
+// filter_suite.cpp : Tests for the test registry, test filters and listing
+//
+
+#include "test_suite.h"
+
+/**
+ * Fixture suites, they are only executed by the FilterTester
+ */
+int FilterSuiteConstructions = 0;
+
+TEST_SUITE(FilterSuite)
+{
+    FilterSuite()
+    {
+        FilterSuiteConstructions++;
+    }
+
+    TEST("first") { CHECK_THAT(true); }
+    TEST("second") { CHECK_THAT(true); }
+    BENCHMARK("speed") { CHECK_THAT(true); }
+    TEST_CONCURRENT("together", 2, 10) { CHECK_THAT(threadIndex < 2); }
+};
+
+/**
+ * Runs the FilterSuite as its fixture, the filter of the enclosing run should not apply to it
+ */
+TEST_SUITE(NestingFilterSuite)
+{
+    TEST("nested")
+    {
+        MessageLogger logger;
+        CHECK_THAT(TestManager::ExecuteSuite("FilterSuite", &logger) == 0);
+        CHECK_THAT(logger.Has("first"));
+        CHECK_THAT(logger.Has("second"));
+    }
+};
+
+_TEST_SUITE(DisabledFilterSuite)
+{
+    TEST("never") { CHECK_THAT(false); }
+};
+
+TEST_SUITE(FilterTester)
+{
+    void TearDown(const std::string &iName)
+    {
+        TestManager::args().erase("--filter");
+        TestManager::args().erase("--list");
+        TestManager::args().erase("--run");
+    }
+
+    TEST("TestsShouldBeRegisteredWithoutTheSuite")
+    {
+        TestRunnerBase *pRunner = TestManager::FindRunner("FilterSuite");
+        ASSERT_THAT(pRunner != 0);
+        std::vector<TestBase*> tests;
+        for(TestBase *pTest = pRunner->Tests(); pTest; pTest = pTest->next)
+            tests.push_back(pTest);
+        ASSERT_THAT(tests.size() == 4);
+        CHECK_THAT(std::string(tests[0]->name) == "first" && !tests[0]->benchmark);
+        CHECK_THAT(std::string(tests[1]->name) == "second");
+        CHECK_THAT(std::string(tests[2]->name) == "speed" && tests[2]->benchmark);
+        CHECK_THAT(std::string(tests[3]->name) == "together" && !tests[3]->benchmark);
+
+        TestSuiteBase *pSuite = pRunner->CreateSuite();
+        CHECK_THAT(pSuite->Tests == tests);
+        delete pSuite;
+
+        TestRunnerBase *pDisabled = TestManager::FindRunner("DisabledFilterSuite");
+        ASSERT_THAT(pDisabled != 0);
+        CHECK_THAT(!pDisabled->Active());
+        CHECK_THAT(pDisabled->Tests() == 0);
+    }
+
+    TEST("PatternsShouldMatchTheNames")
+    {
+        CHECK_THAT(NameFilter::Glob("Parser*", "Parser.parse"));
+        CHECK_THAT(NameFilter::Glob("*.p?rse", "Parser.parse"));
+        CHECK_THAT(NameFilter::Glob("*", ""));
+        CHECK_THAT(!NameFilter::Glob("Parser", "Parser.parse"));
+        CHECK_THAT(!NameFilter::Glob("*.skip", "Parser.parse"));
+
+        CHECK_THAT(NameFilter::Search("ars", "Parser.parse"));
+        CHECK_THAT(NameFilter::Search("^Parser\\.p[a-z]+e$", "Parser.parse"));
+        CHECK_THAT(NameFilter::Search("^Parser\\.(skip|parse)$", "Parser.parse"));
+        CHECK_THAT(NameFilter::Search("x*", "Parser.parse"));
+        CHECK_THAT(NameFilter::Search("[^a-z]\\.", "Parser.parse") == false);
+        CHECK_THAT(!NameFilter::Search("^parse", "Parser.parse"));
+        CHECK_THAT(!NameFilter::Search("Parser\\.(skip|pars)$", "Parser.parse"));
+
+        CHECK_THAT(NameFilter("Parser*,-*.slow").Matches("Parser.parse"));
+        CHECK_THAT(!NameFilter("Parser*,-*.slow").Matches("Parser.slow"));
+        CHECK_THAT(!NameFilter("Parser*,-*.slow").Matches("Lexer.lex"));
+        CHECK_THAT(NameFilter("-*.slow").Matches("Lexer.lex"));
+        CHECK_THAT(NameFilter("Lexer*,/^Parser\\.p,a/").Matches("Parser.p,arse"));
+        CHECK_THAT(NameFilter("").Matches("Lexer.lex"));
+    }
+
+    TEST("FilterShouldSelectTheTests")
+    {
+        TestManager::args()["--filter"] = "FilterSuite.?irst,/^FilterSuite\\.toge/";
+        MessageLogger logger;
+        CHECK_THAT(TestManager::ExecuteSuites(std::vector<std::string>(), &logger) == 0);
+        CHECK_THAT(logger.Has("FilterSuite"));
+        CHECK_THAT(logger.Has("first"));
+        CHECK_THAT(logger.Has("together"));
+        CHECK_THAT(!logger.Has("second"));
+        CHECK_THAT(!logger.Has("speed"));
+        CHECK_THAT(!logger.Has("FilterTester"));
+
+        int constructions = FilterSuiteConstructions;
+        TestManager::args()["--filter"] = "NoSuchSuite.*";
+        MessageLogger noneLogger;
+        CHECK_THAT(TestManager::ExecuteSuites(std::vector<std::string>(), &noneLogger) == 1);
+        CHECK_THAT(noneLogger.Has("Could not found any suit to execute"));
+        CHECK_THAT(FilterSuiteConstructions == constructions);
+    }
+
+    TEST("FilterShouldNotApplyToNestedRuns")
+    {
+        TestManager::args()["--filter"] = "NestingFilterSuite.*";
+        TestManager::args()["--run"] = "tests";
+        MessageLogger logger;
+        CHECK_THAT(TestManager::ExecuteSuites(std::vector<std::string>(), &logger) == 0);
+        CHECK_THAT(logger.Has("NestingFilterSuite"));
+        CHECK_THAT(logger.Has("nested"));
+        CHECK_THAT(!logger.Has("FilterSuite"));
+    }
+
+    TEST("ListShouldNotConstructTheSuites")
+    {
+        const char *argv[] = { "app", "--filter", "FilterSuite.*,-*.second", "--list" };
+        TestManager::args(4, (char**)argv);
+        CHECK_THAT(TestManager::args()["--list"] == "1");
+
+        int constructions = FilterSuiteConstructions;
+        MessageLogger logger;
+        CHECK_THAT(TestManager::ExecuteAllSuites(&logger) == 0);
+        ASSERT_THAT(logger.m_log.size() == 3);
+        CHECK_THAT(logger.m_log[0] == "FilterSuite.first");
+        CHECK_THAT(logger.m_log[1] == "FilterSuite.speed");
+        CHECK_THAT(logger.m_log[2] == "FilterSuite.together");
+
+        TestManager::args()["--run"] = "benchmarks";
+        MessageLogger benchmarkLogger;
+        CHECK_THAT(TestManager::ExecuteAllSuites(&benchmarkLogger) == 0);
+        CHECK_THAT(benchmarkLogger.m_log == std::vector<std::string>(1, "FilterSuite.speed"));
+        CHECK_THAT(FilterSuiteConstructions == constructions);
+    }
+};
@@ -5,28 +5,17 @@
 #include <map>
 #include <vector>
 
-#include "../include/suite.h"
+#include "../include/async_logger.h"
+#include "test_suite.h"
 
 using namespace esintiler;
 
 int& MappedValue(const std::string &val);
 
 
-class FooLogger : public Logger
-{
-public:
-    void log(const char* ipMsg) 
-    {
-        m_log.push_back(ipMsg);
-        //Logger::log(ipMsg);
-    }
-
-    std::vector<std::string> m_log;
-};
-
 /*
 */
-int checkLog(const char *pTest, const FooLogger &iLogger, const char* ipRef[])
+int checkLog(const char *pTest, const MessageLogger &iLogger, const char* ipRef[])
 {
     unsigned int i = 0;
     for(i = 0; ipRef[i] != 0; i++)
@@ -51,6 +40,54 @@ int checkLog(const char *pTest, const FooLogger &iLogger, const char* ipRef[])
 }
 
 
+/**
+ * Fixture suite with assertions failing in a loop, only executed by the SuiteTester
+ */
+TEST_SUITE(FailingLoopSuite)
+{
+    TEST("loop")
+    {
+        for(int i = 0; i < 1000; i++)
+        {
+            char pMsg[64];
+            sprintf_s(pMsg, "i = %i", i);
+            CHECK_THAT(i < 100);
+            CHECK.True(i < 900, pMsg);
+        }
+    }
+};
+
+int countLog(const MessageLogger &iLogger, const char *ipPrefix)
+{
+    int count = 0;
+    for(unsigned int i = 0; i < iLogger.m_log.size(); i++)
+        count += iLogger.m_log[i].compare(0, strlen(ipPrefix), ipPrefix) == 0;
+    return count;
+}
+
+/**
+ * Logger which keeps the failures as they are passed to it
+ */
+class FailureLogger : public MessageLogger
+{
+public:
+    void failure(const FailureRecord &iFailure)
+    {
+        char pBuf[2048];
+        sprintf_s(pBuf, "%s|%s|%s|%s", iFailure.statement ? iFailure.statement : "(null)", 
+            iFailure.message ? iFailure.message : "(null)", iFailure.suite, iFailure.test);
+        m_failures.push_back(pBuf);
+        m_lines.push_back(iFailure.line);
+        m_sampleFile &= strstr(iFailure.file, "sample_suite.cpp") != 0;
+    }
+
+    FailureLogger() : m_sampleFile(true) {}
+
+    std::vector<std::string>    m_failures;
+    std::vector<int>            m_lines;
+    bool                        m_sampleFile;
+};
+
 //
 //
 //
@@ -72,7 +109,7 @@ TEST_SUITE(SuiteTester)
             "Destruct",
             0
         };
-        FooLogger mlogger;
+        MessageLogger mlogger;
         CHECK_THAT(TestManager::ExecuteSuite("SampleSuite", &mlogger) == 0);
         CHECK_THAT(checkLog("@1", mlogger, pRef) == 0);
     }
@@ -88,7 +125,7 @@ TEST_SUITE(SuiteTester)
             "...Failed (No Assertions)",
             0
         };
-        FooLogger mlogger;
+        MessageLogger mlogger;
         CHECK_THAT(TestManager::ExecuteSuite("SampleSuite", &mlogger) > 0);
         CHECK_THAT(checkLog("@2", mlogger, pRef) == 0);
         MappedValue("Construct") = 0;
@@ -108,7 +145,7 @@ TEST_SUITE(SuiteTester)
             "Destruct",
             0
         };
-        FooLogger mlogger;
+        MessageLogger mlogger;
         CHECK_THAT(TestManager::ExecuteSuite("SampleSuite", &mlogger) > 0);
         CHECK_THAT(checkLog("@3", mlogger, pRef) == 0);
         MappedValue("fooTest1") = 0;
@@ -137,7 +174,7 @@ TEST_SUITE(SuiteTester)
             "Destruct",
             0
         };
-        FooLogger mlogger;
+        MessageLogger mlogger;
         CHECK_THAT(TestManager::ExecuteSuite("SampleSuite", &mlogger) > 0);
         CHECK_THAT(checkLog("@4", mlogger, pRef) == 0);
         MappedValue("CheckFails") = 0;
@@ -163,12 +200,83 @@ TEST_SUITE(SuiteTester)
             "Destruct",
             0
         };
-        FooLogger mlogger;
+        MessageLogger mlogger;
         CHECK_THAT(TestManager::ExecuteSuite("SampleSuite", &mlogger) > 0);
         CHECK_THAT(checkLog("@4", mlogger, pRef) == 0);
         MappedValue("AssertFails") = 0;
     }
 
+    TEST("FailuresShouldBePassedAsRecords")
+    {
+        const char* pRef[] = {
+            "!MappedValue(\"CheckFails\")|(null)|SampleSuite|fooTest1",
+            "!MappedValue(\"CheckFails\")|(null)|SampleSuite|fooTest1",
+            "(null)|object fails|SampleSuite|fooTest2",
+        };
+        std::vector<std::string> ref(pRef, pRef + 3);
+        MappedValue("CheckFails") = 1;
+        MappedValue("ObjectFails") = 1;
+        FailureLogger mlogger;
+        CHECK_THAT(TestManager::ExecuteSuite("SampleSuite", &mlogger) > 0);
+
+        TestManager::args()["--jobs"] = "2";
+        FailureLogger parallelLogger;
+        TestManager::ExecuteSuite("SampleSuite", &parallelLogger);
+        TestManager::args().erase("--jobs");
+
+        FailureLogger processLogger;
+        if(platform::HasFork)
+        {
+            TestManager::args()["--processes"] = "1";
+            TestManager::ExecuteSuite("SampleSuite", &processLogger);
+            TestManager::args().erase("--processes");
+        }
+        MappedValue("CheckFails") = 0;
+        MappedValue("ObjectFails") = 0;
+
+        CHECK_THAT(mlogger.m_failures == ref);
+        CHECK_THAT(mlogger.m_sampleFile);
+        ASSERT_THAT(mlogger.m_lines.size() == 3);
+        CHECK_THAT(mlogger.m_lines[0] != mlogger.m_lines[1]);
+        CHECK_THAT(parallelLogger.m_failures == ref);
+        CHECK_THAT(parallelLogger.m_lines == mlogger.m_lines);
+        if(platform::HasFork)
+        {
+            CHECK_THAT(processLogger.m_failures == ref);
+            CHECK_THAT(processLogger.m_lines == mlogger.m_lines);
+            CHECK_THAT(processLogger.m_sampleFile);
+        }
+    }
+
+    TEST("RepeatedFailuresShouldBeSuppressed")
+    {
+        const char* pRef[] = {
+            "#suppressed: 890 further failures of i < 100 (",
+            "#suppressed: 90 further failures of CHECK/ASSERT (",
+            "#suppressed: first msg: i = 910, last msg: i = 999",
+            "...Failed (1000 Assertions)",
+            0
+        };
+        MessageLogger mlogger;
+        CHECK_THAT(TestManager::ExecuteSuite("FailingLoopSuite", &mlogger) == 1);
+        CHECK_THAT(countLog(mlogger, "#statement: i < 100") == 10);
+        CHECK_THAT(countLog(mlogger, "#msg     : i = ") == 10);
+        ASSERT_THAT(mlogger.m_log.size() > 4);
+        std::vector<std::string> tail(mlogger.m_log.end() - 4, mlogger.m_log.end());
+        for(int i = 0; pRef[i]; i++)
+            CHECK_THAT(tail[i].compare(0, strlen(pRef[i]), pRef[i]) == 0);
+        CHECK_THAT(tail[0].find(", first in assertion 221, last in assertion 1999") != std::string::npos);
+        CHECK_THAT(tail[1].find(", first in assertion 1822, last in assertion 2000") != std::string::npos);
+
+        TestManager::args()["--failure-limit"] = "0";
+        MessageLogger allLogger;
+        TestManager::ExecuteSuite("FailingLoopSuite", &allLogger);
+        TestManager::args().erase("--failure-limit");
+        CHECK_THAT(countLog(allLogger, "#statement: i < 100") == 900);
+        CHECK_THAT(countLog(allLogger, "#msg     : i = ") == 100);
+        CHECK_THAT(countLog(allLogger, "#suppressed") == 0);
+    }
+
     TEST("CHECK and ASSERT Objects")
     {
         CHECK.True(true);
@@ -179,7 +287,19 @@ TEST_SUITE(SuiteTester)
 
 int main(int argc, char* argv[])
 {
-    int retVal = TestManager::ExecuteSuite("SuiteTester");
+    std::vector<std::string> suites;
+    suites.push_back("SuiteTester");
+    suites.push_back("ParallelTester");
+    suites.push_back("TimingTester");
+    suites.push_back("TimeoutTester");
+    suites.push_back("BenchmarkTester");
+    suites.push_back("AsyncLoggerTester");
+    suites.push_back("ReportTester");
+    suites.push_back("BinaryLogTester");
+    suites.push_back("FilterTester");
+    AsyncLogger logger;
+    int retVal = TestManager::ExecuteSuites(suites, &logger);
+    logger.Flush();
     printf("%i\n", retVal);
 }
 
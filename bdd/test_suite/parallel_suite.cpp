@@ -0,0 +1,675 @@
+// parallel_suite.cpp : Tests for the parallel execution of the suites
+//
+
+#include "test_suite.h"
+
+/**
+ * Sets a runner argument for the life time of the object
+ */
+struct ScopedArgument
+{
+    ScopedArgument(const char *iName, const char *iValue) : name(iName)
+    {
+        TestManager::args()[name] = iValue;
+    }
+    ~ScopedArgument()
+    {
+        TestManager::args().erase(name);
+    }
+    std::string name;
+};
+
+/**
+ * Fixture suites, they are only executed by the ParallelTester
+ */
+TEST_SUITE(ParallelSuiteA)
+{
+    int Construct()
+    {
+        logger->log("Construct A");
+        return 0;
+    }
+    TEST("a1") { CHECK_THAT(true); }
+    TEST("a2") { CHECK_THAT(true); CHECK_THAT(true); }
+};
+
+TEST_SUITE(ParallelSuiteB)
+{
+    TEST("b1") { CHECK_THAT(1 == 2); }
+    TEST("b2") { CHECK_THAT(true); }
+};
+
+TEST_SUITE(ParallelSuiteC)
+{
+    int SetUp(const std::string &iName)
+    {
+        logger->log(std::string("SetUp(") + iName + ")");
+        return 0;
+    }
+    TEST("c1") { CHECK_THAT(true); }
+    TEST("c2") { }
+};
+
+TEST_SUITE(ParallelSuiteD)
+{
+    TEST("d1") { CHECK_THAT(true); }
+};
+
+/**
+ * Suite which splits its tests to several workers, number of workers is controlled 
+ * by the tester
+ */
+int SplitSuiteWorkers = 1;
+
+TEST_SUITE(SplitSuite)
+{
+    int Workers()
+    {
+        return SplitSuiteWorkers;
+    }
+    int Construct()
+    {
+        logger->log("Construct");
+        return 0;
+    }
+    void Destruct()
+    {
+        logger->log("Destruct");
+    }
+
+    TEST("s1") { CHECK_THAT(true); }
+    TEST("s2") { CHECK_THAT(true); CHECK_THAT(false); }
+    TEST("s3") { CHECK_THAT(true); }
+    TEST("s4") { }
+    TEST("s5") { CHECK_THAT(true); }
+    TEST("s6") { CHECK_THAT(true); }
+    TEST("s7") { ASSERT_THAT(false); CHECK_THAT(true); }
+    TEST("s8") { CHECK_THAT(true); }
+};
+
+/**
+ * Log without the Construct/Destruct messages which are repeated for each worker
+ */
+std::vector<std::string> TestMessages(const std::vector<std::string> &iLog)
+{
+    std::vector<std::string> messages;
+    for(unsigned int i = 0; i < iLog.size(); i++)
+        if(iLog[i] != "Construct" && iLog[i] != "Destruct")
+            messages.push_back(iLog[i]);
+    return messages;
+}
+
+int CountMessages(const std::vector<std::string> &iLog, const char *ipMsg)
+{
+    int count = 0;
+    for(unsigned int i = 0; i < iLog.size(); i++)
+        count += iLog[i] == ipMsg;
+    return count;
+}
+
+/**
+ * Suite with a crashing test, crash is only enabled while the tester executes it in 
+ * worker processes
+ */
+bool CrashSuiteEnabled = false;
+
+TEST_SUITE(CrashSuite)
+{
+    TEST("beforeCrash") { CHECK_THAT(true); }
+    TEST("crash") 
+    {
+        CHECK_THAT(true);
+        if(CrashSuiteEnabled)
+            abort();
+    }
+    TEST("afterCrash") { CHECK_THAT(true); }
+};
+
+/**
+ * Suite whose tests modify the suite object, they only pass if each test sees the 
+ * constructed state
+ */
+int ForkSuiteTestsPerFork = 0;
+
+TEST_SUITE(ForkSuite)
+{
+    int TestsPerFork()
+    {
+        return ForkSuiteTestsPerFork;
+    }
+    int Construct()
+    {
+        logger->log("Construct");
+        counter = 0;
+        return 0;
+    }
+
+    int counter;
+
+    TEST("f1") { counter++; CHECK_THAT(counter == 1); }
+    TEST("f2") { counter++; CHECK_THAT(counter == 1); }
+    TEST("f3") 
+    { 
+        counter++; 
+        CHECK_THAT(counter == 1); 
+        if(CrashSuiteEnabled)
+            abort();
+    }
+    TEST("f4") { counter++; CHECK_THAT(counter == 1); }
+};
+
+/**
+ * Suite whose test checks from several threads at the same time, second thread has
+ * two failing checks
+ */
+TEST_SUITE(ThreadedSuite)
+{
+    struct CheckingThread : public platform::Thread
+    {
+        void Run() { suite->Checks(id); }
+        ThreadedSuite  *suite;
+        int             id;
+    };
+
+    void Checks(int iId)
+    {
+        for(int i = 0; i < 10000; i++)
+            CHECK_THAT(i >= 0);
+        if(iId == 1)
+        {
+            CHECK_THAT(iId == 0);
+            CHECK.True(iId == 0, "checked on a thread");
+        }
+    }
+
+    TEST("threads")
+    {
+        CheckingThread threads[4];
+        for(int i = 0; i < 4; i++)
+        {
+            threads[i].suite = this;
+            threads[i].id = i;
+            threads[i].Start();
+        }
+        for(int i = 0; i < 4; i++)
+            threads[i].Join();
+        CHECK_THAT(true);
+    }
+};
+
+/**
+ * Suite whose test has an assertion failing in a loop on a thread
+ */
+TEST_SUITE(FailingThreadSuite)
+{
+    struct FailingThread : public platform::Thread
+    {
+        void Run() { suite->Loop(); }
+        FailingThreadSuite *suite;
+    };
+
+    void Loop()
+    {
+        for(int i = 0; i < 1000; i++)
+        {
+            char pMsg[64];
+            sprintf_s(pMsg, "i = %i", i);
+            CHECK.True(i < 100, pMsg);
+        }
+    }
+
+    TEST("loop")
+    {
+        FailingThread thread;
+        thread.suite = this;
+        thread.Start();
+        thread.Join();
+    }
+};
+
+/**
+ * Suite with concurrent tests, in the second one thread 2 stops at its fifth iteration
+ */
+volatile long ConcurrentSuiteCalls = 0;
+
+TEST_SUITE(ConcurrentSuite)
+{
+    TEST_CONCURRENT("count", 4, 10000)
+    {
+        platform::AtomicAdd(&ConcurrentSuiteCalls, 1);
+        CHECK_THAT(threadIndex >= 0 && threadIndex < 4);
+    }
+
+    TEST_CONCURRENT("stop", 3, 100)
+    {
+        platform::AtomicAdd(&ConcurrentSuiteCalls, 1);
+        ASSERT.True(threadIndex != 2 || iteration < 5, "thread 2 stops");
+    }
+};
+
+/**
+ * Keeps the failures and the summary of a run
+ */
+class ThreadedLogger : public MessageLogger
+{
+public:
+    void failure(const FailureRecord &iFailure)
+    {
+        m_failures.push_back(std::string(iFailure.suite) + "." + iFailure.test + ":" + 
+            (iFailure.statement ? iFailure.statement : iFailure.message));
+    }
+
+    void summary(const RunSummary &iSummary)
+    {
+        m_summary = iSummary;
+    }
+
+    std::vector<std::string>    m_failures;
+    RunSummary                  m_summary;
+};
+
+int FindMessage(const std::vector<std::string> &iLog, const std::string &iMsg)
+{
+    for(unsigned int i = 0; i < iLog.size(); i++)
+        if(iLog[i].compare(0, iMsg.size(), iMsg) == 0)
+            return i;
+    return -1;
+}
+
+/**
+ * Writes a history file where a1 takes much longer than all the other registered tests
+ * together, so the shard of a1 gets no other test
+ */
+const char *HistoryFileName = "esintiler_history_test.txt";
+
+void WriteHistory()
+{
+    History history;
+    history.Enable(true);
+    for(unsigned int i = 0; i < TestManager::TestRunners().size(); i++)
+    {
+        TestSuiteBase *pSuite = TestManager::TestRunners()[i].second->CreateSuite();
+        for(unsigned int j = 0; j < pSuite->Tests.size(); j++)
+            history.Record(pSuite->name, pSuite->Tests[j]->name, 
+                std::string(pSuite->Tests[j]->name) == "a1" ? 10.0 : 0.01);
+        delete pSuite;
+    }
+    history.Save(HistoryFileName);
+}
+
+std::vector<std::string> ParallelSuites()
+{
+    std::vector<std::string> names;
+    names.push_back("ParallelSuiteA");
+    names.push_back("ParallelSuiteB");
+    names.push_back("ParallelSuiteC");
+    names.push_back("ParallelSuiteD");
+    return names;
+}
+
+/**
+ * Counts how many times each task is executed
+ */
+struct CountingPool : public WorkerPool
+{
+    CountingPool(int iNumTasks) : counts(iNumTasks, 0) {}
+    void Execute(int iTask, int iWorker)
+    {
+        counts[iTask]++;
+    }
+    std::vector<int> counts;
+};
+
+TEST_SUITE(ParallelTester)
+{
+    TEST("PoolShouldExecuteEachTaskOnce")
+    {
+        std::vector<int> tasks;
+        for(int i = 0; i < 1000; i++)
+            tasks.push_back(i);
+
+        CountingPool pool(1000);
+        pool.Start(tasks, 7);
+        pool.Join();
+
+        int numWrong = 0;
+        for(int i = 0; i < 1000; i++)
+            numWrong += pool.counts[i] != 1;
+        CHECK_THAT(numWrong == 0);
+    }
+
+    TEST("ParallelRunShouldMatchSerialRun")
+    {
+        MessageLogger serialLogger;
+        int serialRetVal = TestManager::ExecuteSuites(ParallelSuites(), &serialLogger);
+
+        ScopedArgument jobs("--jobs", "3");
+        MessageLogger parallelLogger;
+        int parallelRetVal = TestManager::ExecuteSuites(ParallelSuites(), &parallelLogger);
+
+        CHECK_THAT(serialRetVal == 2);
+        CHECK_THAT(parallelRetVal == serialRetVal);
+        CHECK_THAT(parallelLogger.m_log == serialLogger.m_log);
+    }
+
+    TEST("SuiteTestsShouldBeSplitToWorkers")
+    {
+        SplitSuiteWorkers = 1;
+        MessageLogger serialLogger;
+        int serialRetVal = TestManager::ExecuteSuite("SplitSuite", &serialLogger);
+
+        SplitSuiteWorkers = 3;
+        MessageLogger splitLogger;
+        int splitRetVal = TestManager::ExecuteSuite("SplitSuite", &splitLogger);
+        SplitSuiteWorkers = 1;
+
+        CHECK_THAT(serialRetVal == 3);
+        CHECK_THAT(splitRetVal == serialRetVal);
+        CHECK_THAT(CountMessages(serialLogger.m_log, "Construct") == 1);
+        CHECK_THAT(CountMessages(splitLogger.m_log, "Construct") == 3);
+        CHECK_THAT(CountMessages(splitLogger.m_log, "Destruct") == 3);
+        CHECK_THAT(TestMessages(splitLogger.m_log) == TestMessages(serialLogger.m_log));
+    }
+
+    TEST("ProcessRunShouldMatchSerialRun")
+    {
+        MessageLogger serialLogger;
+        int serialRetVal = TestManager::ExecuteSuites(ParallelSuites(), &serialLogger);
+
+        ScopedArgument processes("--processes", "3");
+        MessageLogger processLogger;
+        int processRetVal = TestManager::ExecuteSuites(ParallelSuites(), &processLogger);
+
+        CHECK_THAT(processRetVal == serialRetVal);
+        CHECK_THAT(processLogger.m_log == serialLogger.m_log);
+    }
+
+    TEST("CrashingTestShouldNotStopTheRun")
+    {
+        if(!platform::HasFork)
+        {
+            CHECK_THAT(TestManager::Processes() == 0);
+            return;
+        }
+
+        std::vector<std::string> suites = ParallelSuites();
+        suites.push_back("CrashSuite");
+
+        ScopedArgument processes("--processes", "2");
+        CrashSuiteEnabled = true;
+        MessageLogger crashLogger;
+        int retVal = TestManager::ExecuteSuites(suites, &crashLogger);
+        CrashSuiteEnabled = false;
+
+        int crash = FindMessage(crashLogger.m_log, "crash");
+        CHECK_THAT(retVal == 2 + 1);
+        CHECK_THAT(crash > 0);
+        CHECK_THAT(FindMessage(crashLogger.m_log, "...Failed (Crashed") == crash + 1);
+        CHECK_THAT(FindMessage(crashLogger.m_log, "afterCrash") == crash + 2);
+        CHECK_THAT(crashLogger.m_log.back() == "...OK");
+    }
+
+    TEST("EachForkShouldSeeTheConstructedSuite")
+    {
+        if(!platform::HasFork)
+        {
+            CHECK_THAT(true);
+            return;
+        }
+
+        ForkSuiteTestsPerFork = 1;
+        MessageLogger forkLogger;
+        int forkRetVal = TestManager::ExecuteSuite("ForkSuite", &forkLogger);
+        ForkSuiteTestsPerFork = 0;
+
+        MessageLogger sharedLogger;
+        int sharedRetVal = TestManager::ExecuteSuite("ForkSuite", &sharedLogger);
+
+        CHECK_THAT(forkRetVal == 0);
+        CHECK_THAT(sharedRetVal == 3);
+        CHECK_THAT(CountMessages(forkLogger.m_log, "Construct") == 1);
+        CHECK_THAT(CountMessages(forkLogger.m_log, "...OK") == 4);
+    }
+
+    TEST("CrashingForkShouldContinueWithNextTest")
+    {
+        if(!platform::HasFork)
+        {
+            CHECK_THAT(true);
+            return;
+        }
+
+        ForkSuiteTestsPerFork = 2;
+        CrashSuiteEnabled = true;
+        MessageLogger forkLogger;
+        int retVal = TestManager::ExecuteSuite("ForkSuite", &forkLogger);
+        CrashSuiteEnabled = false;
+        ForkSuiteTestsPerFork = 0;
+
+        //f2 shares the copy of f1 so it fails, f3 crashes
+        int crash = FindMessage(forkLogger.m_log, "f3");
+        CHECK_THAT(retVal == 2);
+        CHECK_THAT(FindMessage(forkLogger.m_log, "...Failed (Crashed") == crash + 1);
+        CHECK_THAT(FindMessage(forkLogger.m_log, "f4") == crash + 2);
+        CHECK_THAT(forkLogger.m_log.back() == "...OK");
+    }
+
+    TEST("ShardsShouldExecuteEachTestOnce")
+    {
+        const char *pTests[] = {"a1", "a2", "b1", "b2", "c1", "c2", "d1", 0};
+        std::map<std::string, int> executed;
+        for(int shard = 0; shard < 3; shard++)
+        {
+            char pIndex[16];
+            sprintf_s(pIndex, "%i", shard);
+            ScopedArgument shardIndex("--shard-index", pIndex);
+            ScopedArgument shardCount("--shard-count", "3");
+
+            MessageLogger shardLogger;
+            TestManager::ExecuteSuites(ParallelSuites(), &shardLogger);
+            for(unsigned int i = 0; i < shardLogger.m_log.size(); i++)
+                executed[shardLogger.m_log[i]] ++;
+        }
+
+        int numWrong = 0;
+        for(int i = 0; pTests[i]; i++)
+            numWrong += executed[pTests[i]] != 1;
+        CHECK_THAT(numWrong == 0);
+    }
+
+    TEST("HistoryShouldBeSavedAndLoaded")
+    {
+        History history;
+        history.Record("Suite", "test", 1.0);
+        CHECK_THAT(history.Empty());
+
+        history.Enable(true);
+        history.Record("Suite", "test", 1.0);
+        history.Record("Suite", "test", 3.0);
+        history.Record("Suite", 0, 5.0);
+        CHECK_THAT(history.Save(HistoryFileName));
+
+        History loaded;
+        CHECK_THAT(loaded.Load(HistoryFileName));
+        CHECK_THAT(loaded.Predict("Suite", "test") == 2.0);
+        CHECK_THAT(loaded.Predict("Suite", 0) == 5.0);
+        CHECK_THAT(loaded.Predict("Unknown", "test") == 2.0);
+
+        //averages of the unknown entries follow the new measurements
+        loaded.Enable(true);
+        loaded.Record("Suite", "other", 4.0);
+        loaded.Record("Suite", "test", 4.0);
+        CHECK_THAT(loaded.Predict("Unknown", "test") == 3.5);
+        CHECK_THAT(loaded.Predict("Unknown", 0) == 5.0);
+        remove(HistoryFileName);
+    }
+
+    TEST("ShardsShouldBeBalancedByHistory")
+    {
+        WriteHistory();
+        History written;
+        written.Load(HistoryFileName);
+        std::vector<std::vector<std::string> > shards;
+        for(int shard = 0; shard < 3; shard++)
+        {
+            char pIndex[16];
+            sprintf_s(pIndex, "%i", shard);
+            ScopedArgument shardIndex("--shard-index", pIndex);
+            ScopedArgument shardCount("--shard-count", "3");
+            ScopedArgument historyFile("--history", HistoryFileName);
+
+            MessageLogger shardLogger;
+            TestManager::ExecuteSuites(ParallelSuites(), &shardLogger);
+            shards.push_back(shardLogger.m_log);
+        }
+
+        //shards do not change the history they read, each one saves its measurements
+        History history;
+        CHECK_THAT(history.Load(HistoryFileName));
+        CHECK_THAT(history.Fingerprint() == written.Fingerprint());
+        for(int shard = 0; shard < 3; shard++)
+        {
+            std::string shardFile = TestManager::ShardHistoryFile(HistoryFileName, shard);
+            History measured;
+            CHECK_THAT(measured.Load(shardFile.c_str()));
+            CHECK_THAT(!measured.Empty() && measured.Size() < written.Size());
+            CHECK_THAT(history.Merge(shardFile.c_str()));
+            remove(shardFile.c_str());
+        }
+        CHECK_THAT(history.Size() >= written.Size());
+        CHECK_THAT(history.Predict("ParallelSuiteA", "a1") < 10.0);
+        remove(HistoryFileName);
+
+        //a1 is alone in its shard
+        int numWrong = 0;
+        const char *pTests[] = {"a1", "a2", "b1", "b2", "c1", "c2", "d1", 0};
+        for(int i = 0; pTests[i]; i++)
+        {
+            int count = 0;
+            for(int shard = 0; shard < 3; shard++)
+                count += CountMessages(shards[shard], pTests[i]);
+            numWrong += count != 1;
+        }
+        CHECK_THAT(numWrong == 0);
+        CHECK_THAT(CountMessages(shards[0], "a1") == 1);
+        CHECK_THAT(CountMessages(shards[0], "...OK") == 1);
+    }
+
+    TEST("ShardsShouldLogTheFingerprintOfTheirHistory")
+    {
+        const char *pOtherFile = "esintiler_history_other.txt";
+        WriteHistory();
+        History other;
+        other.Load(HistoryFileName);
+        other.Enable(true);
+        other.Record("ParallelSuiteD", "d1", 20.0);
+        other.Save(pOtherFile);
+
+        const char *pFiles[] = { HistoryFileName, HistoryFileName, pOtherFile };
+        const char *pIndexes[] = { "0", "1", "1" };
+        std::vector<std::string> fingerprints;
+        for(int i = 0; i < 3; i++)
+        {
+            ScopedArgument shardIndex("--shard-index", pIndexes[i]);
+            ScopedArgument shardCount("--shard-count", "2");
+            ScopedArgument historyFile("--history", pFiles[i]);
+            MessageLogger shardLogger;
+            TestManager::ExecuteSuites(ParallelSuites(), &shardLogger);
+            int line = FindMessage(shardLogger.m_log, "#history  : fingerprint ");
+            fingerprints.push_back(line >= 0 ? shardLogger.m_log[line] : "");
+            remove(TestManager::ShardHistoryFile(pFiles[i], atoi(pIndexes[i])).c_str());
+        }
+        remove(HistoryFileName);
+        remove(pOtherFile);
+
+        CHECK_THAT(!fingerprints[0].empty());
+        CHECK_THAT(fingerprints[0] == fingerprints[1]);
+        CHECK_THAT(!fingerprints[2].empty() && fingerprints[2] != fingerprints[0]);
+    }
+
+    TEST("HistoryShouldBeUpdatedByTheRun")
+    {
+        remove(HistoryFileName);
+        {
+            ScopedArgument historyFile("--history", HistoryFileName);
+            ScopedArgument jobs("--jobs", "2");
+            MessageLogger historyLogger;
+            TestManager::ExecuteSuites(ParallelSuites(), &historyLogger);
+        }
+
+        History history;
+        CHECK_THAT(history.Load(HistoryFileName));
+        CHECK_THAT(!history.Empty());
+        CHECK_THAT(history.Predict("ParallelSuiteD", "d1") >= 0);
+        remove(HistoryFileName);
+    }
+
+    TEST("InvalidShardShouldFail")
+    {
+        ScopedArgument shardIndex("--shard-index", "3");
+        ScopedArgument shardCount("--shard-count", "3");
+        MessageLogger shardLogger;
+        CHECK_THAT(TestManager::ExecuteSuites(ParallelSuites(), &shardLogger) == 1);
+        CHECK_THAT(shardLogger.m_log.size() == 1);
+    }
+
+    TEST("ChecksShouldBeCountedOnEveryThread")
+    {
+        ThreadedLogger logger;
+        CHECK_THAT(TestManager::ExecuteSuite("ThreadedSuite", &logger) == 1);
+        CHECK_THAT(logger.m_summary.numAssertions == 4 * 10000 + 2 + 1);
+        CHECK_THAT(logger.m_summary.numFailedAssertions == 2);
+        CHECK_THAT(FindMessage(logger.m_log, "...Failed (2 Assertions)") >= 0);
+        std::sort(logger.m_failures.begin(), logger.m_failures.end());
+        ASSERT_THAT(logger.m_failures.size() == 2);
+        CHECK_THAT(logger.m_failures[0] == "ThreadedSuite.threads:checked on a thread");
+        CHECK_THAT(logger.m_failures[1] == "ThreadedSuite.threads:iId == 0");
+    }
+
+    TEST("RepeatedFailuresOnThreadsShouldBeSuppressed")
+    {
+        ThreadedLogger logger;
+        CHECK_THAT(TestManager::ExecuteSuite("FailingThreadSuite", &logger) == 1);
+        CHECK_THAT(logger.m_summary.numAssertions == 1000);
+        CHECK_THAT(logger.m_summary.numFailedAssertions == 900);
+        CHECK_THAT(logger.m_failures.size() == 10);
+        int suppressed = FindMessage(logger.m_log, "#suppressed: 890 further failures of CHECK/ASSERT (");
+        ASSERT_THAT(suppressed >= 0);
+        CHECK_THAT(logger.m_log[suppressed + 1] == "#suppressed: first msg: i = 110, last msg: i = 999");
+        CHECK_THAT(FindMessage(logger.m_log, "...Failed (900 Assertions)") >= 0);
+    }
+
+    TEST("ConcurrentTestsShouldRunOnEachThread")
+    {
+        ConcurrentSuiteCalls = 0;
+        ThreadedLogger logger;
+        CHECK_THAT(TestManager::ExecuteSuite("ConcurrentSuite", &logger) == 1);
+        CHECK_THAT(ConcurrentSuiteCalls == 4 * 10000 + 2 * 100 + 6);
+        CHECK_THAT(logger.m_summary.numAssertions == 4 * 10000 + 2 * 100 + 6);
+        CHECK_THAT(logger.m_summary.numFailedAssertions == 1);
+        ASSERT_THAT(logger.m_failures.size() == 1);
+        CHECK_THAT(logger.m_failures[0] == "ConcurrentSuite.stop:thread 2 stops");
+
+        int count = FindMessage(logger.m_log, "...Concurrent (4 threads x 10000 iterations): wall ");
+        ASSERT_THAT(count >= 0);
+        for(int i = 0; i < 4; i++)
+        {
+            char pBuf[64];
+            sprintf_s(pBuf, "...Thread %i: ", i);
+            CHECK_THAT(logger.m_log[count + 1 + i].compare(0, strlen(pBuf), pBuf) == 0);
+        }
+        CHECK_THAT(FindMessage(logger.m_log, "...Concurrent (3 threads x 100 iterations): wall ") > count);
+    }
+
+    TEST("SuitesShouldBeConstructedOnSeveralThreads")
+    {
+        ScopedArgument jobs("--jobs", "4");
+        int retVal = 0;
+        for(int i = 0; i < 20; i++)
+        {
+            MessageLogger logger;
+            retVal += TestManager::ExecuteSuites(ParallelSuites(), &logger);
+        }
+        CHECK_THAT(retVal == 20 * 2);
+    }
+};
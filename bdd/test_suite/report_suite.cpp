@@ -0,0 +1,166 @@
+// report_suite.cpp : Tests for the JUnit XML and JSON Lines reporters
+//
+
+#include "stdio.h"
+#include <map>
+#include <vector>
+
+#include "../include/suite.h"
+
+using namespace esintiler;
+
+int& MappedValue(const std::string &val);
+
+/**
+ * Logger which ignores everything, reporters are tested through their files
+ */
+class SilentLogger : public Logger
+{
+public:
+    void log(const char* ipMsg)
+    {
+    }
+
+    void summary(const RunSummary &iSummary)
+    {
+    }
+};
+
+const char *ReportFileName = "esintiler_report_test.txt";
+
+std::string ReadReport(const char *ipFile)
+{
+    std::string text;
+    FILE *pFile = platform::OpenFile(ipFile, "rb");
+    if(!pFile)
+        return text;
+    char pBuf[4096];
+    size_t numRead = 0;
+    while((numRead = fread(pBuf, 1, sizeof(pBuf), pFile)) > 0)
+        text.append(pBuf, numRead);
+    fclose(pFile);
+    return text;
+}
+
+/**
+ * Lines of the report which contain the given text
+ */
+std::vector<std::string> ReportLines(const std::string &iText, const char *ipPart)
+{
+    std::vector<std::string> lines;
+    size_t start = 0;
+    while(start < iText.size())
+    {
+        size_t end = iText.find('\n', start);
+        if(end == std::string::npos)
+            end = iText.size();
+        std::string line = iText.substr(start, end - start);
+        if(line.find(ipPart) != std::string::npos)
+            lines.push_back(line);
+        start = end + 1;
+    }
+    return lines;
+}
+
+bool Contains(const std::string &iText, const char *ipPart)
+{
+    return iText.find(ipPart) != std::string::npos;
+}
+
+TEST_SUITE(ReportTester)
+{
+    int SetUp(const std::string &iName)
+    {
+        MappedValue("CheckFails") = 1;
+        return 0;
+    }
+
+    void TearDown(const std::string &iName)
+    {
+        MappedValue("CheckFails") = 0;
+        TestManager::args().erase("--jsonl");
+        TestManager::args().erase("--junit");
+        TestManager::args().erase("--processes");
+        TestManager::args().erase("--timeout");
+        TestManager::args().erase("--shard-index");
+        TestManager::args().erase("--shard-count");
+        remove(ReportFileName);
+    }
+
+    TEST("JsonLinesShouldHaveALinePerTest")
+    {
+        SilentLogger silentLogger;
+        {
+            JsonLinesReporter reporter(ReportFileName, &silentLogger);
+            ASSERT_THAT(reporter.IsOpen());
+            CHECK_THAT(TestManager::ExecuteSuite("SampleSuite", &reporter) > 0);
+        }
+        std::string text = ReadReport(ReportFileName);
+
+        std::vector<std::string> tests = ReportLines(text, "{\"type\":\"test\"");
+        ASSERT_THAT(tests.size() == 2);
+        CHECK_THAT(Contains(tests[0], "\"suite\":\"SampleSuite\",\"test\":\"fooTest1\",\"retVal\":1,"
+            "\"numAssertions\":3,\"numFailedAssertions\":2,"));
+        CHECK_THAT(Contains(tests[0], "\"statement\":\"!MappedValue(\\\"CheckFails\\\")\""));
+        CHECK_THAT(Contains(tests[0], "sample_suite.cpp\",\"line\":"));
+        CHECK_THAT(ReportLines(tests[0], "\"file\":").size() == 1);
+        CHECK_THAT(Contains(tests[1], "\"test\":\"fooTest2\",\"retVal\":0,"));
+        CHECK_THAT(Contains(tests[1], "\"failures\":[]}"));
+        CHECK_THAT(ReportLines(text, "{\"type\":\"suite\",\"shard\":0,\"suite\":\"SampleSuite\"").size() == 1);
+        CHECK_THAT(ReportLines(text, "{\"type\":\"summary\",\"shard\":0,\"retVal\":1,\"numTests\":2,").size() == 1);
+    }
+
+    TEST("JUnitShouldHaveATestCasePerTest")
+    {
+        SilentLogger silentLogger;
+        {
+            JUnitReporter reporter(ReportFileName, &silentLogger);
+            ASSERT_THAT(reporter.IsOpen());
+            CHECK_THAT(TestManager::ExecuteSuite("SampleSuite", &reporter) > 0);
+            //each test is written as soon as it is completed
+            CHECK_THAT(Contains(ReadReport(ReportFileName), "name=\"fooTest2\""));
+        }
+        std::string text = ReadReport(ReportFileName);
+
+        CHECK_THAT(text.compare(0, 38, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>") == 0);
+        CHECK_THAT(ReportLines(text, "<testsuite name=\"SampleSuite\">").size() == 1);
+        CHECK_THAT(ReportLines(text, "</testsuite>").size() == 1);
+        CHECK_THAT(Contains(text, "<testcase classname=\"SampleSuite\" name=\"fooTest1\" time=\""));
+        CHECK_THAT(Contains(text, "<failure message=\"2 of 3 assertions failed\" type=\"failure\">"));
+        CHECK_THAT(ReportLines(text, ": !MappedValue(&quot;CheckFails&quot;)").size() == 2);
+        CHECK_THAT(ReportLines(text, "name=\"fooTest2\"")[0].find("/>") != std::string::npos);
+        CHECK_THAT(text.size() > 14 && text.compare(text.size() - 14, 14, "</testsuites>\n") == 0);
+    }
+
+    TEST("OptionsShouldReportTimedOutTestsOfProcessRuns")
+    {
+        if(!platform::HasFork)
+        {
+            CHECK_THAT(TestManager::Processes() == 0);
+            return;
+        }
+        TestManager::args()["--jsonl"] = ReportFileName;
+        TestManager::args()["--processes"] = "2";
+        TestManager::args()["--timeout"] = "0.2";
+        SilentLogger silentLogger;
+        CHECK_THAT(TestManager::ExecuteSuite("HangingSuite", &silentLogger) == 1);
+
+        std::string text = ReadReport(ReportFileName);
+        CHECK_THAT(ReportLines(text, "{\"type\":\"test\"").size() == 3);
+        std::vector<std::string> hang = ReportLines(text, "\"test\":\"hang\"");
+        ASSERT_THAT(hang.size() == 1);
+        CHECK_THAT(Contains(hang[0], "\"retVal\":1,"));
+        CHECK_THAT(Contains(hang[0], "\"reason\":\"Timeout, HangingSuite.hang after "));
+        CHECK_THAT(ReportLines(text, "{\"type\":\"summary\"").size() == 1);
+    }
+
+    TEST("ShardsShouldWriteTheirOwnFiles")
+    {
+        TestManager::args()["--shard-count"] = "1";
+        CHECK_THAT(TestManager::ReportFile("out/results.xml") == "out/results.xml");
+        TestManager::args()["--shard-count"] = "3";
+        TestManager::args()["--shard-index"] = "2";
+        CHECK_THAT(TestManager::ReportFile("out/results.xml") == "out/results.2.xml");
+        CHECK_THAT(TestManager::ReportFile("out.d/results") == "out.d/results.2");
+    }
+};
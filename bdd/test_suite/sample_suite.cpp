@@ -49,5 +49,6 @@ TEST_SUITE(SampleSuite)
     TEST("fooTest2")
     {
         CHECK_THAT(1);
+        CHECK.True(!MappedValue("ObjectFails"), "object fails");
     }
 };
@@ -0,0 +1,45 @@
+/**
+ * Common parts of the tests of the framework
+ */
+#pragma once
+
+#include "stdio.h"
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "../include/suite.h"
+
+using namespace esintiler;
+
+/**
+ * Logger of the nested runs which only keeps the messages. Tests compare the exact log,
+ * summary of the nested runs is not a part of it.
+ */
+class MessageLogger : public Logger
+{
+public:
+    void log(const char* ipMsg)
+    {
+        m_log.push_back(ipMsg);
+    }
+
+    void summary(const RunSummary &iSummary)
+    {
+    }
+
+    bool Has(const char *ipMsg) const
+    {
+        return std::find(m_log.begin(), m_log.end(), ipMsg) != m_log.end();
+    }
+
+    bool Contains(const std::string &iPrefix) const
+    {
+        for(unsigned int i = 0; i < m_log.size(); i++)
+            if(m_log[i].compare(0, iPrefix.size(), iPrefix) == 0)
+                return true;
+        return false;
+    }
+
+    std::vector<std::string> m_log;
+};
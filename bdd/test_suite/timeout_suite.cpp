@@ -0,0 +1,139 @@
+// timeout_suite.cpp : Tests for the time budgets of the tests
+//
+
+#include "test_suite.h"
+
+void BusyWait(double iSeconds);
+
+/**
+ * Fixture suites, they are only executed by the TimeoutTester. Hanging tests finish by
+ * themselves after a while so a broken watchdog can not block the tester forever.
+ */
+TEST_SUITE(HangingSuite)
+{
+    TEST("before") { CHECK_THAT(true); }
+    TEST("hang") { BusyWait(3); CHECK_THAT(true); }
+    TEST("after") { CHECK_THAT(true); }
+};
+
+TEST_SUITE(HangingForkSuite)
+{
+    int TestsPerFork()
+    {
+        return 1;
+    }
+    TEST("before") { CHECK_THAT(true); }
+    TEST_TIMEOUT("hang", 0.2) { BusyWait(3); CHECK_THAT(true); }
+    TEST("after") { CHECK_THAT(true); }
+};
+
+TEST_SUITE(BudgetSuite)
+{
+    double Timeout()
+    {
+        return 5;
+    }
+    TEST("suiteBudget") { CHECK_THAT(true); }
+    TEST_TIMEOUT("ownBudget", 2) { CHECK_THAT(true); }
+    TEST_TIMEOUT("noBudget", 0) { CHECK_THAT(true); }
+};
+
+TEST_SUITE(DefaultBudgetSuite)
+{
+    TEST("defaultBudget") { CHECK_THAT(true); }
+};
+
+/**
+ * Executes the HangingSuite in a child process, without any worker process
+ */
+int HangingMain(int iInput, int iOutput, void *ipData)
+{
+#ifndef _WIN32
+    //Diagnostic of the watchdog is expected, keep the output of the tester clean
+    freopen("/dev/null", "w", stderr);
+#endif
+    MessageLogger hangingLogger;
+    TestManager::ExecuteSuite("HangingSuite", &hangingLogger);
+    return 0;
+}
+
+TEST_SUITE(TimeoutTester)
+{
+    TEST("BudgetShouldBeTakenFromTestSuiteOrDefault")
+    {
+        TestSuiteBase *pSuite = TestManager::FindRunner("BudgetSuite")->CreateSuite();
+        ASSERT_THAT(pSuite != 0 && pSuite->Tests.size() == 3);
+        TestManager::args()["--timeout"] = "7.5";
+        CHECK_THAT(TestManager::Timeout(pSuite, pSuite->Tests[0]) == 5);
+        CHECK_THAT(TestManager::Timeout(pSuite, pSuite->Tests[1]) == 2);
+        CHECK_THAT(TestManager::Timeout(pSuite, pSuite->Tests[2]) == 0);
+
+        TestSuiteBase *pDefault = TestManager::FindRunner("DefaultBudgetSuite")->CreateSuite();
+        CHECK_THAT(TestManager::Timeout(pDefault, pDefault->Tests[0]) == 7.5);
+        TestManager::args().erase("--timeout");
+        CHECK_THAT(TestManager::Timeout(pDefault, pDefault->Tests[0]) == 0);
+        delete pDefault;
+        delete pSuite;
+    }
+
+    TEST("TimedOutTestShouldBeKilledInWorkerProcess")
+    {
+        if(!platform::HasFork)
+        {
+            CHECK_THAT(TestManager::Processes() == 0);
+            return;
+        }
+        TestManager::args()["--processes"] = "2";
+        TestManager::args()["--timeout"] = "0.2";
+        MessageLogger processLogger;
+        double start = platform::Now();
+        int retVal = TestManager::ExecuteSuite("HangingSuite", &processLogger);
+        double seconds = platform::Now() - start;
+        TestManager::args().erase("--timeout");
+        TestManager::args().erase("--processes");
+
+        CHECK_THAT(retVal == 1);
+        CHECK_THAT(seconds < 2);
+        CHECK_THAT(processLogger.Contains("...Failed (Timeout, HangingSuite.hang after "));
+        ASSERT_THAT(processLogger.m_log.size() >= 2);
+        CHECK_THAT(processLogger.m_log[processLogger.m_log.size() - 2] == "after");
+        CHECK_THAT(processLogger.m_log.back() == "...OK");
+    }
+
+    TEST("TimedOutTestShouldBeKilledInFork")
+    {
+        if(!platform::HasFork)
+        {
+            CHECK_THAT(!platform::HasFork);
+            return;
+        }
+        MessageLogger forkLogger;
+        double start = platform::Now();
+        int retVal = TestManager::ExecuteSuite("HangingForkSuite", &forkLogger);
+        double seconds = platform::Now() - start;
+
+        CHECK_THAT(retVal == 1);
+        CHECK_THAT(seconds < 2);
+        CHECK_THAT(forkLogger.Contains("...Failed (Timeout, HangingForkSuite.hang after "));
+        CHECK_THAT(forkLogger.m_log.back() == "...OK");
+    }
+
+    TEST("TimedOutTestShouldAbortInProcessRun")
+    {
+        if(!platform::HasFork)
+        {
+            CHECK_THAT(!platform::HasFork);
+            return;
+        }
+        TestManager::args()["--timeout"] = "0.2";
+        platform::ChildProcess child;
+        double start = platform::Now();
+        bool started = child.Start(&HangingMain, 0);
+        TestManager::args().erase("--timeout");
+        ASSERT_THAT(started);
+
+        char status[64] = "";
+        CHECK_THAT(!child.Wait(status, sizeof(status)));
+        CHECK_THAT(platform::Now() - start < 2);
+    }
+};
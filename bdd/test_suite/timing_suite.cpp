@@ -0,0 +1,161 @@
+// timing_suite.cpp : Tests for the timings and the summary of the runs
+//
+
+#include "stdio.h"
+#include <map>
+#include <vector>
+
+#include "../include/suite.h"
+
+using namespace esintiler;
+
+/**
+ * Logger which keeps the timings and the summary instead of the messages
+ */
+class TimingLogger : public Logger
+{
+public:
+    void log(const char* ipMsg)
+    {
+    }
+
+    void timing(const char *ipSuite, const char *ipTest, TimingPhase iPhase, double iSeconds)
+    {
+        char pBuf[1024];
+        sprintf_s(pBuf, "%s.%s:%i", ipSuite, ipTest, (int)iPhase);
+        m_timings.push_back(pBuf);
+        m_negative |= iSeconds < 0;
+    }
+
+    void summary(const RunSummary &iSummary)
+    {
+        m_summary = iSummary;
+        m_numSummaries ++;
+    }
+
+    TimingLogger() : m_negative(false), m_numSummaries(0) {}
+
+    std::vector<std::string>    m_timings;
+    bool                        m_negative;
+    RunSummary                  m_summary;
+    int                         m_numSummaries;
+};
+
+/**
+ * Waits for the given time without sleeping so the durations are not affected by the
+ * resolution of the scheduler
+ */
+void BusyWait(double iSeconds)
+{
+    double end = platform::Now() + iSeconds;
+    while(platform::Now() < end)
+        ;
+}
+
+/**
+ * Fixture suites, they are only executed by the TimingTester
+ */
+TEST_SUITE(TimingSuite)
+{
+    TEST("fast") { CHECK_THAT(true); }
+    TEST("slow") { BusyWait(0.02); CHECK_THAT(true); }
+};
+
+TEST_SUITE(TimingSlowSuite)
+{
+    int Construct()
+    {
+        BusyWait(0.05);
+        return 0;
+    }
+    TEST("t1") { CHECK_THAT(true); }
+};
+
+std::vector<std::string> TimingSuites()
+{
+    std::vector<std::string> suites;
+    suites.push_back("TimingSuite");
+    suites.push_back("TimingSlowSuite");
+    return suites;
+}
+
+TEST_SUITE(TimingTester)
+{
+    TEST("EachPhaseShouldBeTimedInOrder")
+    {
+        const char* pRef[] = {
+            "TimingSuite.:0",
+            "TimingSuite.fast:1",
+            "TimingSuite.fast:2",
+            "TimingSuite.fast:3",
+            "TimingSuite.fast:5",
+            "TimingSuite.slow:1",
+            "TimingSuite.slow:2",
+            "TimingSuite.slow:3",
+            "TimingSuite.slow:5",
+            "TimingSuite.:4",
+            "TimingSuite.:6",
+        };
+        TimingLogger timingLogger;
+        CHECK_THAT(TestManager::ExecuteSuite("TimingSuite", &timingLogger) == 0);
+        CHECK_THAT(timingLogger.m_timings == std::vector<std::string>(pRef, pRef + 11));
+        CHECK_THAT(!timingLogger.m_negative);
+        CHECK_THAT(timingLogger.m_numSummaries == 1);
+    }
+
+    TEST("ParallelAndProcessRunsShouldPassSameTimings")
+    {
+        TimingLogger serialLogger;
+        TestManager::ExecuteSuites(TimingSuites(), &serialLogger);
+
+        TestManager::args()["--jobs"] = "2";
+        TimingLogger parallelLogger;
+        TestManager::ExecuteSuites(TimingSuites(), &parallelLogger);
+        TestManager::args().erase("--jobs");
+
+        TestManager::args()["--processes"] = "2";
+        TimingLogger processLogger;
+        TestManager::ExecuteSuites(TimingSuites(), &processLogger);
+        TestManager::args().erase("--processes");
+
+        CHECK_THAT(serialLogger.m_timings.size() == 18);
+        CHECK_THAT(parallelLogger.m_timings == serialLogger.m_timings);
+        CHECK_THAT(processLogger.m_timings == serialLogger.m_timings);
+    }
+
+    TEST("SummaryShouldListTheSlowestTestsAndSuites")
+    {
+        TestManager::args()["--slowest"] = "1";
+        TimingLogger timingLogger;
+        double start = platform::Now();
+        int retVal = TestManager::ExecuteSuites(TimingSuites(), &timingLogger);
+        double seconds = platform::Now() - start;
+        TestManager::args().erase("--slowest");
+
+        const RunSummary &summary = timingLogger.m_summary;
+        CHECK_THAT(retVal == 0);
+        CHECK_THAT(summary.retVal == 0);
+        CHECK_THAT(summary.numTests == 3);
+        CHECK_THAT(summary.numAssertions == 3);
+        CHECK_THAT(summary.numFailedAssertions == 0);
+        CHECK_THAT(summary.seconds >= 0.07 && summary.seconds <= seconds);
+        ASSERT_THAT(summary.slowestTests.size() == 1);
+        CHECK_THAT(summary.slowestTests[0].suite == "TimingSuite");
+        CHECK_THAT(summary.slowestTests[0].test == "slow");
+        CHECK_THAT(summary.slowestTests[0].seconds >= 0.02);
+        ASSERT_THAT(summary.slowestSuites.size() == 1);
+        CHECK_THAT(summary.slowestSuites[0].suite == "TimingSlowSuite");
+    }
+
+    TEST("SummaryShouldNotListAnyTestIfDisabled")
+    {
+        TestManager::args()["--slowest"] = "0";
+        TimingLogger timingLogger;
+        TestManager::ExecuteSuites(TimingSuites(), &timingLogger);
+        TestManager::args().erase("--slowest");
+
+        CHECK_THAT(timingLogger.m_summary.numTests == 3);
+        CHECK_THAT(timingLogger.m_summary.slowestTests.empty());
+        CHECK_THAT(timingLogger.m_summary.slowestSuites.empty());
+    }
+};
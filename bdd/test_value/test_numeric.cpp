@@ -2,6 +2,9 @@
 #include "../include/suite.h"
 #include "../include/numeric.h"
 
+#include <math.h>
+#include <limits>
+
 using namespace esintiler;
 
 /** 
@@ -104,4 +107,352 @@ TEST_SUITE(Numeric)
         /* true  && false || true */CHECK_THAT(value(iv).should.be_less_than(8).and.equal_to(9).or.be_less_than(9));
     }
 
+    TEST("LongChainsShouldBeEvaluatedFromLeftToRight")
+    {
+        /* ((true || false) && !true) || false */
+        CHECK_THAT(!value(iv).should.equal_to(5).or.equal_to(6).and.not.equal_to(5).or.be_less_than(2));
+        /* ((false && true) || !false) && true */
+        CHECK_THAT(value(iv).should.equal_to(6).and.equal_to(5).or.not.equal_to(4).and.be_greater_than(1));
+        /* (!false && !false) && !true */
+        CHECK_THAT(!value(dv).should.not.equal_to(1.0).and.not.equal_to(2.0).and.not.equal_to(9.5));
+    }
+
+};
+
+/**
+ * Logger which keeps the message of the last failure
+ */
+class MessageLogger : public Logger
+{
+public:
+    void failure(const FailureRecord &iFailure)
+    {
+        message = iFailure.message ? iFailure.message : "";
+    }
+
+    std::string message;
+};
+
+/** 
+ * Tests for the bulk checks of arrays. Sizes are not multiples of the vector width so
+ * the remaining elements are also checked.
+ */
+TEST_SUITE(NumericBulk)
+{
+    int Construct()
+    {
+        for(int i = 0; i < Size; i++)
+        {
+            fv[i] = i * 0.5f;
+            dv[i] = i * 0.25;
+            iv[i] = i;
+        }
+        return 0;
+    }
+
+    enum { Size = 1003 };
+
+    float   fv[Size];
+    double  dv[Size];
+    int     iv[Size];
+
+    TEST("AllShouldBeTheDefaultQuantifier")
+    {
+        CHECK_THAT(value(fv, Size).should.be_less_than(Size * 0.5f));
+        CHECK_THAT(value(dv, Size).should.all.be_less_than(Size * 0.25));
+        CHECK_THAT(value(iv, Size).should.all.be_greater_than(-1));
+
+        CHECK_THAT(!value(fv, Size).should.be_less_than(500.0f));
+        CHECK_THAT(!value(dv, Size).should.all.be_greater_than(0.0));
+        CHECK_THAT(!value(iv, Size).should.all.equal_to(0));
+    }
+
+    TEST("AnyAndNoneShouldCountTheMatches")
+    {
+        CHECK_THAT(value(fv, Size).should.any.equal_to(501.0f));
+        CHECK_THAT(value(dv, Size).should.any.be_greater_than(250.0));
+        CHECK_THAT(value(iv, Size).should.none.be_less_than(0));
+
+        CHECK_THAT(!value(fv, Size).should.any.equal_to(501.25f));
+        CHECK_THAT(!value(dv, Size).should.none.equal_to(250.5));
+        CHECK_THAT(!value(iv, Size).should.any.be_greater_than(Size));
+    }
+
+    TEST("NotShouldNegateTheQuantifiedCheck")
+    {
+        CHECK_THAT(value(fv, Size).should.not.be_less_than(500.0f));
+        CHECK_THAT(!value(fv, Size).should.not.be_less_than(Size * 0.5f));
+        CHECK_THAT(value(dv, Size).should.be_less_than(Size * 0.25).and.not.equal_to(0.5));
+    }
+
+    TEST("NaNShouldNeverCompare")
+    {
+        float nan = sqrtf(-1.0f);
+        std::vector<float> values(fv, fv + Size);
+        values[Size - 1] = nan;
+        CHECK_THAT(!value(values).should.all.be_less_than(Size * 0.5f));
+        CHECK_THAT(!value(values).should.any.equal_to(nan));
+        CHECK_THAT(value(values).should.none.be_greater_than(Size * 0.5f));
+    }
+
+    TEST("EmptyArraysShouldHaveNoMatches")
+    {
+        std::vector<double> empty;
+        CHECK_THAT(value(empty).should.all.equal_to(1.0));
+        CHECK_THAT(value(empty).should.none.equal_to(1.0));
+        CHECK_THAT(!value(empty).should.any.equal_to(1.0));
+    }
+
+    TEST("FailureShouldReportTheMismatchingElements")
+    {
+        MessageLogger logger;
+        int numAssertions = 0;
+        int numFailedAssertions = 0;
+        Evaluator(&logger, false, numAssertions, numFailedAssertions, __FILE__, __LINE__)
+            .True(value(iv, Size).should.all.be_less_than(990));
+        CHECK_THAT(numFailedAssertions == 1);
+        CHECK_THAT(logger.message == "13 of 1003 elements are not less than 990, first at"
+            " 990 (990) 991 (991) 992 (992) 993 (993) 994 (994) 995 (995) 996 (996) 997 (997)");
+
+        Evaluator(&logger, false, numAssertions, numFailedAssertions, __FILE__, __LINE__)
+            .True(value(fv, Size).should.none.equal_to(1.0f).and.any.be_less_than(0.0f));
+        CHECK_THAT(logger.message == "1 of 1003 elements are equal to 1, first at 2 (1); "
+            "none of 1003 elements is less than 0");
+
+        Evaluator(&logger, false, numAssertions, numFailedAssertions, __FILE__, __LINE__)
+            .True(value(dv, Size).should.not.be_greater_than(-1.0), "custom");
+        CHECK_THAT(logger.message == "custom");
+        CHECK_THAT(numAssertions == 3);
+    }
+};
+
+/** 
+ * Tests for the comparisons within a tolerance, of single values and of arrays. Expected
+ * values of the arrays are the values moved by a few ulps.
+ */
+TEST_SUITE(NumericTolerance)
+{
+    int Construct()
+    {
+        nan = std::numeric_limits<double>::quiet_NaN();
+        for(int i = 0; i < Size; i++)
+        {
+            fv[i] = (i - 500) * 0.37f;
+            dv[i] = (i - 500) * 0.37;
+            fe[i] = nextafterf(nextafterf(fv[i], 1e30f), 1e30f);
+            de[i] = nextafter(nextafter(dv[i], -1e300), -1e300);
+        }
+        return 0;
+    }
+
+    enum { Size = 1003 };
+
+    double  nan;
+    float   fv[Size];
+    float   fe[Size];
+    double  dv[Size];
+    double  de[Size];
+
+    TEST("CloseValuesShouldBeWithinTolerance")
+    {
+        double d = 1.0;
+        CHECK_THAT(value(d).should.be_close_to(1.05, 0.1));
+        CHECK_THAT(value(d).should.be_close_to(1.05, 0, 0.05));
+        CHECK_THAT(!value(d).should.be_close_to(1.2, 0.1, 0.05));
+        CHECK_THAT(value(d).should.not.be_close_to(2.0, 0.5));
+
+        int i = 10;
+        CHECK_THAT(value(i).should.be_close_to(12, 2));
+        CHECK_THAT(!value(i).should.be_close_to(13, 2));
+    }
+
+    TEST("NaNShouldOnlyBeCloseToNaN")
+    {
+        double inf = 1e300 * 1e300;
+        CHECK_THAT(value(nan).should.be_close_to(nan, 0));
+        CHECK_THAT(value(nan).should.be_within_ulps(nan, 0));
+        CHECK_THAT(!value(nan).should.be_close_to(1.0, 1e300));
+        CHECK_THAT(!value(nan).should.be_within_ulps(1.0, 1000));
+        CHECK_THAT(value(inf).should.be_close_to(inf, 0));
+        CHECK_THAT(!value(inf).should.be_close_to(1e300, 1e300));
+        double one = 1.0;
+        double negative = -inf;
+        float f = 1.0f;
+        CHECK_THAT(!value(one).should.be_close_to(inf, 0, 1e-9));
+        CHECK_THAT(!value(negative).should.be_close_to(inf, 0, 1e-9));
+        CHECK_THAT(!value(f).should.be_close_to((float)inf, 1e30, 1));
+    }
+
+    TEST("UlpsShouldCountTheValuesBetween")
+    {
+        float f = 1.0f;
+        float next = nextafterf(f, 2.0f);
+        float zero = 0.0f;
+        CHECK_THAT(value(f).should.be_within_ulps(next, 1));
+        CHECK_THAT(!value(f).should.be_within_ulps(nextafterf(next, 2.0f), 1));
+        CHECK_THAT(value(zero).should.be_within_ulps(-0.0f, 0));
+        CHECK_THAT(value(zero).should.be_within_ulps(-nextafterf(0.0f, 1.0f), 1));
+
+        double d = -1.0;
+        CHECK_THAT(value(d).should.be_within_ulps(nextafter(d, 0.0), 1));
+        CHECK_THAT(!value(d).should.be_within_ulps(nextafter(nextafter(d, 0.0), 0.0), 1));
+    }
+
+    TEST("ArraysShouldBeComparedElementwise")
+    {
+        CHECK_THAT(value(fv, Size).should.be_within_ulps(fe, 2));
+        CHECK_THAT(!value(fv, Size).should.be_within_ulps(fe, 1));
+        CHECK_THAT(value(dv, Size).should.be_within_ulps(de, 2));
+        CHECK_THAT(value(dv, Size).should.none.be_within_ulps(de, 1));
+        CHECK_THAT(value(fv, Size).should.be_close_to(fe, 1e-30, 1e-6));
+        CHECK_THAT(value(dv, Size).should.be_close_to(de, 1e-12));
+        CHECK_THAT(!value(dv, Size).should.be_close_to(de, 0, 1e-17));
+        CHECK_THAT(value(dv, Size).should.be_close_to(std::vector<double>(de, de + Size), 1e-12));
+    }
+
+    TEST("NaNElementsShouldOnlyMatchNaN")
+    {
+        std::vector<double> values(dv, dv + Size);
+        std::vector<double> expected(dv, dv + Size);
+        values[7] = expected[7] = nan;
+        CHECK_THAT(value(values).should.be_close_to(expected, 0));
+        CHECK_THAT(value(values).should.be_within_ulps(expected, 0));
+        expected[7] = 0;
+        values[Size - 1] = nan;
+        CHECK_THAT(!value(values).should.be_close_to(expected, 1e300));
+        CHECK_THAT(!value(values).should.be_within_ulps(expected, 1000));
+        CHECK_THAT(value(values).should.any.be_within_ulps(expected, 0));
+    }
+
+    TEST("InfiniteElementsShouldOnlyMatchTheSameInfinity")
+    {
+        double inf = 1e300 * 1e300;
+        std::vector<double> values(dv, dv + Size);
+        std::vector<double> expected(Size, inf);
+        std::vector<float> floatValues(fv, fv + Size);
+        std::vector<float> floatExpected(Size, (float)inf);
+        CHECK_THAT(value(values).should.none.be_close_to(expected, 0, 1e-9));
+        CHECK_THAT(value(floatValues).should.none.be_close_to(floatExpected, 0, 1e-6));
+        values[11] = inf;
+        floatValues[11] = (float)inf;
+        values[12] = -inf;
+        CHECK_THAT(value(values).should.any.be_close_to(expected, 0, 1e-9));
+        CHECK_THAT(!value(values).should.be_close_to(expected, 0, 1e-9));
+        CHECK_THAT(value(floatValues).should.any.be_close_to(floatExpected, 0, 1e-6));
+        expected[12] = -inf;
+        CHECK_THAT(!value(values).should.none.be_close_to(expected, 0, 1e-9));
+        CHECK_THAT(!value(values).should.be_close_to(std::vector<double>(Size, 1.0), 1e300, 1));
+    }
+
+    TEST("FailureShouldReportTheErrors")
+    {
+        MessageLogger logger;
+        int numAssertions = 0;
+        int numFailedAssertions = 0;
+        std::vector<double> values(dv, dv + 10);
+        std::vector<double> expected(dv, dv + 10);
+        values[3] += 0.5;
+        values[5] += 4;
+        values[8] = nan;
+        Evaluator(&logger, false, numAssertions, numFailedAssertions, __FILE__, __LINE__)
+            .True(value(values).should.be_close_to(expected, 0.25));
+        CHECK_THAT(numFailedAssertions == 1);
+        CHECK_THAT(logger.message == "3 of 10 elements are not close to the expected values (abs 0.25, rel 0)"
+            ", max error 4 (allowed 0.25) at 5 (-179.15, expected -183.15)"
+            ", errors <=0.5: 7, <=1: 0, <=2: 1, <=10: 0, >10: 1, NaN: 1"
+            ", first at 3 (-183.39, expected -183.89) 5 (-179.15, expected -183.15) 8 (nan, expected -182.04)");
+
+        Evaluator(&logger, false, numAssertions, numFailedAssertions, __FILE__, __LINE__)
+            .True(value(values).should.not.be_within_ulps(std::vector<double>(9), 1));
+        CHECK_THAT(logger.message == "9 expected values for 10 elements");
+    }
+};
+
+/** 
+ * Tests for the membership checks. The set of even numbers below 2 000 000 is built once
+ * and used by all tests.
+ */
+TEST_SUITE(NumericMembership)
+{
+    int Construct()
+    {
+        std::vector<int> evens;
+        for(int i = 1999998; i >= 0; i -= 2)
+            evens.push_back(i);
+        pEvens = new NumericSet<int>(evens);
+        return 0;
+    }
+
+    void Destruct()
+    {
+        delete pEvens;
+    }
+
+    TEST("ValuesShouldBeFoundInCandidates")
+    {
+        int candidates[] = { 7, 3, 11, 3 };
+        int i = 11;
+        CHECK_THAT(value(i).should.be_in(candidates, 4));
+        CHECK_THAT(value(i).should.not.be_in(candidates, 2));
+        CHECK_THAT(!value(i).should.be_in(candidates, 0));
+
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        double zero = -0.0;
+        double values[] = { nan, 0.5, 0.0 };
+        NumericSet<double> set(values, 3);
+        CHECK_THAT(set.Size() == 2);
+        CHECK_THAT(value(zero).should.be_in(set));
+        CHECK_THAT(value(nan).should.not.be_in(set).and.not.be_in(values, 3));
+    }
+
+    TEST("LargeSetsShouldBeSearched")
+    {
+        CHECK_THAT(pEvens->Size() == 1000000);
+        int i = 0;
+        CHECK_THAT(value(i).should.be_in(*pEvens));
+        i = 1999998;
+        CHECK_THAT(value(i).should.be_in(*pEvens));
+        i = 1000001;
+        CHECK_THAT(value(i).should.not.be_in(*pEvens));
+        i = -2;
+        CHECK_THAT(value(i).should.not.be_in(*pEvens));
+        i = 2000000;
+        CHECK_THAT(value(i).should.not.be_in(*pEvens));
+    }
+
+    TEST("ArraysShouldBeFoundInSets")
+    {
+        std::vector<int> values;
+        for(int i = 0; i < 1003; i++)
+            values.push_back(i * 1993 % 2000000 * 2 % 2000000);
+        CHECK_THAT(value(values).should.be_in(*pEvens));
+        values[1001] = 5;
+        CHECK_THAT(value(values).should.not.be_in(*pEvens));
+        CHECK_THAT(value(values).should.any.be_in(*pEvens).and.not.be_in(*pEvens));
+        values.assign(1003, -1);
+        CHECK_THAT(value(values).should.none.be_in(*pEvens));
+
+        int candidates[] = { 3, -1, 8 };
+        CHECK_THAT(value(values).should.be_in(candidates, 3));
+        CHECK_THAT(value(&values[0], 0).should.be_in(candidates, 0));
+        CHECK_THAT(!value(values).should.any.be_in(candidates, 0));
+    }
+
+    TEST("FailureShouldReportMissingElements")
+    {
+        MessageLogger logger;
+        int numAssertions = 0;
+        int numFailedAssertions = 0;
+        int values[] = { 2, 3, 4, 5, 6 };
+        Evaluator(&logger, false, numAssertions, numFailedAssertions, __FILE__, __LINE__)
+            .True(value(values, 5).should.be_in(*pEvens));
+        CHECK_THAT(numFailedAssertions == 1);
+        CHECK_THAT(logger.message == "2 of 5 elements are not in the set of 1000000 values, first at 1 (3) 3 (5)");
+
+        Evaluator(&logger, false, numAssertions, numFailedAssertions, __FILE__, __LINE__)
+            .True(value(values, 5).should.none.be_in(values, 2));
+        CHECK_THAT(logger.message == "2 of 5 elements are in the set of 2 values, first at 0 (2) 1 (3)");
+    }
+
+    NumericSet<int> *pEvens;
 };